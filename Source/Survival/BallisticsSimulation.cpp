@@ -0,0 +1,304 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "BallisticsSimulation.h"
+#include "SurvivalProjectile.h"
+#include "SurvivalGameStateBase.h"
+#include "Utility/UtilityFunctionsLibrary.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Ballistics Step"), STAT_BallisticsStep, STATGROUP_Survival);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rounds In Flight"), STAT_RoundsInFlight, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Round Hits"), STAT_RoundHits, STATGROUP_Survival);
+
+
+//////////////////////////////////////////////////////////////////////////
+// FBallisticsBuffer
+
+int32 FBallisticsBuffer::Add()
+{
+	// Grow a whole SIMD lane group at a time
+	if (Num % 4 == 0)
+	{
+		ForEachFloatArray([](TArray<float> &Array) { Array.AddZeroed(4); });
+	}
+
+	Owners.AddDefaulted();
+	Damage.AddZeroed();
+	ImpulseScale.AddZeroed();
+	IDs.AddZeroed();
+
+	return Num++;
+}
+
+void FBallisticsBuffer::RemoveAtSwap(int32 Index)
+{
+	check(Index >= 0 && Index < Num);
+
+	const int32 Last = Num - 1;
+	ForEachFloatArray([Index, Last](TArray<float> &Array)
+	{
+		Array[Index] = Array[Last];
+		Array[Last] = 0.0f;
+	});
+
+	Owners.RemoveAtSwap(Index, 1, false);
+	Damage.RemoveAtSwap(Index, 1, false);
+	ImpulseScale.RemoveAtSwap(Index, 1, false);
+	IDs.RemoveAtSwap(Index, 1, false);
+
+	Num--;
+	if (Num % 4 == 0)
+	{
+		const int32 PaddedNum = Num;
+		ForEachFloatArray([PaddedNum](TArray<float> &Array) { Array.RemoveAt(PaddedNum, 4, false); });
+	}
+}
+
+void FBallisticsBuffer::Empty()
+{
+	ForEachFloatArray([](TArray<float> &Array) { Array.Empty(); });
+	Owners.Empty();
+	Damage.Empty();
+	ImpulseScale.Empty();
+	IDs.Empty();
+	Num = 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// UBallisticsSimulation
+
+UBallisticsSimulation::UBallisticsSimulation()
+{
+	FixedTimeStep = 1.0f / 60.0f;
+	MaxStepsPerFrame = 4;
+	MaxRounds = 2048;
+	TraceChannel = ECollisionChannel::ECC_Visibility;
+
+	Accumulator = 0.0f;
+	NextID = 1;
+}
+
+UBallisticsSimulation *UBallisticsSimulation::Get(const UObject *WorldContextObject)
+{
+	UWorld *World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	ASurvivalGameStateBase *GameState = World ? World->GetGameState<ASurvivalGameStateBase>() : nullptr;
+	return GameState ? GameState->BallisticsSimulation : nullptr;
+}
+
+uint32 UBallisticsSimulation::Fire(TSubclassOf<ASurvivalProjectile> ProjectileClass, const FVector &Location, const FVector &Direction, AActor *Owner, float Age, bool bSweepFlownPath)
+{
+	UWorld *World = GetWorld();
+	if (ProjectileClass == nullptr || World == nullptr)
+	{
+		return 0;
+	}
+
+	if (Rounds.Num >= MaxRounds)
+	{
+		UE_LOG(SurvivalDebugLog, Warning, TEXT("UBallisticsSimulation::Fire - Round limit (%d) reached, dropping round"), MaxRounds);
+		return 0;
+	}
+
+	// The class defaults describe the round
+	const ASurvivalProjectile *Template = ProjectileClass->GetDefaultObject<ASurvivalProjectile>();
+	const UProjectileMovementComponent *Movement = Template->GetProjectileMovement();
+
+	const float GravityScale = Movement ? Movement->ProjectileGravityScale : 1.0f;
+	const float GravityZ = World->GetGravityZ() * GravityScale;
+
+	// Catch up on the time the round has already been flying
+	const FVector LaunchVelocity = Direction.GetSafeNormal() * (Movement ? Movement->InitialSpeed : 0.0f);
+	const FVector Velocity = LaunchVelocity + FVector(0.0f, 0.0f, GravityZ * Age);
+	const FVector Position = Location + LaunchVelocity * Age + FVector(0.0f, 0.0f, 0.5f * GravityZ * Age * Age);
+
+	const int32 Index = Rounds.Add();
+	// The first sweep starts at the muzzle, so catching up can't skip through walls
+	const FVector SweepStart = bSweepFlownPath ? Location : Position;
+	Rounds.PrevX[Index] = SweepStart.X;
+	Rounds.PrevY[Index] = SweepStart.Y;
+	Rounds.PrevZ[Index] = SweepStart.Z;
+	Rounds.PosX[Index] = Position.X;
+	Rounds.PosY[Index] = Position.Y;
+	Rounds.PosZ[Index] = Position.Z;
+	Rounds.VelX[Index] = Velocity.X;
+	Rounds.VelY[Index] = Velocity.Y;
+	Rounds.VelZ[Index] = Velocity.Z;
+	Rounds.GravityZ[Index] = GravityZ;
+	Rounds.Lifetime[Index] = Template->PooledLifetime - Age;
+	Rounds.Owners[Index] = Owner;
+	Rounds.Damage[Index] = Template->BallisticDamage;
+	Rounds.ImpulseScale[Index] = Template->BallisticImpulseScale;
+
+	const uint32 ID = NextID++;
+	if (NextID == 0)
+	{
+		NextID = 1;
+	}
+	Rounds.IDs[Index] = ID;
+
+	SET_DWORD_STAT(STAT_RoundsInFlight, Rounds.Num);
+	return ID;
+}
+
+FVector UBallisticsSimulation::GetRoundPathLocation(TSubclassOf<ASurvivalProjectile> ProjectileClass, const FVector &Location, const FVector &Direction, float FlightTime) const
+{
+	UWorld *World = GetWorld();
+	if (ProjectileClass == nullptr || World == nullptr)
+	{
+		return Location;
+	}
+
+	// Same path Fire catches up along
+	const UProjectileMovementComponent *Movement = ProjectileClass->GetDefaultObject<ASurvivalProjectile>()->GetProjectileMovement();
+	const float GravityZ = World->GetGravityZ() * (Movement ? Movement->ProjectileGravityScale : 1.0f);
+	const FVector LaunchVelocity = Direction.GetSafeNormal() * (Movement ? Movement->InitialSpeed : 0.0f);
+	return Location + LaunchVelocity * FlightTime + FVector(0.0f, 0.0f, 0.5f * GravityZ * FlightTime * FlightTime);
+}
+
+void UBallisticsSimulation::Tick(float DeltaTime)
+{
+	if (Rounds.Num == 0)
+	{
+		Accumulator = 0.0f;
+		return;
+	}
+
+	Accumulator += DeltaTime;
+
+	int32 Steps = 0;
+	while (Accumulator >= FixedTimeStep && Steps < MaxStepsPerFrame)
+	{
+		Step(FixedTimeStep);
+		Accumulator -= FixedTimeStep;
+		Steps++;
+	}
+
+	// Drop what we could not catch up on rather than spiral
+	if (Steps == MaxStepsPerFrame)
+	{
+		Accumulator = FMath::Min(Accumulator, FixedTimeStep);
+	}
+}
+
+void UBallisticsSimulation::Integrate(float StepTime)
+{
+	const VectorRegister Dt = VectorSetFloat1(StepTime);
+	const int32 PaddedNum = Rounds.GetPaddedNum();
+
+	float *RESTRICT PosX = Rounds.PosX.GetData();
+	float *RESTRICT PosY = Rounds.PosY.GetData();
+	float *RESTRICT PosZ = Rounds.PosZ.GetData();
+	float *RESTRICT VelZ = Rounds.VelZ.GetData();
+	float *RESTRICT Lifetime = Rounds.Lifetime.GetData();
+	const float *RESTRICT VelX = Rounds.VelX.GetData();
+	const float *RESTRICT VelY = Rounds.VelY.GetData();
+	const float *RESTRICT GravityZ = Rounds.GravityZ.GetData();
+
+	// Semi-implicit Euler, 4 rounds per iteration
+	for (int32 i = 0; i < PaddedNum; i += 4)
+	{
+		const VectorRegister Vz = VectorMultiplyAdd(VectorLoad(&GravityZ[i]), Dt, VectorLoad(&VelZ[i]));
+		VectorStore(Vz, &VelZ[i]);
+
+		VectorStore(VectorMultiplyAdd(VectorLoad(&VelX[i]), Dt, VectorLoad(&PosX[i])), &PosX[i]);
+		VectorStore(VectorMultiplyAdd(VectorLoad(&VelY[i]), Dt, VectorLoad(&PosY[i])), &PosY[i]);
+		VectorStore(VectorMultiplyAdd(Vz, Dt, VectorLoad(&PosZ[i])), &PosZ[i]);
+
+		VectorStore(VectorSubtract(VectorLoad(&Lifetime[i]), Dt), &Lifetime[i]);
+	}
+}
+
+void UBallisticsSimulation::Step(float StepTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BallisticsStep);
+
+	if (Rounds.Num == 0)
+	{
+		return;
+	}
+
+	Integrate(StepTime);
+
+	// One sweep per round, all in one batch
+	SweepRequests.Reset(Rounds.Num);
+	for (int32 i = 0; i < Rounds.Num; i++)
+	{
+		SweepRequests.Add(FSceneQueryRequest(
+			FVector(Rounds.PrevX[i], Rounds.PrevY[i], Rounds.PrevZ[i]),
+			FVector(Rounds.PosX[i], Rounds.PosY[i], Rounds.PosZ[i]),
+			TraceChannel, Rounds.Owners[i].Get()));
+	}
+
+	USceneQueryBatcher *Batcher = USceneQueryBatcher::Get(this);
+	if (Batcher != nullptr)
+	{
+		Batcher->ExecuteBatch(SweepRequests, SweepHits);
+	}
+	else
+	{
+		SweepHits.Reset();
+		SweepHits.AddDefaulted(SweepRequests.Num());
+	}
+
+	if (UUtilityFunctionsLibrary::ShouldDrawDebugTraces())
+	{
+		for (int32 i = 0; i < SweepRequests.Num(); i++)
+		{
+			DrawDebugLine(GetWorld(), SweepRequests[i].Start, SweepRequests[i].End, FColor::Yellow, false, 0.5f);
+		}
+	}
+
+	// Walk backwards so RemoveAtSwap only moves rounds we have already visited.
+	// Hits are resolved in a fixed order, which keeps runs reproducible.
+	for (int32 i = Rounds.Num - 1; i >= 0; i--)
+	{
+		if (SweepHits[i].bBlockingHit)
+		{
+			ResolveHit(i, SweepHits[i]);
+			Rounds.RemoveAtSwap(i);
+		}
+		else if (Rounds.Lifetime[i] <= 0.0f)
+		{
+			Rounds.RemoveAtSwap(i);
+		}
+	}
+
+	// Next sweep starts where this one ended
+	const int32 PaddedNum = Rounds.GetPaddedNum();
+	FMemory::Memcpy(Rounds.PrevX.GetData(), Rounds.PosX.GetData(), PaddedNum * sizeof(float));
+	FMemory::Memcpy(Rounds.PrevY.GetData(), Rounds.PosY.GetData(), PaddedNum * sizeof(float));
+	FMemory::Memcpy(Rounds.PrevZ.GetData(), Rounds.PosZ.GetData(), PaddedNum * sizeof(float));
+
+	SET_DWORD_STAT(STAT_RoundsInFlight, Rounds.Num);
+}
+
+void UBallisticsSimulation::ResolveHit(int32 Index, const FHitResult &Hit)
+{
+	INC_DWORD_STAT(STAT_RoundHits);
+
+	// Clients only simulate for visuals
+	UWorld *World = GetWorld();
+	if (World == nullptr || World->GetAuthGameMode() == nullptr)
+	{
+		return;
+	}
+
+	const FVector Velocity(Rounds.VelX[Index], Rounds.VelY[Index], Rounds.VelZ[Index]);
+
+	AActor *HitActor = Hit.GetActor();
+	AActor *Owner = Rounds.Owners[Index].Get();
+	if (HitActor != nullptr && Rounds.Damage[Index] > 0.0f)
+	{
+		APawn *OwnerPawn = Cast<APawn>(Owner);
+		UGameplayStatics::ApplyPointDamage(HitActor, Rounds.Damage[Index], Velocity.GetSafeNormal(), Hit,
+			OwnerPawn ? OwnerPawn->GetController() : nullptr, Owner, UDamageType::StaticClass());
+	}
+
+	UPrimitiveComponent *HitComponent = Hit.GetComponent();
+	if (HitComponent != nullptr && HitComponent->IsSimulatingPhysics())
+	{
+		HitComponent->AddImpulseAtLocation(Velocity * Rounds.ImpulseScale[Index], Hit.ImpactPoint);
+	}
+}
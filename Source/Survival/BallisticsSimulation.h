@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "Utility/SceneQueryBatcher.h"
+#include "BallisticsSimulation.generated.h"
+
+class ASurvivalProjectile;
+
+/**
+* Structure-of-arrays storage for rounds in flight.
+* The hot float arrays are padded to a multiple of 4 so they can be integrated
+* 4 rounds at a time without a scalar tail. Padding lanes are kept zeroed.
+*/
+struct FBallisticsBuffer
+{
+	// Hot data, integrated with SIMD
+	TArray<float> PosX, PosY, PosZ;
+	TArray<float> VelX, VelY, VelZ;
+	TArray<float> GravityZ;
+	TArray<float> Lifetime;
+
+	// Position the last sweep ended at. The next sweep runs from here to Pos.
+	TArray<float> PrevX, PrevY, PrevZ;
+
+	// Cold data, only touched on hits
+	TArray<TWeakObjectPtr<AActor>> Owners;
+	TArray<float> Damage;
+	TArray<float> ImpulseScale;
+	TArray<uint32> IDs;
+
+	int32 Num;
+
+	FBallisticsBuffer()
+		: Num(0)
+	{}
+
+	FORCEINLINE int32 GetPaddedNum() const
+	{
+		return Align(Num, 4);
+	}
+
+	int32 Add();
+	void RemoveAtSwap(int32 Index);
+	void Empty();
+
+private:
+	// All padded float arrays, for bulk operations
+	template<typename FuncType>
+	void ForEachFloatArray(FuncType Func)
+	{
+		Func(PosX); Func(PosY); Func(PosZ);
+		Func(VelX); Func(VelY); Func(VelZ);
+		Func(GravityZ); Func(Lifetime);
+		Func(PrevX); Func(PrevY); Func(PrevZ);
+	}
+};
+
+/**
+* Simulates opted-in projectiles (@see ASurvivalProjectile::bUseBatchedBallistics) without
+* an actor per round. All rounds are integrated together in fixed steps, and their
+* collision sweeps are run as one batch per step through the scene query batcher.
+* Only confirmed hits turn into damage and impulses.
+*
+* Fixed steps and a stable round order make a run reproducible for the same inputs.
+* Owned by the game state. Damage is only applied where there is an authoritative game mode.
+*/
+UCLASS(Config = Game)
+class SURVIVAL_API UBallisticsSimulation : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	UBallisticsSimulation();
+
+	// Utility to get the simulation of the world WorldContextObject lives in. May return nullptr.
+	static UBallisticsSimulation *Get(const UObject *WorldContextObject);
+
+	// Seconds per simulation step
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Ballistics)
+	float FixedTimeStep;
+
+	// Cap on steps per frame, so a long hitch doesn't stall the game thread
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Ballistics)
+	int32 MaxStepsPerFrame;
+
+	// Rounds in flight allowed at once. New rounds are dropped beyond this.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Ballistics)
+	int32 MaxRounds;
+
+	// Channel the rounds sweep against
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Ballistics)
+	TEnumAsByte<ECollisionChannel> TraceChannel;
+
+	// Launch a round using the speed, gravity, lifetime and damage of ProjectileClass.
+	// Age is how long ago the round was fired; it starts out that far along its path.
+	// The path already flown is swept on the first step unless bSweepFlownPath is false,
+	// for callers that have tested it themselves. Returns the round ID, or 0 if it was dropped.
+	uint32 Fire(TSubclassOf<ASurvivalProjectile> ProjectileClass, const FVector &Location, const FVector &Direction, AActor *Owner, float Age = 0.0f, bool bSweepFlownPath = true);
+
+	// Where a round fired from Location along Direction would be FlightTime seconds later, if it hit nothing
+	FVector GetRoundPathLocation(TSubclassOf<ASurvivalProjectile> ProjectileClass, const FVector &Location, const FVector &Direction, float FlightTime) const;
+
+	// Advance all rounds by exactly one step. Used by Tick, and by tests driving the simulation directly.
+	void Step(float StepTime);
+
+	FORCEINLINE int32 GetNumRounds() const
+	{
+		return Rounds.Num;
+	}
+
+	// Round data for tracers and other visuals
+	FORCEINLINE FVector GetRoundLocation(int32 Index) const
+	{
+		return FVector(Rounds.PosX[Index], Rounds.PosY[Index], Rounds.PosZ[Index]);
+	}
+
+	FORCEINLINE FVector GetRoundVelocity(int32 Index) const
+	{
+		return FVector(Rounds.VelX[Index], Rounds.VelY[Index], Rounds.VelZ[Index]);
+	}
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	void Integrate(float StepTime);
+	void ResolveHit(int32 Index, const FHitResult &Hit);
+
+	FBallisticsBuffer Rounds;
+
+	// Time not yet simulated
+	float Accumulator;
+
+	uint32 NextID;
+
+	// Reused between steps
+	TArray<FSceneQueryRequest> SweepRequests;
+	TArray<FHitResult> SweepHits;
+};
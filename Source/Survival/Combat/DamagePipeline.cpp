@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "DamagePipeline.h"
+#include "SurvivalGameMode.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Resolve"), STAT_DamageResolve, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events"), STAT_DamageEvents, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Victims"), STAT_DamageVictims, STATGROUP_Survival);
+
+
+UDamagePipeline::UDamagePipeline()
+{
+	ArmorHalfPoint = 100.0f;
+}
+
+UDamagePipeline *UDamagePipeline::Get(const UObject *WorldContextObject)
+{
+	UWorld *World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	ASurvivalGameMode *GameMode = World ? World->GetAuthGameMode<ASurvivalGameMode>() : nullptr;
+	return GameMode ? GameMode->DamagePipeline : nullptr;
+}
+
+void UDamagePipeline::QueueDamage(ASurvivalCharacter *Victim, float Amount, TSubclassOf<UDamageType> DamageType, AController *Instigator, AActor *Causer)
+{
+	if (Victim == nullptr || Amount <= 0.0f)
+	{
+		return;
+	}
+
+	FPendingDamage Damage;
+	Damage.Victim = Victim;
+	Damage.Instigator = Instigator;
+	Damage.Causer = Causer;
+	Damage.DamageType = DamageType;
+	Damage.Amount = Amount;
+	Pending.Add(Damage);
+
+	INC_DWORD_STAT(STAT_DamageEvents);
+}
+
+void UDamagePipeline::Tick(float DeltaTime)
+{
+	if (Pending.Num() > 0)
+	{
+		ResolvePending();
+	}
+}
+
+void UDamagePipeline::ResolvePending()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DamageResolve);
+
+	// Take the queue; deaths may queue more damage for the next frame
+	TArray<FPendingDamage> Events = MoveTemp(Pending);
+	Pending.Reset();
+
+	// Group by victim, keeping the order victims were first hit in
+	struct FVictimDamage
+	{
+		ASurvivalCharacter *Victim;
+		float Total;
+		int32 FirstReport;
+	};
+	TArray<FVictimDamage> Victims;
+	TMap<ASurvivalCharacter*, int32> VictimIndices;
+	Reports.Reset();
+
+	for (const FPendingDamage &Event : Events)
+	{
+		ASurvivalCharacter *Victim = Event.Victim.Get();
+		if (Victim == nullptr || Victim->IsPendingKill() || Victim->IsDead())
+		{
+			continue;
+		}
+
+		int32 *VictimIndex = VictimIndices.Find(Victim);
+		if (VictimIndex == nullptr)
+		{
+			FVictimDamage NewVictim;
+			NewVictim.Victim = Victim;
+			NewVictim.Total = 0.0f;
+			NewVictim.FirstReport = INDEX_NONE;
+			VictimIndex = &VictimIndices.Add(Victim, Victims.Add(NewVictim));
+		}
+		FVictimDamage &VictimDamage = Victims[*VictimIndex];
+
+		// Resistance to the damage type, then armor
+		float Amount = Event.Amount * (1.0f - Victim->GetDamageResistance(Event.DamageType));
+		const float Armor = FMath::Max(Victim->Armor, 0.0f);
+		Amount *= 1.0f - Armor / (Armor + ArmorHalfPoint);
+		VictimDamage.Total += Amount;
+
+		// One report per victim and instigator
+		AController *Instigator = Event.Instigator.Get();
+		int32 ReportIndex = INDEX_NONE;
+		if (VictimDamage.FirstReport != INDEX_NONE)
+		{
+			for (int32 i = VictimDamage.FirstReport; i < Reports.Num(); i++)
+			{
+				if (Reports[i].Victim == Victim && Reports[i].Instigator == Instigator)
+				{
+					ReportIndex = i;
+					break;
+				}
+			}
+		}
+		if (ReportIndex == INDEX_NONE)
+		{
+			FDamageHitReport Report;
+			Report.Victim = Victim;
+			Report.Instigator = Instigator;
+			ReportIndex = Reports.Add(Report);
+			if (VictimDamage.FirstReport == INDEX_NONE)
+			{
+				VictimDamage.FirstReport = ReportIndex;
+			}
+		}
+		Reports[ReportIndex].Damage += Amount;
+		Reports[ReportIndex].Hits++;
+	}
+
+	// One health change and death check per victim
+	for (const FVictimDamage &VictimDamage : Victims)
+	{
+		const bool bKilled = VictimDamage.Victim->ApplyResolvedDamage(VictimDamage.Total);
+		if (!bKilled)
+		{
+			continue;
+		}
+		for (int32 i = VictimDamage.FirstReport; i < Reports.Num(); i++)
+		{
+			if (Reports[i].Victim == VictimDamage.Victim)
+			{
+				Reports[i].bKilled = true;
+			}
+		}
+	}
+	INC_DWORD_STAT_BY(STAT_DamageVictims, Victims.Num());
+
+	// Hit feedback to the shooters
+	for (const FDamageHitReport &Report : Reports)
+	{
+		ASurvivalCharacter *InstigatorCharacter = Report.Instigator ? Cast<ASurvivalCharacter>(Report.Instigator->GetPawn()) : nullptr;
+		if (InstigatorCharacter != nullptr)
+		{
+			InstigatorCharacter->ClientReceiveHitReport(Report);
+		}
+	}
+
+	OnReportsResolved.Broadcast(Reports);
+}
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "DamagePipeline.generated.h"
+
+class ASurvivalCharacter;
+
+/**
+* Fraction of a damage type a character ignores
+*/
+USTRUCT(BlueprintType)
+struct FDamageResistance
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Damage)
+	TSubclassOf<UDamageType> DamageType;
+
+	// 0 takes full damage, 1 takes none
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Damage, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Resistance;
+
+	FDamageResistance()
+	{
+		DamageType = nullptr;
+		Resistance = 0.0f;
+	}
+};
+
+/**
+* Everything that happened to one victim from one instigator in one frame
+*/
+USTRUCT(BlueprintType)
+struct FDamageHitReport
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	AActor *Victim;
+
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	AController *Instigator;
+
+	// Damage after armor and resistances
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	float Damage;
+
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	int32 Hits;
+
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	bool bKilled;
+
+	FDamageHitReport()
+	{
+		Victim = nullptr;
+		Instigator = nullptr;
+		Damage = 0.0f;
+		Hits = 0;
+		bKilled = false;
+	}
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FDamageReportsResolved, const TArray<FDamageHitReport>&);
+
+/**
+* Server side damage resolution.
+*
+* Damage to characters is queued as it happens during the frame and resolved once per frame
+* per victim: armor and resistances are applied per hit, the sum is taken off health in one
+* go (one replicated health change), and death is checked once. Instigators get one
+* aggregated hit report per victim instead of one per pellet/projectile.
+*/
+UCLASS(Config = Game)
+class SURVIVAL_API UDamagePipeline : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	UDamagePipeline();
+
+	// Utility to get the pipeline of the world WorldContextObject lives in. Only exists on the server, may return nullptr.
+	static UDamagePipeline *Get(const UObject *WorldContextObject);
+
+	// Armor value that halves damage. Mitigation is Armor / (Armor + ArmorHalfPoint).
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Damage)
+	float ArmorHalfPoint;
+
+	// Queue damage to Victim for this frame's resolve
+	void QueueDamage(ASurvivalCharacter *Victim, float Amount, TSubclassOf<UDamageType> DamageType, AController *Instigator, AActor *Causer);
+
+	// Resolve everything queued. Called every frame by Tick.
+	void ResolvePending();
+
+	// Broadcast with every frame's reports, for telemetry
+	FDamageReportsResolved OnReportsResolved;
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	struct FPendingDamage
+	{
+		TWeakObjectPtr<ASurvivalCharacter> Victim;
+		TWeakObjectPtr<AController> Instigator;
+		TWeakObjectPtr<AActor> Causer;
+		TSubclassOf<UDamageType> DamageType;
+		float Amount;
+	};
+
+	TArray<FPendingDamage> Pending;
+
+	// Reused between frames
+	TArray<FDamageHitReport> Reports;
+};
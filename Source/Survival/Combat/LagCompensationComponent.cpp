@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "LagCompensationComponent.h"
+#include "LagCompensationManager.h"
+
+
+// Sets default values for this component's properties
+ULagCompensationComponent::ULagCompensationComponent()
+{
+	// Recorded by the lag compensation manager
+	PrimaryComponentTick.bCanEverTick = false;
+
+	Head = 0;
+	NumSnapshots = 0;
+	ManagerIndex = INDEX_NONE;
+}
+
+// Called when the game starts
+void ULagCompensationComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// History is only needed where hits are decided
+	ULagCompensationManager *Manager = ULagCompensationManager::Get(this);
+	if (Manager != nullptr)
+	{
+		Manager->RegisterComponent(this);
+	}
+}
+
+// Called when the game ends or the owner is destroyed
+void ULagCompensationComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ULagCompensationManager *Manager = ULagCompensationManager::Get(this);
+	if (Manager != nullptr)
+	{
+		Manager->UnregisterComponent(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ULagCompensationComponent::InitHistory(int32 Capacity)
+{
+	History.Empty(Capacity);
+	History.AddDefaulted(FMath::Max(Capacity, 2));
+	Head = 0;
+	NumSnapshots = 0;
+}
+
+void ULagCompensationComponent::RecordSnapshot(float Time)
+{
+	ACharacter *Character = Cast<ACharacter>(GetOwner());
+	if (Character == nullptr || History.Num() == 0)
+	{
+		return;
+	}
+
+	// Overwrite the oldest snapshot once full
+	int32 Slot;
+	if (NumSnapshots < History.Num())
+	{
+		Slot = (Head + NumSnapshots) % History.Num();
+		NumSnapshots++;
+	}
+	else
+	{
+		Slot = Head;
+		Head = (Head + 1) % History.Num();
+	}
+
+	const UCapsuleComponent *Capsule = Character->GetCapsuleComponent();
+	FHitboxSnapshot &Snapshot = History[Slot];
+	Snapshot.Time = Time;
+	Snapshot.Location = Capsule->GetComponentLocation();
+	Snapshot.Rotation = Capsule->GetComponentQuat();
+	Capsule->GetScaledCapsuleSize(Snapshot.Radius, Snapshot.HalfHeight);
+}
+
+bool ULagCompensationComponent::GetSnapshotAtTime(float Time, FHitboxSnapshot &OutSnapshot) const
+{
+	if (NumSnapshots == 0)
+	{
+		return false;
+	}
+
+	if (Time <= GetSnapshot(0).Time)
+	{
+		OutSnapshot = GetSnapshot(0);
+		return true;
+	}
+	if (Time >= GetSnapshot(NumSnapshots - 1).Time)
+	{
+		OutSnapshot = GetSnapshot(NumSnapshots - 1);
+		return true;
+	}
+
+	// Snapshots are in time order; find the first one after Time
+	int32 Low = 1;
+	int32 High = NumSnapshots - 1;
+	while (Low < High)
+	{
+		const int32 Mid = (Low + High) / 2;
+		if (GetSnapshot(Mid).Time <= Time)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+
+	const FHitboxSnapshot &Before = GetSnapshot(Low - 1);
+	const FHitboxSnapshot &After = GetSnapshot(Low);
+	const float Alpha = (After.Time > Before.Time) ? (Time - Before.Time) / (After.Time - Before.Time) : 1.0f;
+
+	OutSnapshot.Time = Time;
+	OutSnapshot.Location = FMath::Lerp(Before.Location, After.Location, Alpha);
+	OutSnapshot.Rotation = FQuat::Slerp(Before.Rotation, After.Rotation, Alpha);
+	OutSnapshot.Radius = FMath::Lerp(Before.Radius, After.Radius, Alpha);
+	OutSnapshot.HalfHeight = FMath::Lerp(Before.HalfHeight, After.HalfHeight, Alpha);
+	return true;
+}
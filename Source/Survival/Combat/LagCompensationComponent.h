@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "LagCompensationComponent.generated.h"
+
+/**
+* Collision capsule of a character at one point in time
+*/
+struct FHitboxSnapshot
+{
+	float Time;
+	FVector Location;
+	FQuat Rotation;
+	float Radius;
+	float HalfHeight;
+
+	FHitboxSnapshot()
+		: Time(0.0f)
+		, Location(FVector::ZeroVector)
+		, Rotation(FQuat::Identity)
+		, Radius(0.0f)
+		, HalfHeight(0.0f)
+	{}
+};
+
+/**
+* Server side history of the owning character's collision capsule, so hits can be
+* tested against where the shooter saw the character rather than where it is now.
+*
+* History is a fixed-size ring buffer, sized once when registering with the lag
+* compensation manager, which records all characters together once per frame.
+* The component itself never ticks.
+*/
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SURVIVAL_API ULagCompensationComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+	friend class ULagCompensationManager;
+
+public:
+	// Sets default values for this component's properties
+	ULagCompensationComponent();
+
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	// Called when the game ends or the owner is destroyed
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Get the capsule at Time, interpolated between the two closest snapshots.
+	// Times outside the history are clamped to the oldest/newest snapshot. Returns false if there is no history.
+	bool GetSnapshotAtTime(float Time, FHitboxSnapshot &OutSnapshot) const;
+
+	FORCEINLINE int32 GetNumSnapshots() const
+	{
+		return NumSnapshots;
+	}
+
+	FORCEINLINE SIZE_T GetHistoryMemory() const
+	{
+		return History.GetAllocatedSize();
+	}
+
+protected:
+	// Size the ring buffer. Clears the history.
+	void InitHistory(int32 Capacity);
+
+	// Record the owner's current capsule
+	void RecordSnapshot(float Time);
+
+	// Snapshot at logical index (0 is the oldest)
+	FORCEINLINE const FHitboxSnapshot &GetSnapshot(int32 Index) const
+	{
+		return History[(Head + Index) % History.Num()];
+	}
+
+	TArray<FHitboxSnapshot> History;
+
+	// Index of the oldest snapshot
+	int32 Head;
+	int32 NumSnapshots;
+
+	// Index in the manager's component array
+	int32 ManagerIndex;
+};
@@ -0,0 +1,175 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "LagCompensationManager.h"
+#include "LagCompensationComponent.h"
+#include "SurvivalGameMode.h"
+
+DECLARE_CYCLE_STAT(TEXT("Lag Comp Record"), STAT_LagCompRecord, STATGROUP_Survival);
+DECLARE_CYCLE_STAT(TEXT("Lag Comp Rewind"), STAT_LagCompRewind, STATGROUP_Survival);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Lag Comp Characters"), STAT_LagCompCharacters, STATGROUP_Survival);
+DECLARE_MEMORY_STAT(TEXT("Lag Comp History"), STAT_LagCompMemory, STATGROUP_Survival);
+
+
+ULagCompensationManager::ULagCompensationManager()
+{
+	HistorySize = 64;
+	MaxRewindTime = 0.4f;
+	HitboxInflation = 5.0f;
+	MaxShotOriginError = 200.0f;
+	MaxShotTimeError = 0.01f;
+}
+
+ULagCompensationManager *ULagCompensationManager::Get(const UObject *WorldContextObject)
+{
+	UWorld *World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	ASurvivalGameMode *GameMode = World ? World->GetAuthGameMode<ASurvivalGameMode>() : nullptr;
+	return GameMode ? GameMode->LagCompensationManager : nullptr;
+}
+
+void ULagCompensationManager::RegisterComponent(ULagCompensationComponent *Component)
+{
+	if (Component == nullptr || Component->ManagerIndex != INDEX_NONE)
+	{
+		return;
+	}
+
+	Component->InitHistory(HistorySize);
+	Component->ManagerIndex = Components.Add(Component);
+
+	INC_MEMORY_STAT_BY(STAT_LagCompMemory, Component->GetHistoryMemory());
+	SET_DWORD_STAT(STAT_LagCompCharacters, Components.Num());
+}
+
+void ULagCompensationManager::UnregisterComponent(ULagCompensationComponent *Component)
+{
+	if (Component == nullptr || !Components.IsValidIndex(Component->ManagerIndex) || Components[Component->ManagerIndex] != Component)
+	{
+		return;
+	}
+
+	const int32 Index = Component->ManagerIndex;
+	Components.RemoveAtSwap(Index, 1, false);
+	if (Components.IsValidIndex(Index))
+	{
+		Components[Index]->ManagerIndex = Index;
+	}
+	Component->ManagerIndex = INDEX_NONE;
+
+	DEC_MEMORY_STAT_BY(STAT_LagCompMemory, Component->GetHistoryMemory());
+	SET_DWORD_STAT(STAT_LagCompCharacters, Components.Num());
+}
+
+float ULagCompensationManager::ClampRewindTime(float ViewTime) const
+{
+	UWorld *World = GetWorld();
+	if (World == nullptr)
+	{
+		return ViewTime;
+	}
+
+	const float Now = World->GetTimeSeconds();
+	return FMath::Clamp(ViewTime, Now - MaxRewindTime, Now);
+}
+
+bool ULagCompensationManager::RewindLineTest(float ViewTime, const FVector &Start, const FVector &End, const AActor *Shooter, FLagCompensatedHit &OutHit) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_LagCompRewind);
+
+	UWorld *World = GetWorld();
+	if (World == nullptr)
+	{
+		return false;
+	}
+
+	const float RewindTime = ClampRewindTime(ViewTime);
+
+	bool bHit = false;
+	OutHit = FLagCompensatedHit();
+	OutHit.Distance = MAX_flt;
+
+	for (const ULagCompensationComponent *Component : Components)
+	{
+		if (Component == nullptr || Component->GetOwner() == Shooter)
+		{
+			continue;
+		}
+
+		FHitboxSnapshot Snapshot;
+		if (!Component->GetSnapshotAtTime(RewindTime, Snapshot))
+		{
+			continue;
+		}
+
+		// A capsule is a segment with a radius
+		const FVector Up = Snapshot.Rotation.GetAxisZ();
+		const float SegmentHalfLength = FMath::Max(Snapshot.HalfHeight - Snapshot.Radius, 0.0f);
+		const FVector CapsuleA = Snapshot.Location - Up * SegmentHalfLength;
+		const FVector CapsuleB = Snapshot.Location + Up * SegmentHalfLength;
+
+		FVector OnShot, OnCapsule;
+		FMath::SegmentDistToSegmentSafe(Start, End, CapsuleA, CapsuleB, OnShot, OnCapsule);
+
+		const float Radius = Snapshot.Radius + HitboxInflation;
+		if (FVector::DistSquared(OnShot, OnCapsule) > FMath::Square(Radius))
+		{
+			continue;
+		}
+
+		const float Distance = FVector::Dist(Start, OnShot);
+		if (Distance < OutHit.Distance)
+		{
+			OutHit.Actor = Component->GetOwner();
+			OutHit.Location = OnShot;
+			OutHit.Distance = Distance;
+			bHit = true;
+		}
+	}
+
+	if (!bHit)
+	{
+		return false;
+	}
+
+	// Static geometry doesn't move, so it can be tested in the present
+	FCollisionQueryParams Params(NAME_None, false, Shooter);
+	if (World->LineTraceTestByObjectType(Start, OutHit.Location, FCollisionObjectQueryParams(ECC_WorldStatic), Params))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void ULagCompensationManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LagCompRecord);
+
+	UWorld *World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	const float Now = World->GetTimeSeconds();
+	for (int32 i = Components.Num() - 1; i >= 0; i--)
+	{
+		ULagCompensationComponent *Component = Components[i];
+		if (Component == nullptr || Component->IsPendingKill())
+		{
+			if (Component != nullptr)
+			{
+				DEC_MEMORY_STAT_BY(STAT_LagCompMemory, Component->GetHistoryMemory());
+			}
+			// Unregister didn't get a chance to run
+			Components.RemoveAtSwap(i, 1, false);
+			if (Components.IsValidIndex(i) && Components[i] != nullptr)
+			{
+				Components[i]->ManagerIndex = i;
+			}
+			continue;
+		}
+
+		Component->RecordSnapshot(Now);
+	}
+}
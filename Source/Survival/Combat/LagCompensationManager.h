@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "LagCompensationManager.generated.h"
+
+class ULagCompensationComponent;
+
+/**
+* Result of a rewound hit test
+*/
+struct FLagCompensatedHit
+{
+	AActor *Actor;
+
+	// Closest point on the shot to the rewound capsule, and its distance from the shot start
+	FVector Location;
+	float Distance;
+
+	FLagCompensatedHit()
+		: Actor(nullptr)
+		, Location(FVector::ZeroVector)
+		, Distance(0.0f)
+	{}
+};
+
+/**
+* Server side lag compensation.
+*
+* Records the collision capsule of every registered character once per frame, and tests
+* shots against the capsules as they were at the shooter's view time. Memory per character
+* is fixed (HistorySize snapshots), and recording is one pass over a contiguous array.
+* Use "stat Survival" to see record/rewind cost and history memory.
+*/
+UCLASS(Config = Game)
+class SURVIVAL_API ULagCompensationManager : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	ULagCompensationManager();
+
+	// Utility to get the manager of the world WorldContextObject lives in. Only exists on the server, may return nullptr.
+	static ULagCompensationManager *Get(const UObject *WorldContextObject);
+
+	// Snapshots kept per character. Covers HistorySize frames of server time.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Lag Compensation")
+	int32 HistorySize;
+
+	// Furthest back in time a shot may be rewound
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Lag Compensation")
+	float MaxRewindTime;
+
+	// Extra radius added to rewound capsules, to absorb interpolation error
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Lag Compensation")
+	float HitboxInflation;
+
+	// How far a client reported shot origin may be from the shooter before the shot is rejected
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Lag Compensation")
+	float MaxShotOriginError;
+
+	// How much sooner than the weapon's refire delay a client shot may follow the previous one
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Lag Compensation")
+	float MaxShotTimeError;
+
+	void RegisterComponent(ULagCompensationComponent *Component);
+	void UnregisterComponent(ULagCompensationComponent *Component);
+
+	// Clamp a client reported view time to what we can rewind to
+	float ClampRewindTime(float ViewTime) const;
+
+	// Test the segment Start-End against every character (except Shooter) as it was at ViewTime.
+	// Blocking world geometry in front of the character is checked against the present scene.
+	bool RewindLineTest(float ViewTime, const FVector &Start, const FVector &End, const AActor *Shooter, FLagCompensatedHit &OutHit) const;
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	UPROPERTY()
+	TArray<ULagCompensationComponent*> Components;
+};
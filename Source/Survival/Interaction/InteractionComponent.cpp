@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "InteractionComponent.h"
+#include "Inventory/ItemWorldActor.h"
+#include "DrawDebugHelpers.h"
+
+
+// Sets default values for this component's properties
+UInteractionComponent::UInteractionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+
+	TraceSource = nullptr;
+	InteractionDistance = 160.0f;
+	TraceStartOffset = 20.0f;
+	TraceFrameInterval = 1;
+	TraceChannel = ECollisionChannel::ECC_WorldStatic;
+	bDrawDebugTraces = false;
+
+	FramesUntilTrace = 0;
+	bHasFocusResult = false;
+
+	TraceDelegate.BindUObject(this, &UInteractionComponent::OnTraceCompleted);
+}
+
+
+// Called when the game starts
+void UInteractionComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Pawns are usually not possessed yet; the owner calls this again when they are
+	UpdateTickForController();
+}
+
+void UInteractionComponent::UpdateTickForController()
+{
+	// Only the locally controlled pawn needs to know what it's looking at
+	APawn *PawnOwner = Cast<APawn>(GetOwner());
+	const bool bLocal = PawnOwner == nullptr || PawnOwner->IsLocallyControlled();
+	SetComponentTickEnabled(bLocal);
+
+	if (!bLocal)
+	{
+		bHasFocusResult = false;
+		SetFocusedActor(nullptr);
+	}
+}
+
+
+// Called every frame
+void UInteractionComponent::TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction )
+{
+	Super::TickComponent( DeltaTime, TickType, ThisTickFunction );
+
+	USceneQueryBatcher *SceneQueries = USceneQueryBatcher::Get(this);
+	if (SceneQueries == nullptr || TraceSource == nullptr)
+	{
+		return;
+	}
+
+	if (--FramesUntilTrace > 0)
+	{
+		return;
+	}
+	FramesUntilTrace = FMath::Max(TraceFrameInterval, 1);
+
+	const FVector Forward = TraceSource->GetForwardVector();
+	const FVector Start = TraceSource->GetComponentLocation() + (Forward * TraceStartOffset);
+	const FVector End = Start + (Forward * InteractionDistance);
+
+	// Result is delivered through OnTraceCompleted when the batch is flushed
+	SceneQueries->RequestLineTrace(FSceneQueryRequest(Start, End, TraceChannel, GetOwner()), TraceDelegate);
+}
+
+void UInteractionComponent::OnTraceCompleted(FSceneQueryHandle Handle, const FHitResult &Hit)
+{
+	AActor *HitActor = Hit.bBlockingHit ? Hit.GetActor() : nullptr;
+
+	if (bDrawDebugTraces)
+	{
+		DrawDebugLine(GetWorld(), Hit.TraceStart, Hit.TraceEnd, HitActor ? FColor::Green : FColor::Red, false, -1.0f, 0, 0.5f);
+	}
+
+	bHasFocusResult = true;
+	SetFocusedActor(IsInteractable(HitActor) ? HitActor : nullptr);
+}
+
+void UInteractionComponent::SetFocusedActor(AActor *NewFocus)
+{
+	AActor *OldFocus = FocusedActor.Get();
+	if (OldFocus == NewFocus)
+	{
+		return;
+	}
+
+	AItemWorldActor *OldItem = Cast<AItemWorldActor>(OldFocus);
+	if (OldItem != nullptr)
+	{
+		OldItem->SetHighlighted(false);
+	}
+
+	AItemWorldActor *NewItem = Cast<AItemWorldActor>(NewFocus);
+	if (NewItem != nullptr)
+	{
+		NewItem->SetHighlighted(true);
+	}
+
+	FocusedActor = NewFocus;
+	OnFocusChangedDelegate.Broadcast(NewFocus);
+}
+
+bool UInteractionComponent::IsInteractable(const AActor *Actor) const
+{
+	if (Actor == nullptr || Actor->IsPendingKill())
+	{
+		return false;
+	}
+
+	// #1 World item pickups with a valid item reference
+	const AItemWorldActor *ItemPickupActor = Cast<AItemWorldActor>(Actor);
+	if (ItemPickupActor != nullptr && ItemPickupActor->ItemTypeReference != nullptr)
+	{
+		return true;
+	}
+
+	// #2 Doors etc. go here
+
+	return false;
+}
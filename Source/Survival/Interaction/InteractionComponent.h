@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "Utility/SceneQueryBatcher.h"
+#include "InteractionComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FInteractionFocusChangedSignature, AActor*, NewFocus);
+
+/**
+* Continuously works out what the owning (locally controlled) pawn is looking at.
+*
+* Every TraceFrameInterval frames a line trace is queued on the scene query batcher from the
+* trace source (usually the first person camera). The result arrives at the end of the frame and becomes the
+* focused actor, which is highlighted and broadcast so the UI can prompt the player.
+* Actions such as picking up items act on the cached focus, so pressing the key
+* doesn't have to wait for, or pay for, a trace of its own.
+*/
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SURVIVAL_API UInteractionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UInteractionComponent();
+
+	// Component the traces start from, and in which forward direction they go
+	UPROPERTY(BlueprintReadWrite, Category = Interaction)
+	class USceneComponent *TraceSource;
+
+	// Distance in front of the trace source at which interactions are possible
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Interaction)
+	float InteractionDistance;
+
+	// Offset from the trace source the trace starts at, to better match the arm reach
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Interaction)
+	float TraceStartOffset;
+
+	// Issue a trace every N frames. 1 traces every frame.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Interaction)
+	int32 TraceFrameInterval;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Interaction)
+	TEnumAsByte<ECollisionChannel> TraceChannel;
+
+	// Draw the interaction traces. All batched traces can be drawn with Survival.DrawDebugTraces 1
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Debug)
+	bool bDrawDebugTraces;
+
+	// Called when the focused actor changes. NewFocus is null when looking at nothing interactable.
+	UPROPERTY(BlueprintAssignable, Category = "Interaction Events")
+	FInteractionFocusChangedSignature OnFocusChangedDelegate;
+
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	// Called every frame
+	virtual void TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction ) override;
+
+	// Trace only while the owning pawn is locally controlled. Call when the pawn is possessed or unpossessed.
+	void UpdateTickForController();
+
+	// Get the actor from the last completed trace, if any
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	AActor *GetFocusedActor() const
+	{
+		return FocusedActor.Get();
+	}
+
+	// Utility to check if a trace has completed yet. Before that, the focus is unknown rather than empty.
+	FORCEINLINE bool HasFocusResult() const
+	{
+		return bHasFocusResult;
+	}
+
+protected:
+	// Called by the scene query batcher when our trace completes
+	void OnTraceCompleted(FSceneQueryHandle Handle, const FHitResult &Hit);
+
+	// Changes focus, moving the highlight and notifying listeners
+	void SetFocusedActor(AActor *NewFocus);
+
+	// Utility to check if an actor is something we can interact with
+	bool IsInteractable(const AActor *Actor) const;
+
+	FSceneQueryDelegate TraceDelegate;
+
+	TWeakObjectPtr<AActor> FocusedActor;
+
+	int32 FramesUntilTrace;
+
+	bool bHasFocusResult;
+};
@@ -2,21 +2,189 @@
 
 #include "Survival.h"
 #include "BaseItem.h"
+#include "ItemNames.h"
+#include "BaseWeaponItem.h"
+#include "Items/BaseAmmoItem.h"
+#include "Items/BaseHealingItem.h"
+#include "ItemAssetStreamer.h"
 
 
+//////////////////////////////////////////////////////////////////////////
+// FItemDecayState
+
+void FItemDecayState::Start(float DecayRate, float Now)
+{
+	if (Timestamp < 0.0f)
+	{
+		Rate = DecayRate;
+		Timestamp = Now;
+	}
+}
+
+void FItemDecayState::Rebase(float Now)
+{
+	if (IsDecaying())
+	{
+		BaseCondition = GetCondition(Now);
+		Timestamp = Now;
+	}
+}
+
+FItemDecayState FItemDecayState::Merge(const FItemDecayState &A, int32 CountA, const FItemDecayState &B, int32 CountB, EDecayMergePolicy Policy, float Now)
+{
+	const float ConditionA = A.GetCondition(Now);
+	const float ConditionB = B.GetCondition(Now);
+
+	FItemDecayState Result;
+	Result.Rate = FMath::Max(A.Rate, B.Rate);
+	Result.Timestamp = (A.Timestamp >= 0.0f || B.Timestamp >= 0.0f) ? Now : -1.0f;
+
+	switch (Policy)
+	{
+	case EDecayMergePolicy::DMP_KeepWorst:
+		Result.BaseCondition = FMath::Min(ConditionA, ConditionB);
+		break;
+	case EDecayMergePolicy::DMP_KeepBest:
+		Result.BaseCondition = FMath::Max(ConditionA, ConditionB);
+		break;
+	default:
+		Result.BaseCondition = (CountA + CountB) > 0
+			? (ConditionA * CountA + ConditionB * CountB) / (CountA + CountB)
+			: FMath::Min(ConditionA, ConditionB);
+		break;
+	}
+
+	// Thresholds the fresher side had not reached yet are reported again for the merged stack
+	Result.ThresholdsPassed = FMath::Min(A.ThresholdsPassed, B.ThresholdsPassed);
+	return Result;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// UBaseItem
+
 UBaseItem::UBaseItem()
 {
-	ID = FName("NO_ID");
+	ID = ItemNames::NoID;
 	Name = FText();
 
-	WorldMesh = nullptr;
-	DetailMesh = nullptr;
-	Icon = nullptr;
-
 	MaxStackSize = 0;
 	Value = 0;
 
 	ItemType = EItemType::IT_Item;
 	CanDrop = true;
+	GridWidth = 1;
+	GridHeight = 1;
+	Weight = 0.0f;
+
+	DecayRate = 0.0f;
+	DecayMergePolicy = EDecayMergePolicy::DMP_Average;
+
+	CachedCapabilities = 0;
+	bCapabilitiesCached = false;
 }
 
+uint8 UBaseItem::GetClassCapabilities(UClass *ItemClass)
+{
+	if (ItemClass == nullptr || !ItemClass->IsChildOf(UBaseItem::StaticClass()))
+	{
+		return 0;
+	}
+
+	UBaseItem *Default = ItemClass->GetDefaultObject<UBaseItem>();
+	if (!Default->bCapabilitiesCached)
+	{
+		uint8 Capabilities = 0;
+		if (ItemClass->ImplementsInterface(UUsableInterface::StaticClass()))
+		{
+			Capabilities |= ItemCapabilityBit(EItemCapability::IC_Usable);
+		}
+		if (ItemClass->IsChildOf(UBaseHealingItem::StaticClass()))
+		{
+			Capabilities |= ItemCapabilityBit(EItemCapability::IC_Healing);
+		}
+		if (ItemClass->IsChildOf(UBaseAmmoItem::StaticClass()))
+		{
+			Capabilities |= ItemCapabilityBit(EItemCapability::IC_Ammo);
+		}
+		if (ItemClass->IsChildOf(UBaseWeaponItem::StaticClass()))
+		{
+			Capabilities |= ItemCapabilityBit(EItemCapability::IC_Weapon);
+			if (Default->ItemType == EItemType::IT_Weapon)
+			{
+				Capabilities |= ItemCapabilityBit(EItemCapability::IC_Equippable);
+			}
+		}
+		if (Default->CanDrop)
+		{
+			Capabilities |= ItemCapabilityBit(EItemCapability::IC_Droppable);
+		}
+
+		Default->CachedCapabilities = Capabilities;
+		Default->bCapabilitiesCached = true;
+	}
+	return Default->CachedCapabilities;
+}
+
+int32 UBaseItem::GetDecayStage(float Condition) const
+{
+	int32 Stage = 0;
+	while (Stage < DecayThresholds.Num() && Condition <= DecayThresholds[Stage])
+	{
+		Stage++;
+	}
+	return Stage;
+}
+
+bool UBaseItem::CanMergeDecay(const FItemDecayState &A, const FItemDecayState &B, float Now) const
+{
+	if (DecayMergePolicy != EDecayMergePolicy::DMP_SameStage)
+	{
+		return true;
+	}
+	return GetDecayStage(A.GetCondition(Now)) == GetDecayStage(B.GetCondition(Now));
+}
+
+void UBaseItem::GetStreamableAssets(TArray<FStringAssetReference> &OutAssets) const
+{
+	if (!WorldMesh.IsNull())
+	{
+		OutAssets.Add(WorldMesh.ToStringReference());
+	}
+	if (!DetailMesh.IsNull())
+	{
+		OutAssets.Add(DetailMesh.ToStringReference());
+	}
+	if (!Icon.IsNull())
+	{
+		OutAssets.Add(Icon.ToStringReference());
+	}
+}
+
+UTexture2D *UBaseItem::GetIcon() const
+{
+	if (Icon.IsNull() || Icon.IsValid())
+	{
+		return Icon.Get();
+	}
+
+	// Without a streamer (editor previews) just load it
+	UItemAssetStreamer *Streamer = UItemAssetStreamer::Get(this);
+	if (Streamer == nullptr)
+	{
+		return Icon.LoadSynchronous();
+	}
+
+	Streamer->RequestIcon(this);
+	return nullptr;
+}
+
+UWorld *UBaseItem::GetWorld() const
+{
+	// Class defaults have no world
+	if (IsTemplate() || GetOuter() == nullptr)
+	{
+		return nullptr;
+	}
+	return GetOuter()->GetWorld();
+}
@@ -46,6 +46,104 @@ enum class EWeaponState : uint8
 	WS_AmmoEmpty		UMETA(DisplayName = "Ammo Empty State")
 };
 
+/**
+* What an item class can do, worked out once per class (@see UBaseItem::GetClassCapabilities).
+* Used as bit indices.
+*/
+UENUM(BlueprintType)
+enum class EItemCapability : uint8
+{
+	IC_Usable			UMETA(DisplayName = "Usable"),			// Implements IUsableInterface
+	IC_Healing			UMETA(DisplayName = "Healing"),
+	IC_Ammo				UMETA(DisplayName = "Ammo"),
+	IC_Weapon			UMETA(DisplayName = "Weapon"),
+	IC_Equippable		UMETA(DisplayName = "Equippable"),
+	IC_Droppable		UMETA(DisplayName = "Droppable"),
+
+	IC_Count			UMETA(Hidden)
+};
+
+FORCEINLINE uint8 ItemCapabilityBit(EItemCapability Capability)
+{
+	return 1 << (uint8)Capability;
+}
+
+/**
+* How two stacks of the same decaying item with different condition become one
+*/
+UENUM(BlueprintType)
+enum class EDecayMergePolicy : uint8
+{
+	DMP_Average			UMETA(DisplayName = "Average"),				// Average weighted by stack size
+	DMP_KeepWorst		UMETA(DisplayName = "Keep Worst"),
+	DMP_KeepBest		UMETA(DisplayName = "Keep Best"),
+	DMP_SameStage		UMETA(DisplayName = "Same Stage Only")		// Only stack between the same thresholds, then average
+};
+
+/**
+* Condition of a decaying item stack (food spoilage, tool wear). Evaluated lazily:
+* nothing ticks, the current condition is worked out from the condition at a known
+* time and the rate whenever it is read.
+*/
+USTRUCT(BlueprintType)
+struct FItemDecayState
+{
+	GENERATED_USTRUCT_BODY()
+
+	// Condition at Timestamp, 100 is new
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Decay)
+	float BaseCondition;
+
+	// Condition lost per second
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Decay)
+	float Rate;
+
+	// World time BaseCondition is from. Negative until decay has started.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Decay)
+	float Timestamp;
+
+	// Number of the item's decay thresholds already crossed and reported
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Decay)
+	int32 ThresholdsPassed;
+
+	// Pending threshold event in the decay scheduler, 0 if none
+	uint32 EventSerial;
+
+	FItemDecayState()
+	{
+		BaseCondition = 100.0f;
+		Rate = 0.0f;
+		Timestamp = -1.0f;
+		ThresholdsPassed = 0;
+		EventSerial = 0;
+	}
+
+	FORCEINLINE bool IsDecaying() const
+	{
+		return Rate > 0.0f && Timestamp >= 0.0f;
+	}
+
+	FORCEINLINE float GetCondition(float Now) const
+	{
+		return IsDecaying() ? FMath::Max(BaseCondition - Rate * (Now - Timestamp), 0.0f) : BaseCondition;
+	}
+
+	// Start decaying at DecayRate from Now, unless already started
+	void Start(float DecayRate, float Now);
+
+	// Fold the decay so far into BaseCondition, e.g. before saving
+	void Rebase(float Now);
+
+	// World time the condition reaches Condition. Only meaningful while decaying.
+	FORCEINLINE float GetTimeAtCondition(float Condition) const
+	{
+		return Timestamp + (BaseCondition - Condition) / Rate;
+	}
+
+	// State of CountA items in state A and CountB items in state B stacked together, taken at Now
+	static FItemDecayState Merge(const FItemDecayState &A, int32 CountA, const FItemDecayState &B, int32 CountB, EDecayMergePolicy Policy, float Now);
+};
+
 /**
  * 
  */
@@ -79,22 +177,87 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = BaseItem)
 	int32 MaxStackSize;
 
+	// Assets are loaded on demand by the item asset streamer (@see UItemAssetStreamer)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = BaseItem)
-	class UStaticMesh *WorldMesh;
+	TAssetPtr<class UStaticMesh> WorldMesh;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = BaseItem)
-	class USkeletalMesh *DetailMesh;
+	TAssetPtr<class USkeletalMesh> DetailMesh;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = BaseItem)
-	class UTexture2D *Icon;
+	TAssetPtr<class UTexture2D> Icon;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = BaseItem)
 	bool CanDrop;
 
+	// Cells the item covers in the inventory grid, unrotated
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = BaseItem, meta = (ClampMin = "1", ClampMax = "64"))
+	int32 GridWidth;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = BaseItem, meta = (ClampMin = "1", ClampMax = "64"))
+	int32 GridHeight;
+
+	// Width and height in cells, turned 90 degrees if bRotated
+	FORCEINLINE FIntPoint GetFootprint(bool bRotated) const
+	{
+		return bRotated ? FIntPoint(GridHeight, GridWidth) : FIntPoint(GridWidth, GridHeight);
+	}
+
+	// Weight of one item in kg. Carried weight slows the character (@see UInventoryComponent::CarryCapacity)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = BaseItem, meta = (ClampMin = "0.0"))
+	float Weight;
+
+	// Weight of one item in the whole grams inventory totals are kept in
+	FORCEINLINE int32 GetWeightGrams() const
+	{
+		return FMath::RoundToInt(Weight * 1000.0f);
+	}
+
+	// Condition lost per second. 0 never decays.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Decay)
+	float DecayRate;
+
+	// Conditions that raise an event when crossed (stale, spoiled, ...), highest first
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Decay)
+	TArray<float> DecayThresholds;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Decay)
+	EDecayMergePolicy DecayMergePolicy;
+
+	// EItemCapability bits of ItemClass. Computed the first time a class is asked about and kept on its default object.
+	static uint8 GetClassCapabilities(UClass *ItemClass);
+
+	FORCEINLINE uint8 GetCapabilities() const
+	{
+		return GetClassCapabilities(GetClass());
+	}
+
+	// Number of DecayThresholds at or above Condition
+	int32 GetDecayStage(float Condition) const;
+
+	// Whether stacks in states A and B may be stacked together under DecayMergePolicy
+	bool CanMergeDecay(const FItemDecayState &A, const FItemDecayState &B, float Now) const;
+
 	FORCEINLINE EItemType GetItemType()
 	{
 		return ItemType;
 	}
 
+	// Returns the icon if it is loaded. Otherwise starts streaming it in and returns nullptr,
+	// so widgets polling this get the icon a few frames later.
+	UFUNCTION(BlueprintCallable, Category = BaseItem)
+	class UTexture2D *GetIcon() const;
+
+	// Soft referenced assets this item needs when held or shown
+	virtual void GetStreamableAssets(TArray<FStringAssetReference> &OutAssets) const;
+
+	// Items live in the world of whatever holds them (inventory component, pickup actor)
+	virtual UWorld *GetWorld() const override;
+
 	UBaseItem();
+
+private:
+	// Only meaningful on the class default object
+	uint8 CachedCapabilities;
+	bool bCapabilitiesCached;
 };
@@ -2,27 +2,55 @@
 
 #include "Survival.h"
 #include "BaseWeaponActor.h"
+#include "ItemAssetStreamer.h"
 
 
 // Sets default values
 ABaseWeaponActor::ABaseWeaponActor()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
-
+	// Only ever shown, hidden and moved along with the character
+	PrimaryActorTick.bCanEverTick = false;
+
+	WeaponMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("WeaponMesh"));
+	WeaponMesh->SetOnlyOwnerSee(true);			// only the owning player will see this mesh
+	WeaponMesh->bCastDynamicShadow = false;
+	WeaponMesh->CastShadow = false;
+	WeaponMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	RootComponent = WeaponMesh;
+
+	bHidden = true;
+	WeaponItem = nullptr;
 }
 
-// Called when the game starts or when spawned
-void ABaseWeaponActor::BeginPlay()
+void ABaseWeaponActor::InitWeapon(UBaseWeaponItem *Weapon)
 {
-	Super::BeginPlay();
-	
+	WeaponItem = Weapon;
+	if (WeaponItem == nullptr)
+	{
+		WeaponMesh->SetSkeletalMesh(nullptr);
+		return;
+	}
+
+	UItemAssetStreamer *Streamer = UItemAssetStreamer::Get(this);
+	if (WeaponItem->DetailMesh.IsValid() || Streamer == nullptr)
+	{
+		OnWeaponMeshLoaded();
+	}
+	else
+	{
+		Streamer->RequestItemAssets(WeaponItem, FSimpleDelegate::CreateUObject(this, &ABaseWeaponActor::OnWeaponMeshLoaded));
+	}
 }
 
-// Called every frame
-void ABaseWeaponActor::Tick( float DeltaTime )
+void ABaseWeaponActor::SetDrawn(bool bDrawn)
 {
-	Super::Tick( DeltaTime );
-
+	SetActorHiddenInGame(!bDrawn);
 }
 
+void ABaseWeaponActor::OnWeaponMeshLoaded()
+{
+	if (WeaponItem != nullptr)
+	{
+		WeaponMesh->SetSkeletalMesh(WeaponItem->DetailMesh.Get());
+	}
+}
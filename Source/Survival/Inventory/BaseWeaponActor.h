@@ -5,21 +5,44 @@
 #include "GameFramework/Actor.h"
 #include "BaseWeaponActor.generated.h"
 
+/**
+* First person representation of a weapon held in a hot-bar slot.
+* Spawned and attached when the weapon is put in the hot-bar, then only shown or hidden
+* when the weapon is drawn or holstered (@see UInventoryComponent::SelectHotBarSlot).
+*/
 UCLASS()
 class SURVIVAL_API ABaseWeaponActor : public AActor
 {
 	GENERATED_BODY()
-	
+
+	/** Weapon mesh: 1st person view (seen only by self) */
+	UPROPERTY(VisibleDefaultsOnly, Category = Mesh)
+	class USkeletalMeshComponent *WeaponMesh;
+
 public:	
 	// Sets default values for this actor's properties
 	ABaseWeaponActor();
 
-	// Called when the game starts or when spawned
-	virtual void BeginPlay() override;
-	
-	// Called every frame
-	virtual void Tick( float DeltaSeconds ) override;
+	// Set up for Weapon. The mesh is set once streamed in.
+	void InitWeapon(class UBaseWeaponItem *Weapon);
+
+	// Show or hide the weapon
+	void SetDrawn(bool bDrawn);
+
+	FORCEINLINE class UBaseWeaponItem *GetWeapon() const
+	{
+		return WeaponItem;
+	}
+
+	FORCEINLINE class USkeletalMeshComponent *GetWeaponMesh() const
+	{
+		return WeaponMesh;
+	}
+
+protected:
+	// Called when the weapon's detail mesh is loaded
+	void OnWeaponMeshLoaded();
 
-	
-	
+	UPROPERTY()
+	class UBaseWeaponItem *WeaponItem;
 };
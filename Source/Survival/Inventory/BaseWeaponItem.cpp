@@ -1,8 +1,8 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Survival.h"
-#include "Weapons/WeaponState.h"
-#include "Weapons/WeaponStateEquipping.h"
+#include "Weapons/WeaponUpdateManager.h"
+#include "ItemAssetStreamer.h"
 
 
 UBaseWeaponItem::UBaseWeaponItem(const FObjectInitializer& ObjectInitializer)
@@ -11,70 +11,183 @@ UBaseWeaponItem::UBaseWeaponItem(const FObjectInitializer& ObjectInitializer)
 	ItemType = EItemType::IT_Weapon;
 	AmmoType = EAmmoType::AT_Other;
 
-	InactiveState = ObjectInitializer.CreateDefaultSubobject<UWeaponState>(this, TEXT("StateInactive"));
-	EquippingState = ObjectInitializer.CreateDefaultSubobject<UWeaponState>(this, TEXT("StateEquipping"));
-	IdleState = ObjectInitializer.CreateDefaultSubobject<UWeaponState>(this, TEXT("StateIdle"));
-	FiringState = ObjectInitializer.CreateDefaultSubobject<UWeaponState>(this, TEXT("FiringState"));
-	ReloadingState = ObjectInitializer.CreateDefaultSubobject<UWeaponState>(this, TEXT("ReloadingState"));
-	CurrentState = InactiveState;
+	ClipSize = 0;
+	MaxClipSize = 0;
+
+	fRefireDelay = 0.1f;
+	fReloadTime = 1.5f;
+	EquipTime = 0.3f;
+
 	WeaponActor = nullptr;
+	UpdateIndex = INDEX_NONE;
 }
 
 void UBaseWeaponItem::BeginPlay()
 {
-	if (CurrentState == InactiveState)
+	// Weapons start out inactive and are not ticked until equipped
+	GotoState(EWeaponState::WS_Inactive);
+}
+
+
+void UBaseWeaponItem::OnEquipped()
+{
+	// Keep our assets loaded while held
+	UItemAssetStreamer *Streamer = UItemAssetStreamer::Get(this);
+	if (Streamer != nullptr)
+	{
+		Streamer->RequestItemAssets(this, FSimpleDelegate(), true);
+	}
+
+	GotoState(EquipTime > 0.0f ? EWeaponState::WS_Equipping : EWeaponState::WS_Idle);
+}
+
+void UBaseWeaponItem::OnUnEquipped()
+{
+	// Recently held weapons stay loaded until the streamer needs the memory
+	UItemAssetStreamer *Streamer = UItemAssetStreamer::Get(this);
+	if (Streamer != nullptr)
+	{
+		Streamer->ReleaseItemAssets(this);
+	}
+
+	GotoState(EWeaponState::WS_Inactive);
+}
+
+void UBaseWeaponItem::GetStreamableAssets(TArray<FStringAssetReference> &OutAssets) const
+{
+	Super::GetStreamableAssets(OutAssets);
+
+	for (const TAssetPtr<USoundBase> &Sound : FireSound)
+	{
+		if (!Sound.IsNull())
+		{
+			OutAssets.Add(Sound.ToStringReference());
+		}
+	}
+	for (const TAssetPtr<UAnimMontage> &Animation : FireAnimation)
+	{
+		if (!Animation.IsNull())
+		{
+			OutAssets.Add(Animation.ToStringReference());
+		}
+	}
+}
+
+void UBaseWeaponItem::StartFire()
+{
+	StateData.bWantsToFire = true;
+	if (StateData.CurrentState == EWeaponState::WS_Idle)
+	{
+		GotoState(EWeaponState::WS_Firing);
+	}
+}
+
+void UBaseWeaponItem::StopFire()
+{
+	StateData.bWantsToFire = false;
+}
+
+void UBaseWeaponItem::StartReload()
+{
+	if (StateData.CurrentState == EWeaponState::WS_Idle || StateData.CurrentState == EWeaponState::WS_Firing || StateData.CurrentState == EWeaponState::WS_AmmoEmpty)
 	{
-		GotoState(InactiveState);
+		if (MaxClipSize > 0 && ClipSize < MaxClipSize)
+		{
+			GotoState(EWeaponState::WS_Reloading);
+		}
 	}
-	checkSlow(CurrentState != NULL);
 }
 
+void UBaseWeaponItem::FireShot(float ShotTime)
+{
+	if (MaxClipSize > 0)
+	{
+		ClipSize--;
+	}
+
+	if (CharOwner != nullptr)
+	{
+		CharOwner->FireWeaponShot(this, ShotTime);
+	}
+}
+
+void UBaseWeaponItem::FinishReload()
+{
+	if (CharOwner != nullptr && CharOwner->InventoryComponent != nullptr)
+	{
+		CharOwner->InventoryComponent->ReloadEquippedWeapon();
+	}
+}
 
-void UBaseWeaponItem::Tick(float DeltaTime)
+void UBaseWeaponItem::TickWeapon(float DeltaTime)
 {
 	// This weapon should not be active without a owner
-	if (CurrentState != InactiveState && (CharOwner == NULL || CharOwner->IsPendingKill()) && CurrentState != NULL)
+	if (StateData.CurrentState != EWeaponState::WS_Inactive && (CharOwner == NULL || CharOwner->IsPendingKill()))
 	{
-		UE_LOG(SurvivalDebugLog, Warning, TEXT("%s lost Owner while active (state %s)"), *GetName(), *GetNameSafe(CurrentState));
-		GotoState(InactiveState);
+		UE_LOG(SurvivalDebugLog, Warning, TEXT("%s lost Owner while active (state %d)"), *GetName(), (int32)StateData.CurrentState);
+		GotoState(EWeaponState::WS_Inactive);
+		return;
 	}
 
-	if (CurrentState != InactiveState)
+	StateData.StateTime += DeltaTime;
+
+	const FWeaponStateHandlers *Handlers = FWeaponStateTable::Find(StateData.CurrentState);
+	if (Handlers != nullptr && Handlers->OnTick != nullptr)
 	{
-		CurrentState->Tick(DeltaTime);
+		Handlers->OnTick(*this, StateData, DeltaTime);
 	}
 }
 
-void UBaseWeaponItem::GotoState(class UWeaponState *NewState)
+void UBaseWeaponItem::GotoState(EWeaponState NewState)
 {
-	// Only call StateChanged when the state type actually changes
-	// End current state
-	// begin new state
+	const FWeaponStateHandlers *NewHandlers = FWeaponStateTable::Find(NewState);
+	if (NewHandlers == nullptr)
+	{
+		UE_LOG(SurvivalDebugLog, Warning, TEXT("Attempt to send %s to invalid state %d"), *GetName(), (int32)NewState);
+		return;
+	}
 
-	if (NewState == NULL || !NewState->IsIn(this))
+	// We only do something if the state changes entirely
+	if (StateData.CurrentState == NewState)
 	{
-		UE_LOG(SurvivalDebugLog, Warning, TEXT("Attempt to send %s to invalid state %s"), *GetName(), *GetFullNameSafe(NewState));
+		return;
 	}
-	else
+
+	const EWeaponState PrevState = StateData.CurrentState;
+	const FWeaponStateHandlers *PrevHandlers = FWeaponStateTable::Find(PrevState);
+	if (PrevHandlers != nullptr && PrevHandlers->OnExit != nullptr)
 	{
-		// We only do something if the state changes entirely
-		if (CurrentState != NewState)
+		PrevHandlers->OnExit(*this, StateData); // May trigger another GotoState call
+	}
+
+	// Make sure the exit handler did not trigger a new state change
+	if (StateData.CurrentState != PrevState)
+	{
+		return;
+	}
+
+	StateData.CurrentState = NewState;
+	StateData.StateTime = 0.0f;
+
+	// Only weapons that are doing something get updated
+	UWeaponUpdateManager *UpdateManager = UWeaponUpdateManager::Get(this);
+	if (UpdateManager != nullptr)
+	{
+		if (NewHandlers->bNeedsTick)
+		{
+			UpdateManager->RegisterWeapon(this);
+		}
+		else
 		{
-			UWeaponState *PrevState = CurrentState;
-			// Current state might be NULL if this is initial Goto
-			if (CurrentState != NULL)
-			{
-				CurrentState->EndState(); // May trigger another GotoState call
-			}
-			// Make sure the EndState did not trigger a new state change (Will be equal if not)
-			if (CurrentState == PrevState)
-			{
-				CurrentState = NewState;
-				CurrentState->BeginState(PrevState);
-				StateChanged();
-			}
+			UpdateManager->UnregisterWeapon(this);
 		}
 	}
+
+	if (NewHandlers->OnEnter != nullptr)
+	{
+		NewHandlers->OnEnter(*this, StateData, PrevState);
+	}
+	StateChanged();
 }
 
 void UBaseWeaponItem::PrintItemDebug()
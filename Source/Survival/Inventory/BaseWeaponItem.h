@@ -3,7 +3,7 @@
 #pragma once
 
 #include "Inventory/BaseItem.h"
-#include "Tickable.h"
+#include "Weapons/WeaponStateMachine.h"
 #include "BaseWeaponItem.generated.h"
 
 
@@ -11,11 +11,12 @@
  * 
  */
 UCLASS(Blueprintable, Config = Game)
-class SURVIVAL_API UBaseWeaponItem : public UBaseItem, public FTickableGameObject
+class SURVIVAL_API UBaseWeaponItem : public UBaseItem
 {
 	GENERATED_UCLASS_BODY()
 
-	friend class UWeaponState;
+	friend class FWeaponStateTable;
+	friend class UWeaponUpdateManager;
 
 public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = ProjectileWeapon)
@@ -39,62 +40,87 @@ public:
 
 	/** Sound to play each time we fire */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-	TArray<class USoundBase*> FireSound;
+	TArray<TAssetPtr<class USoundBase>> FireSound;
 
 	/** AnimMontage to play each time we fire */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-	TArray<class UAnimMontage*> FireAnimation;
+	TArray<TAssetPtr<class UAnimMontage>> FireAnimation;
 
 	//////////////////////////////////////////////////////////
-	// FTickableGameObject
+	// Update. Only called while the weapon is not inactive (@see UWeaponUpdateManager)
 
-	virtual void Tick(float fDeltaTime) override;
-	virtual bool IsTickable() const override { return true;  }
-	virtual TStatId GetStatId() const override { return this->GetStatID(); }
+	virtual void TickWeapon(float DeltaTime);
 
 	virtual void BeginPlay();
 
+	// Called by the inventory when the weapon is equipped/unequipped
+	virtual void OnEquipped();
+	virtual void OnUnEquipped();
+
+	virtual void GetStreamableAssets(TArray<FStringAssetReference> &OutAssets) const override;
 
 	//////////////////////////////////////////////////////////
-	// States
-	
-public:
+	// Firing
 
-	virtual void GotoState(class UWeaponState *NewState);
-	virtual void StateChanged(){}
+	// Trigger pressed/released. Shots are scheduled by the Firing state from fRefireDelay.
+	UFUNCTION(BlueprintCallable, Category = ProjectileWeapon)
+	void StartFire();
 
-	// 0: Inactive state
-	// 1: Equipping state [Equip -> Idle]
-	// 2: Idle state [Idle -> Fire | Idle -> Reload]
-	// 3: Firing state [dryfire / fireprojectile]
-	// 4: Reloading state
+	UFUNCTION(BlueprintCallable, Category = ProjectileWeapon)
+	void StopFire();
 
-protected:
+	UFUNCTION(BlueprintCallable, Category = ProjectileWeapon)
+	void StartReload();
 
-	UPROPERTY(BlueprintReadOnly, Category = "Weapon States")
-	UWeaponState *CurrentState;
+	// Weapons without a clip (MaxClipSize 0) never run dry
+	FORCEINLINE bool HasAmmo() const
+	{
+		return MaxClipSize <= 0 || ClipSize > 0;
+	}
 
-	UPROPERTY(BlueprintReadOnly, Category = "Weapon States")
-	UWeaponState *InactiveState;
+	// Fire one shot that was due at world time ShotTime. May be earlier than the current time.
+	virtual void FireShot(float ShotTime);
 
-	UPROPERTY(BlueprintReadOnly, Category = "Weapon States")
-	UWeaponState *EquippingState;
+	// Called when a reload has taken fReloadTime
+	virtual void FinishReload();
 
-	UPROPERTY(BlueprintReadOnly, Category = "Weapon States")
-	UWeaponState *IdleState;
 
-	UPROPERTY(BlueprintReadOnly, Category = "Weapon States")
-	UWeaponState *FiringState;
+	//////////////////////////////////////////////////////////
+	// States
+	
+public:
+
+	virtual void GotoState(EWeaponState NewState);
+	virtual void StateChanged(){}
+
+	UFUNCTION(BlueprintCallable, Category = "Weapon States")
+	EWeaponState GetCurrentState() const { return StateData.CurrentState; }
 
+protected:
+
+	// Per-weapon state machine data. Behaviour lives in FWeaponStateTable.
 	UPROPERTY(BlueprintReadOnly, Category = "Weapon States")
-	UWeaponState *ReloadingState;
+	FWeaponStateData StateData;
 
 	//////////////////////////////////////////////////////////
 	// State variables
 
+	// Seconds between shots
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon States")
 	float fRefireDelay;
+
+	// Seconds a reload takes
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon States")
 	float fReloadTime;
 
+	// Seconds to equip/unequip the weapon
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon States")
+	float EquipTime;
+
+private:
+	// Index in the update manager's active weapon array, INDEX_NONE while inactive
+	int32 UpdateIndex;
+
 public:
 	///////////////////////////////////////////////////////////
 	// Other
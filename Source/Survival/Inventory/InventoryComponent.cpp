@@ -8,6 +8,15 @@
 #include "BaseItem.h"
 #include "BaseWeaponItem.h"
 #include "Items/BaseAmmoItem.h"
+#include "ItemAssetStreamer.h"
+#include "BaseWeaponActor.h"
+#include "ItemDecayScheduler.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hot Bar Swap"), STAT_HotBarSwap, STATGROUP_Survival);
+DECLARE_CYCLE_STAT(TEXT("Inventory Watch Flush"), STAT_InventoryWatchFlush, STATGROUP_Survival);
+DECLARE_CYCLE_STAT(TEXT("Inventory Sort"), STAT_InventorySort, STATGROUP_Survival);
+DECLARE_CYCLE_STAT(TEXT("Inventory Consolidate Stacks"), STAT_InventoryConsolidate, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Inventory Watch Notifications"), STAT_InventoryWatchNotifications, STATGROUP_Survival);
 
 //////////////////////////////////////////////////////////////////////////
 // FInventoryItemSlotInfo
@@ -25,7 +34,192 @@ bool FItemSlotInfo::ItemTypeRefIsValid()
 	return ItemTypeReference->IsValidLowLevel();
 }
 
-const FItemSlotInfo FItemSlotInfo::InvalidSlot = FItemSlotInfo(FName(TEXT("INVALID")), INDEX_NONE, 0, 0, nullptr, nullptr);
+//////////////////////////////////////////////////////////////////////////
+// FInventorySlotStorage
+
+void FInventorySlotStorage::SetNumSlots(int32 NumSlots)
+{
+	for (int32 Slot = NumSlots; Slot < ItemIndices.Num(); Slot++)
+	{
+		if (ItemIndices[Slot] != INDEX_NONE)
+		{
+			NumOccupied--;
+		}
+	}
+
+	const int32 OldNum = ItemIndices.Num();
+	ItemIDs.SetNum(NumSlots);
+	StackSizes.SetNum(NumSlots);
+	MaxStackSizes.SetNum(NumSlots);
+	Capabilities.SetNum(NumSlots);
+	Definitions.SetNum(NumSlots);
+	ItemIndices.SetNum(NumSlots);
+
+	for (int32 Slot = OldNum; Slot < NumSlots; Slot++)
+	{
+		ItemIDs[Slot] = NAME_None;
+		StackSizes[Slot] = 0;
+		MaxStackSizes[Slot] = 0;
+		Capabilities[Slot] = 0;
+		Definitions[Slot] = nullptr;
+		ItemIndices[Slot] = INDEX_NONE;
+	}
+}
+
+void FInventorySlotStorage::Occupy(const FItemSlotInfo &SlotInfo, int32 ItemIndex)
+{
+	const int32 Slot = SlotInfo.SlotIndex;
+	if (!ItemIndices.IsValidIndex(Slot))
+	{
+		UE_LOG(InventorySystemLog, Error, TEXT("FInventorySlotStorage::Occupy : Slot %d out of range"), Slot);
+		return;
+	}
+
+	if (ItemIndices[Slot] == INDEX_NONE)
+	{
+		NumOccupied++;
+	}
+	ItemIDs[Slot] = SlotInfo.ItemID;
+	StackSizes[Slot] = SlotInfo.StackSize;
+	MaxStackSizes[Slot] = SlotInfo.MaxStackSize;
+	Capabilities[Slot] = SlotInfo.Capabilities;
+	Definitions[Slot] = SlotInfo.ItemTypeReference;
+	ItemIndices[Slot] = ItemIndex;
+
+	SearchIndex.Add(Slot, SlotInfo.ItemTypeReference);
+}
+
+void FInventorySlotStorage::Release(int32 Slot)
+{
+	if (!IsOccupied(Slot))
+	{
+		return;
+	}
+
+	NumOccupied--;
+	// Open slots never match a stack lookup
+	ItemIDs[Slot] = NAME_None;
+	StackSizes[Slot] = 0;
+	MaxStackSizes[Slot] = 0;
+	Capabilities[Slot] = 0;
+	Definitions[Slot] = nullptr;
+	ItemIndices[Slot] = INDEX_NONE;
+
+	SearchIndex.Remove(Slot);
+}
+
+void FInventorySlotStorage::Swap(int32 SlotA, int32 SlotB)
+{
+	if (!ItemIndices.IsValidIndex(SlotA) || !ItemIndices.IsValidIndex(SlotB))
+	{
+		return;
+	}
+
+	ItemIDs.Swap(SlotA, SlotB);
+	StackSizes.Swap(SlotA, SlotB);
+	MaxStackSizes.Swap(SlotA, SlotB);
+	Capabilities.Swap(SlotA, SlotB);
+	Definitions.Swap(SlotA, SlotB);
+	ItemIndices.Swap(SlotA, SlotB);
+
+	SearchIndex.SwapSlots(SlotA, SlotB);
+}
+
+void FInventorySlotStorage::Rebuild(const TArray<FItemSlotInfo> &Items, int32 NumSlots)
+{
+	// Indexing everything in one go beats inserting item by item
+	const bool bIndexed = SearchIndex.IsBuilt();
+	SearchIndex.Reset();
+
+	ItemIndices.Reset();
+	NumOccupied = 0;
+	SetNumSlots(NumSlots);
+
+	for (int32 i = 0; i < Items.Num(); i++)
+	{
+		Occupy(Items[i], i);
+	}
+
+	if (bIndexed)
+	{
+		SearchIndex.Build(Definitions);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Sorting
+
+namespace InventorySort
+{
+	struct FEntry
+	{
+		// Compared first, then Tiebreak
+		uint64 Key;
+		uint32 Tiebreak;
+		int32 ItemIndex;
+	};
+
+	// First 8 characters of String, upper case, packed so the integers order like the strings
+	uint64 PackPrefix(const FString &String)
+	{
+		uint64 Prefix = 0;
+		for (int32 i = 0; i < 8; i++)
+		{
+			const uint32 Char = i < String.Len() ? (uint32)FChar::ToUpper(String[i]) : 0;
+			Prefix = (Prefix << 8) | FMath::Min(Char, 255u);
+		}
+		return Prefix;
+	}
+
+	// One stable counting pass on the byte of Value at Shift. Skipped if every entry has the same byte.
+	template<typename ValueFuncType>
+	void RadixPass(TArray<FEntry> &Entries, TArray<FEntry> &Scratch, int32 Shift, ValueFuncType ValueFunc)
+	{
+		int32 Counts[256] = { 0 };
+		for (const FEntry &Entry : Entries)
+		{
+			Counts[(ValueFunc(Entry) >> Shift) & 0xff]++;
+		}
+		if (Counts[(ValueFunc(Entries[0]) >> Shift) & 0xff] == Entries.Num())
+		{
+			return;
+		}
+
+		int32 Offset = 0;
+		for (int32 Digit = 0; Digit < 256; Digit++)
+		{
+			const int32 Count = Counts[Digit];
+			Counts[Digit] = Offset;
+			Offset += Count;
+		}
+
+		Scratch.SetNumUninitialized(Entries.Num(), false);
+		for (const FEntry &Entry : Entries)
+		{
+			Scratch[Counts[(ValueFunc(Entry) >> Shift) & 0xff]++] = Entry;
+		}
+		Exchange(Entries, Scratch);
+	}
+
+	// Least significant digit radix sort on (Key, Tiebreak)
+	void RadixSort(TArray<FEntry> &Entries)
+	{
+		if (Entries.Num() < 2)
+		{
+			return;
+		}
+
+		TArray<FEntry> Scratch;
+		for (int32 Shift = 0; Shift < 32; Shift += 8)
+		{
+			RadixPass(Entries, Scratch, Shift, [](const FEntry &Entry) { return (uint64)Entry.Tiebreak; });
+		}
+		for (int32 Shift = 0; Shift < 64; Shift += 8)
+		{
+			RadixPass(Entries, Scratch, Shift, [](const FEntry &Entry) { return Entry.Key; });
+		}
+	}
+}
 
 //////////////////////////////////////////////////////////////////////////
 // UInventoryComponent
@@ -33,9 +227,9 @@ const FItemSlotInfo FItemSlotInfo::InvalidSlot = FItemSlotInfo(FName(TEXT("INVAL
 // Sets default values for this component's properties
 UInventoryComponent::UInventoryComponent()
 {
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
+	// Only ticks to deliver watch notifications, in frames where watched items changed
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 
 	Rows = 4;
 	Columns = 2;
@@ -43,16 +237,22 @@ UInventoryComponent::UInventoryComponent()
 	// Set inventory slot count
 	Slots = Rows * Columns;
 
-	// Fill our array that keeps track of used slot indices
-	// with the indices for these slots
-	for (int i = 0; i < Slots; i++)
-	{
-		_openSlots.Add(i);
-	}
-
 	// Provide slack for our inventory
 	Items.Empty(Slots);
+	Grid.Init(Rows, Columns);
+	SlotStorage.SetNumSlots(Slots);
 	EquippedWeapon = nullptr;
+
+	HotBarSize = 4;
+	LastSwapMicroseconds = 0.0f;
+
+	CarryCapacity = 20.0f;
+	MaxCarryWeight = 40.0f;
+	MinEncumberedSpeedScale = 0.3f;
+	TotalWeight = 0.0f;
+	EncumbranceSpeedScale = 1.0f;
+	TotalWeightGrams = 0;
+	NextWatchHandle = 1;
 }
 
 
@@ -62,8 +262,29 @@ void UInventoryComponent::BeginPlay()
 	Super::BeginPlay();
 
 	CharOwner = Cast<ASurvivalCharacter>(GetOuter());
-	// ...
+
+	// Rows and Columns may have been set per blueprint since the constructor ran
+	if (Items.Num() == 0 && Slots != Rows * Columns)
+	{
+		Columns = FMath::Clamp(Columns, 1, (int32)FInventoryGrid::MaxColumns);
+		Rows = FMath::Max(Rows, 1);
+		Slots = Rows * Columns;
+		Grid.Init(Rows, Columns);
+		SlotStorage.SetNumSlots(Slots);
+	}
 	
+	HotBar.SetNum(HotBarSize);
+}
+
+// Called when the game ends or the owner is destroyed
+void UInventoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (int32 i = 0; i < HotBar.Num(); i++)
+	{
+		ClearHotBarSlot(i);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 
@@ -72,7 +293,7 @@ void UInventoryComponent::TickComponent( float DeltaTime, ELevelTick TickType, F
 {
 	Super::TickComponent( DeltaTime, TickType, ThisTickFunction );
 
-	// ...
+	FlushWatches();
 }
 
 // Called when an item in the slot is used
@@ -85,16 +306,26 @@ bool UInventoryComponent::UseItem(int32 Slot, ASurvivalCharacter *Target)
 		return false;
 	}
 
+	// Catch up on decay first, so a stack that just spoiled is used as spoiled.
+	// Decay listeners may change the inventory, so look the slot up again.
+	UpdateDecay(GetItemInfoIndexAtSlot(Slot));
+	SlotInfo = GetItemInSlot(Slot);
+	if (SlotInfo == nullptr || !IsSlotValidLowLevel(*SlotInfo))
+	{
+		return false;
+	}
+
 	UBaseItem *Item = SlotInfo->ItemTypeReference;
 
 	// Check if this item implements the Usable interface. 
-	if (Item->GetClass()->ImplementsInterface(UUsableInterface::StaticClass()) )
+	if (SlotInfo->HasCapability(EItemCapability::IC_Usable))
 	{
 		if (IUsableInterface::Execute_OnUse(Item, Target))
 		{
 			SlotInfo->StackSize -= 1;
+			AccumulateStack(*SlotInfo, -1);
 			// Not all items can be dropped if stacksize depletes
-			if (SlotInfo->StackSize <= 0 && SlotInfo->ItemTypeReference->CanDrop)
+			if (SlotInfo->StackSize <= 0 && SlotInfo->HasCapability(EItemCapability::IC_Droppable))
 			{
 				DropItem(SlotInfo->SlotIndex, INDEX_NONE); // Drop entire item - stack is empty
 			}
@@ -135,41 +366,277 @@ void UInventoryComponent::EquipItem(int32 Slot, ASurvivalCharacter *Target)
 	else if (ItemType == EItemType::IT_Weapon && Target != nullptr && Target->IsValidLowLevel())
 	{
 		// We have a weapon
-		UBaseWeaponItem *Weapon = Cast<UBaseWeaponItem>(Item);
+		UBaseWeaponItem *Weapon = SlotInfo->HasCapability(EItemCapability::IC_Weapon) ? static_cast<UBaseWeaponItem*>(Item) : nullptr;
 		if (!Weapon || !Weapon->IsValidLowLevel())
 		{
 			UE_LOG(SurvivalDebugLog, Warning, TEXT("EquipItem : Not subclass of UBaseWeaponItem!."));
+			return;
+		}
+
+		// Weapons in the hot-bar are already prepared
+		const int32 HotBarSlot = FindHotBarSlot(Weapon);
+		if (HotBarSlot != INDEX_NONE)
+		{
+			SelectHotBarSlot(HotBarSlot);
+			return;
+		}
+
+		if (EquippedWeapon == Weapon)
+		{
+			return;
 		}
 
+		// Deactivate whatever we held before
+		UnEquipItem();
+
 		// SET EQUIPPED WEAPON
 		EquippedWeapon = Weapon;
+		EquippedWeapon->OnEquipped();
 
 		// Handle equip on character
 		Target->HandleEquipWeapon(EquippedWeapon);
 	}
 }
 
-// Unequips the equipped item, if any
 void UInventoryComponent::UnEquipItem()
 {
+	if (EquippedWeapon == nullptr)
+	{
+		return;
+	}
+
+	EquippedWeapon->OnUnEquipped();
+
+	const int32 HotBarSlot = FindHotBarSlot(EquippedWeapon);
+	if (HotBarSlot != INDEX_NONE && HotBar[HotBarSlot].WeaponActor != nullptr)
+	{
+		HotBar[HotBarSlot].WeaponActor->SetDrawn(false);
+	}
+
 	EquippedWeapon = nullptr;
+
+	if (CharOwner != nullptr)
+	{
+		CharOwner->HandleUnEquipWeapon();
+	}
+}
+
+bool UInventoryComponent::AssignHotBarSlot(int32 HotBarSlot, int32 Slot)
+{
+	if (!HotBar.IsValidIndex(HotBarSlot) || CharOwner == nullptr)
+	{
+		UE_LOG(InventorySystemLog, Warning, TEXT("AssignHotBarSlot : Invalid hot-bar slot %d"), HotBarSlot);
+		return false;
+	}
+
+	FItemSlotInfo *SlotInfo = GetItemInSlot(Slot);
+	UBaseWeaponItem *Weapon = (SlotInfo && SlotInfo->HasCapability(EItemCapability::IC_Weapon)) ? static_cast<UBaseWeaponItem*>(SlotInfo->ItemTypeReference) : nullptr;
+	if (Weapon == nullptr)
+	{
+		UE_LOG(InventorySystemLog, Warning, TEXT("AssignHotBarSlot : No weapon in slot %d"), Slot);
+		return false;
+	}
+
+	if (HotBar[HotBarSlot].Weapon == Weapon)
+	{
+		return true;
+	}
+
+	// A weapon is only in one quick slot at a time
+	const int32 PreviousSlot = FindHotBarSlot(Weapon);
+	if (PreviousSlot != INDEX_NONE)
+	{
+		ClearHotBarSlot(PreviousSlot);
+	}
+	ClearHotBarSlot(HotBarSlot);
+
+	UWorld *World = GetWorld();
+	if (World == nullptr)
+	{
+		return false;
+	}
+
+	TSubclassOf<ABaseWeaponActor> ActorClass = Weapon->WeaponActor;
+	if (ActorClass == nullptr)
+	{
+		ActorClass = ABaseWeaponActor::StaticClass();
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = CharOwner;
+	SpawnParams.Instigator = CharOwner;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ABaseWeaponActor *WeaponActor = World->SpawnActor<ABaseWeaponActor>(ActorClass, CharOwner->GetActorTransform(), SpawnParams);
+	if (WeaponActor == nullptr)
+	{
+		UE_LOG(InventorySystemLog, Error, TEXT("AssignHotBarSlot : Failed to spawn weapon actor %s"), *GetNameSafe(ActorClass));
+		return false;
+	}
+
+	WeaponActor->AttachToComponent(CharOwner->GetMesh1P(), FAttachmentTransformRules(EAttachmentRule::SnapToTarget, true), TEXT("GripPoint"));
+	WeaponActor->SetDrawn(false);
+	WeaponActor->InitWeapon(Weapon);
+
+	// Hot-bar weapons keep their assets loaded, so drawing them never waits on a load
+	UItemAssetStreamer *Streamer = UItemAssetStreamer::Get(this);
+	if (Streamer != nullptr)
+	{
+		Streamer->RequestItemAssets(Weapon, FSimpleDelegate(), true);
+	}
+
+	HotBar[HotBarSlot].Weapon = Weapon;
+	HotBar[HotBarSlot].WeaponActor = WeaponActor;
+
+	// Already drawn the slow way; switch over to the prepared actor
+	if (EquippedWeapon == Weapon)
+	{
+		WeaponActor->SetDrawn(true);
+		CharOwner->HandleEquipWeapon(Weapon, WeaponActor);
+	}
+	return true;
+}
+
+void UInventoryComponent::ClearHotBarSlot(int32 HotBarSlot)
+{
+	if (!HotBar.IsValidIndex(HotBarSlot) || HotBar[HotBarSlot].Weapon == nullptr)
+	{
+		return;
+	}
+
+	FHotBarSlot &QuickSlot = HotBar[HotBarSlot];
+	if (QuickSlot.Weapon == EquippedWeapon)
+	{
+		UnEquipItem();
+	}
+
+	UItemAssetStreamer *Streamer = UItemAssetStreamer::Get(this);
+	if (Streamer != nullptr)
+	{
+		Streamer->ReleaseItemAssets(QuickSlot.Weapon);
+	}
+
+	if (QuickSlot.WeaponActor != nullptr)
+	{
+		QuickSlot.WeaponActor->Destroy();
+	}
+
+	QuickSlot = FHotBarSlot();
+}
+
+bool UInventoryComponent::SelectHotBarSlot(int32 HotBarSlot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HotBarSwap);
+
+	if (!HotBar.IsValidIndex(HotBarSlot) || HotBar[HotBarSlot].Weapon == nullptr || CharOwner == nullptr)
+	{
+		return false;
+	}
+
+	FHotBarSlot &QuickSlot = HotBar[HotBarSlot];
+	if (EquippedWeapon == QuickSlot.Weapon)
+	{
+		return true;
+	}
+
+	const uint32 StartCycles = FPlatformTime::Cycles();
+
+	// Holster the current weapon, draw the new one. Nothing is spawned or loaded.
+	if (EquippedWeapon != nullptr)
+	{
+		EquippedWeapon->OnUnEquipped();
+
+		const int32 PreviousSlot = FindHotBarSlot(EquippedWeapon);
+		if (PreviousSlot != INDEX_NONE && HotBar[PreviousSlot].WeaponActor != nullptr)
+		{
+			HotBar[PreviousSlot].WeaponActor->SetDrawn(false);
+		}
+	}
+
+	EquippedWeapon = QuickSlot.Weapon;
+	EquippedWeapon->OnEquipped();
+	if (QuickSlot.WeaponActor != nullptr)
+	{
+		QuickSlot.WeaponActor->SetDrawn(true);
+	}
+	CharOwner->HandleEquipWeapon(EquippedWeapon, QuickSlot.WeaponActor);
+
+	LastSwapMicroseconds = FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - StartCycles) * 1000.0f;
+	return true;
+}
+
+int32 UInventoryComponent::FindHotBarSlot(const UBaseWeaponItem *Weapon) const
+{
+	if (Weapon == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	for (int32 i = 0; i < HotBar.Num(); i++)
+	{
+		if (HotBar[i].Weapon == Weapon)
+		{
+			return i;
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 UInventoryComponent::SearchItems(const FString &Query, TArray<int32> &OutSlots)
+{
+	// Nothing to filter by
+	TArray<FString> Words;
+	FInventorySearchIndex::Tokenize(FText::AsCultureInvariant(Query), Words);
+
+	const int32 NumBefore = OutSlots.Num();
+	if (Words.Num() == 0)
+	{
+		for (int32 Slot = 0; Slot < SlotStorage.GetNumSlots(); Slot++)
+		{
+			if (SlotStorage.IsOccupied(Slot))
+			{
+				OutSlots.Add(Slot);
+			}
+		}
+		return OutSlots.Num() - NumBefore;
+	}
+
+	// Built on the first search, and again after a culture change
+	FInventorySearchIndex &SearchIndex = SlotStorage.SearchIndex;
+	if (!SearchIndex.IsBuilt() || SearchIndex.IsStale())
+	{
+		SearchIndex.Build(SlotStorage.Definitions);
+	}
+	return SearchIndex.Search(Query, OutSlots);
+}
+
+int32 UInventoryComponent::FilterByCapabilities(int32 CapabilityMask, TArray<int32> &OutSlots) const
+{
+	const uint8 Mask = (uint8)CapabilityMask;
+	const int32 NumBefore = OutSlots.Num();
+	for (int32 Slot = 0; Slot < SlotStorage.GetNumSlots(); Slot++)
+	{
+		if (SlotStorage.IsOccupied(Slot) && (SlotStorage.Capabilities[Slot] & Mask) == Mask)
+		{
+			OutSlots.Add(Slot);
+		}
+	}
+	return OutSlots.Num() - NumBefore;
 }
 
 // Called when equipped weapon must reload
 int32 UInventoryComponent::FindAmmoItemInSlot(EAmmoType AmmoType)
 {
-	for (int i = 0; i < Items.Num(); i++)
+	for (int32 Slot = 0; Slot < SlotStorage.GetNumSlots(); Slot++)
 	{
-		if (Items[i].ItemTypeRefIsValid())
+		if ((SlotStorage.Capabilities[Slot] & ItemCapabilityBit(EItemCapability::IC_Ammo)) != 0)
 		{
-			UBaseAmmoItem *AmmoItem = Cast<UBaseAmmoItem>(Items[i].ItemTypeReference);
+			const UBaseAmmoItem *AmmoItem = static_cast<const UBaseAmmoItem*>(SlotStorage.Definitions[Slot]);
 			if (AmmoItem != nullptr && AmmoItem->AmmoType == AmmoType)
 			{
 				// We found our ammo type. Return the slot index
-				return Items[i].SlotIndex;
+				return Slot;
 			}
 		}
-		
 	}
 
 	return INDEX_NONE;
@@ -199,11 +666,10 @@ bool UInventoryComponent::ReloadEquippedWeapon()
 		}
 		else
 		{
-			while (EquippedWeapon->ClipSize != EquippedWeapon->MaxClipSize)
-			{
-				AmmoSlotInfo->StackSize--;
-				EquippedWeapon->ClipSize++;
-			}
+			const int32 Loaded = EquippedWeapon->MaxClipSize - EquippedWeapon->ClipSize;
+			AmmoSlotInfo->StackSize -= Loaded;
+			EquippedWeapon->ClipSize += Loaded;
+			AccumulateStack(*AmmoSlotInfo, -Loaded);
 			return true;
 		}
 	}
@@ -215,19 +681,32 @@ bool UInventoryComponent::ReloadEquippedWeapon()
 }
 
 // Called from pawn when adding a picked-up item
-bool UInventoryComponent::AddItem(const FName &ItemID, int32 NewStackSize, EItemType ItemType, TSubclassOf<class UBaseItem> ItemTypeClass)
+bool UInventoryComponent::AddItem(const FName &ItemID, int32 NewStackSize, EItemType ItemType, TSubclassOf<class UBaseItem> ItemTypeClass, const FItemDecayState *Decay)
 {
-	int32 StackableItemsIndex = GetStackableItemsIndex(ItemID, NewStackSize);
+	int32 StackableItemsIndex = GetStackableItemsIndex(ItemID, NewStackSize, Decay);
 
 	// Are we adding to a slot, or creating a new?
 	if (StackableItemsIndex != INDEX_NONE )
 	{
+		MergeDecay(Items[StackableItemsIndex], NewStackSize, Decay, false);
 		Items[StackableItemsIndex].StackSize += NewStackSize;
+		AccumulateStack(Items[StackableItemsIndex], NewStackSize);
+		UpdateDecay(StackableItemsIndex);
 
 		return true;
 	}
 	else if(!IsFull())
 	{
+		// Find room for the item's footprint before creating it
+		const UBaseItem *ItemDefaults = ItemTypeClass ? ItemTypeClass->GetDefaultObject<UBaseItem>() : nullptr;
+		int32 FitSlot = INDEX_NONE;
+		bool bRotated = false;
+		if (ItemDefaults == nullptr || !FindFit(ItemDefaults->GetFootprint(false), true, FitSlot, bRotated))
+		{
+			UE_LOG(InventorySystemLog, Warning, TEXT("No room for the footprint of item '%s'."), *ItemID.ToString());
+			return false;
+		}
+
 		// Only create a new instance of the item if we don't have one in inventory.
 		UBaseItem *NewItem = NewObject<UBaseItem>(this, ItemTypeClass);
 		if (!NewItem || !NewItem->IsValidLowLevel())
@@ -238,9 +717,19 @@ bool UInventoryComponent::AddItem(const FName &ItemID, int32 NewStackSize, EItem
 		// Give item ownership to character
 		NewItem->GivenTo(CharOwner);
 
+		// Carried items show up in the inventory and may be equipped at any time; have their assets ready
+		UItemAssetStreamer *Streamer = UItemAssetStreamer::Get(this);
+		if (Streamer != nullptr)
+		{
+			Streamer->PrefetchItemAssets(NewItem);
+		}
+
 		// Create new item slot info
-		FItemSlotInfo newSlotInfo(ItemID, GetOpenSlotIndex(), NewStackSize, NewItem->MaxStackSize, ItemTypeClass, NewItem);
+		FItemSlotInfo newSlotInfo(ItemID, FitSlot, NewStackSize, NewItem->MaxStackSize, ItemTypeClass, NewItem);
+		newSlotInfo.bRotated = bRotated;
+		MergeDecay(newSlotInfo, NewStackSize, Decay, true);
 		SetInSlot(newSlotInfo);
+		UpdateDecay(Items.Num() - 1);
 		
 		// Broadcast the new item addition event to listeners
 		OnItemSlotAddedDelegate.Broadcast(newSlotInfo);
@@ -256,14 +745,17 @@ bool UInventoryComponent::AddItem(const FName &ItemID, int32 NewStackSize, EItem
 }
 
 // Called to add an item to a specific slot, if open.
-bool UInventoryComponent::AddItemToSlot(int32 SlotIndex, const FName &ItemID, int32 NewStackSize, EItemType ItemType, TSubclassOf<class UBaseItem> ItemTypeClass)
+bool UInventoryComponent::AddItemToSlot(int32 SlotIndex, const FName &ItemID, int32 NewStackSize, EItemType ItemType, TSubclassOf<class UBaseItem> ItemTypeClass, const FItemDecayState *Decay)
 {
-	int32 StackableItemsIndex = GetStackableItemsIndex(ItemID, NewStackSize);
+	int32 StackableItemsIndex = GetStackableItemsIndex(ItemID, NewStackSize, Decay);
 
 	// Are we adding to a slot, or creating a new?
 	if (StackableItemsIndex != INDEX_NONE)
 	{
+		MergeDecay(Items[StackableItemsIndex], NewStackSize, Decay, false);
 		Items[StackableItemsIndex].StackSize += NewStackSize;
+		AccumulateStack(Items[StackableItemsIndex], NewStackSize);
+		UpdateDecay(StackableItemsIndex);
 
 		return true;
 	}
@@ -277,16 +769,24 @@ bool UInventoryComponent::AddItemToSlot(int32 SlotIndex, const FName &ItemID, in
 			return false;
 		}
 
-		if (!IsSlotOpen(SlotIndex))
+		bool bRotated = false;
+		if (!CanPlaceAt(SlotIndex, NewItem->GetFootprint(false)))
 		{
 			UE_LOG(InventorySystemLog, Warning, TEXT("Failed to add item to specific slot '%d'; Now trying to add to an open slot..."),
 				SlotIndex);
-			SlotIndex = GetOpenSlotIndex();
+			if (!FindFit(NewItem->GetFootprint(false), true, SlotIndex, bRotated))
+			{
+				UE_LOG(InventorySystemLog, Warning, TEXT("No room for the footprint of item '%s'."), *ItemID.ToString());
+				return false;
+			}
 		}
 
 		// Create new item slot info
 		FItemSlotInfo newSlotInfo(ItemID, SlotIndex, NewStackSize, NewItem->MaxStackSize, ItemTypeClass, NewItem);
+		newSlotInfo.bRotated = bRotated;
+		MergeDecay(newSlotInfo, NewStackSize, Decay, true);
 		SetInSlot(newSlotInfo);
+		UpdateDecay(Items.Num() - 1);
 
 		// Broadcast the new item addition event to listeners
 		OnItemSlotAddedDelegate.Broadcast(newSlotInfo);
@@ -323,48 +823,386 @@ bool UInventoryComponent::DropItem(int32 Slot, int32 StackSize)
 	{
 		// We're not dropping the whole thing, only a part of the stacksize
 		Items[itemIndex].StackSize -= StackSize;
+		AccumulateStack(Items[itemIndex], -StackSize);
 		return true;
 	}
 	else
 	{
-		// Important! Make sure to "open up" the inventory slot
-		_openSlots.AddUnique(Items[itemIndex].SlotIndex);
-
 		// Make sure we dont drop an equipped weapon. "unequip" it first.
 		// TODO: Handle differently? Perhaps don't allow dropping equipped items..
 		if (EquippedWeapon != nullptr && Items[itemIndex].ItemTypeReference != nullptr
 			&& Items[itemIndex].ItemTypeReference->GetUniqueID() == EquippedWeapon->GetUniqueID())
 		{
 			UE_LOG(SurvivalDebugLog, Log, TEXT("Dropping equipped weapon. Removing reference."));
-			
-			ASurvivalCharacter *Owner = Cast<ASurvivalCharacter>(GetOwner());
-			if (Owner)
-			{
-				Owner->UnEquip();
-			}
+			UnEquipItem();
+		}
+
+		// Dropped weapons leave the hot-bar
+		if (Items[itemIndex].HasCapability(EItemCapability::IC_Weapon))
+		{
+			ClearHotBarSlot(FindHotBarSlot(static_cast<UBaseWeaponItem*>(Items[itemIndex].ItemTypeReference)));
 		}
 		
 		// Remove from our inventory
-		Items.RemoveAtSwap(itemIndex);
+		AccumulateStack(Items[itemIndex], -Items[itemIndex].StackSize);
+		RemoveItemAt(itemIndex);
 		return true;
 	}
 	return false;
 	
 }
 
-// Try to craft an item
-bool UInventoryComponent::CraftItem(int32 SlotA, int32 SlotB, UInventorySystemManager *InventorySystemManager)
+void UInventoryComponent::RemoveItemAt(int32 ItemIndex)
 {
-	if (InventorySystemManager == nullptr || !InventorySystemManager->IsValidLowLevel())
+	// Important! Make sure to "open up" the inventory slot
+	const int32 Slot = Items[ItemIndex].SlotIndex;
+	SetInGrid(Slot, GetFootprint(Items[ItemIndex]), false);
+	SlotStorage.Release(Slot);
+
+	Items.RemoveAtSwap(ItemIndex);
+	if (Items.IsValidIndex(ItemIndex) && SlotStorage.IsOccupied(Items[ItemIndex].SlotIndex))
 	{
-		UE_LOG(InventorySystemLog, Error, TEXT("Inventory system manager NULL. Cannot craft item."));
-		return false;
+		SlotStorage.ItemIndices[Items[ItemIndex].SlotIndex] = ItemIndex;
 	}
+}
 
-	int32 ItemAIndex = GetItemInfoIndexAtSlot(SlotA);
-	int32 ItemBIndex = GetItemInfoIndexAtSlot(SlotB);
+void UInventoryComponent::AccumulateStack(const FItemSlotInfo &SlotInfo, int32 Delta)
+{
+	if (Delta == 0)
+	{
+		return;
+	}
 
-	if (!Items.IsValidIndex(ItemAIndex) || !Items.IsValidIndex(ItemBIndex))
+	// Called with the record after its stack changed
+	if (SlotStorage.IsOccupied(SlotInfo.SlotIndex))
+	{
+		SlotStorage.StackSizes[SlotInfo.SlotIndex] = SlotInfo.StackSize;
+	}
+
+	int32 &Count = ItemCounts.FindOrAdd(SlotInfo.ItemID);
+	Count += Delta;
+	if (Count == 0)
+	{
+		ItemCounts.Remove(SlotInfo.ItemID);
+	}
+
+	if (SlotInfo.ItemTypeReference != nullptr)
+	{
+		TotalWeightGrams += (int64)SlotInfo.ItemTypeReference->GetWeightGrams() * Delta;
+	}
+	TotalWeight = TotalWeightGrams / 1000.0f;
+
+	if (WatchesByItem.Contains(SlotInfo.ItemID))
+	{
+		MarkWatchDirty(SlotInfo.ItemID);
+	}
+
+	// Full speed up to CarryCapacity, then down to MinEncumberedSpeedScale at MaxCarryWeight
+	const float Overload = FMath::GetRangePct(CarryCapacity, FMath::Max(MaxCarryWeight, CarryCapacity + KINDA_SMALL_NUMBER), TotalWeight);
+	EncumbranceSpeedScale = FMath::Lerp(1.0f, MinEncumberedSpeedScale, FMath::Clamp(Overload, 0.0f, 1.0f));
+}
+
+int32 UInventoryComponent::GetItemCount(FName ItemID) const
+{
+	const int32 *Count = ItemCounts.Find(ItemID);
+	return Count ? *Count : 0;
+}
+
+bool UInventoryComponent::VerifyTotals() const
+{
+	int64 WeightGrams = 0;
+	TMap<FName, int32> Counts;
+	for (const FItemSlotInfo &SlotInfo : Items)
+	{
+		if (SlotInfo.StackSize != 0)
+		{
+			Counts.FindOrAdd(SlotInfo.ItemID) += SlotInfo.StackSize;
+		}
+		if (SlotInfo.ItemTypeReference != nullptr)
+		{
+			WeightGrams += (int64)SlotInfo.ItemTypeReference->GetWeightGrams() * SlotInfo.StackSize;
+		}
+	}
+
+	bool bValid = true;
+	if (WeightGrams != TotalWeightGrams)
+	{
+		UE_LOG(InventorySystemLog, Error, TEXT("VerifyTotals : Weight is %lld g, running total says %lld g"), WeightGrams, TotalWeightGrams);
+		bValid = false;
+	}
+
+	if (Counts.Num() != ItemCounts.Num())
+	{
+		UE_LOG(InventorySystemLog, Error, TEXT("VerifyTotals : %d item IDs carried, running totals have %d"), Counts.Num(), ItemCounts.Num());
+		bValid = false;
+	}
+
+	for (auto It = Counts.CreateConstIterator(); It; ++It)
+	{
+		const int32 Running = GetItemCount(It.Key());
+		if (Running != It.Value())
+		{
+			UE_LOG(InventorySystemLog, Error, TEXT("VerifyTotals : %d of '%s' carried, running total says %d"), It.Value(), *It.Key().ToString(), Running);
+			bValid = false;
+		}
+	}
+
+	// The packed slot arrays must agree with the records
+	if (SlotStorage.NumOccupied != Items.Num())
+	{
+		UE_LOG(InventorySystemLog, Error, TEXT("VerifyTotals : %d items, slot storage has %d occupied slots"), Items.Num(), SlotStorage.NumOccupied);
+		bValid = false;
+	}
+
+	for (int32 i = 0; i < Items.Num(); i++)
+	{
+		const int32 Slot = Items[i].SlotIndex;
+		if (!SlotStorage.IsOccupied(Slot) || SlotStorage.ItemIndices[Slot] != i
+			|| SlotStorage.ItemIDs[Slot] != Items[i].ItemID || SlotStorage.StackSizes[Slot] != Items[i].StackSize)
+		{
+			UE_LOG(InventorySystemLog, Error, TEXT("VerifyTotals : Slot storage is out of step with item '%s' in slot %d"), *Items[i].ItemID.ToString(), Slot);
+			bValid = false;
+		}
+	}
+	return bValid;
+}
+
+bool UInventoryComponent::FInventoryWatch::Evaluate(int32 Carried) const
+{
+	switch (Condition)
+	{
+	case EInventoryWatchCondition::IWC_AtMost:
+		return Carried <= Count;
+	case EInventoryWatchCondition::IWC_Exactly:
+		return Carried == Count;
+	default:
+		return Carried >= Count;
+	}
+}
+
+int32 UInventoryComponent::AddWatch(FName ItemID, EInventoryWatchCondition Condition, int32 Count, FInventoryWatchDelegate Callback, bool bReportProgress)
+{
+	const int32 Handle = NextWatchHandle++;
+
+	FInventoryWatch &Watch = Watches.Add(Handle);
+	Watch.ItemID = ItemID;
+	Watch.Condition = Condition;
+	Watch.Count = Count;
+	Watch.bReportProgress = bReportProgress;
+	Watch.bSatisfied = false;
+	Watch.bInitial = true;
+	Watch.Callback = Callback;
+
+	WatchesByItem.FindOrAdd(ItemID).Add(Handle);
+	MarkWatchDirty(ItemID);
+	return Handle;
+}
+
+void UInventoryComponent::RemoveWatch(int32 WatchHandle)
+{
+	FInventoryWatch Watch;
+	if (!Watches.RemoveAndCopyValue(WatchHandle, Watch))
+	{
+		return;
+	}
+
+	TArray<int32> *ItemWatches = WatchesByItem.Find(Watch.ItemID);
+	if (ItemWatches != nullptr)
+	{
+		ItemWatches->RemoveSingleSwap(WatchHandle);
+		if (ItemWatches->Num() == 0)
+		{
+			WatchesByItem.Remove(Watch.ItemID);
+			LastWatchCounts.Remove(Watch.ItemID);
+		}
+	}
+}
+
+bool UInventoryComponent::IsWatchSatisfied(int32 WatchHandle) const
+{
+	const FInventoryWatch *Watch = Watches.Find(WatchHandle);
+	return Watch != nullptr && Watch->bSatisfied;
+}
+
+void UInventoryComponent::MarkWatchDirty(FName ItemID)
+{
+	DirtyWatchItems.AddUnique(ItemID);
+	if (!IsComponentTickEnabled())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UInventoryComponent::FlushWatches()
+{
+	SCOPE_CYCLE_COUNTER(STAT_InventoryWatchFlush);
+
+	struct FWatchNotification
+	{
+		int32 Handle;
+		FName ItemID;
+		int32 Carried;
+		bool bSatisfied;
+	};
+	TArray<FWatchNotification, TInlineAllocator<16>> Notifications;
+
+	// Work out the whole batch first; callbacks may add or remove watches, or change the inventory
+	for (const FName &ItemID : DirtyWatchItems)
+	{
+		const TArray<int32> *ItemWatches = WatchesByItem.Find(ItemID);
+		if (ItemWatches == nullptr)
+		{
+			continue;
+		}
+
+		const int32 Carried = GetItemCount(ItemID);
+		int32 &LastCount = LastWatchCounts.FindOrAdd(ItemID);
+		const bool bCountChanged = LastCount != Carried;
+		LastCount = Carried;
+
+		for (int32 Handle : *ItemWatches)
+		{
+			FInventoryWatch &Watch = Watches[Handle];
+			const bool bSatisfied = Watch.Evaluate(Carried);
+			if (Watch.bInitial || bSatisfied != Watch.bSatisfied || (Watch.bReportProgress && bCountChanged))
+			{
+				Watch.bInitial = false;
+				Watch.bSatisfied = bSatisfied;
+
+				FWatchNotification Notification;
+				Notification.Handle = Handle;
+				Notification.ItemID = ItemID;
+				Notification.Carried = Carried;
+				Notification.bSatisfied = bSatisfied;
+				Notifications.Add(Notification);
+			}
+		}
+	}
+	DirtyWatchItems.Reset();
+	SetComponentTickEnabled(false);
+
+	for (const FWatchNotification &Notification : Notifications)
+	{
+		// Removed by an earlier callback in this batch
+		const FInventoryWatch *Watch = Watches.Find(Notification.Handle);
+		if (Watch != nullptr)
+		{
+			Watch->Callback.ExecuteIfBound(Notification.Handle, Notification.ItemID, Notification.Carried, Notification.bSatisfied);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_InventoryWatchNotifications, Notifications.Num());
+}
+
+float UInventoryComponent::GetItemCondition(int32 Slot)
+{
+	const FItemSlotInfo *SlotInfo = GetItemInSlot(Slot);
+	return SlotInfo ? SlotInfo->Decay.GetCondition(GetDecayTime()) : 0.0f;
+}
+
+void UInventoryComponent::HandleDecayEvent(uint32 Serial)
+{
+	// Stale if the stack was dropped, merged or rescheduled since
+	const int32 ItemIndex = Items.IndexOfByPredicate([Serial](const FItemSlotInfo &SlotInfo) {
+		return SlotInfo.Decay.EventSerial == Serial;
+	});
+
+	if (ItemIndex != INDEX_NONE)
+	{
+		UpdateDecay(ItemIndex);
+	}
+}
+
+void UInventoryComponent::RebaseDecay()
+{
+	const float Now = GetDecayTime();
+	for (FItemSlotInfo &SlotInfo : Items)
+	{
+		SlotInfo.Decay.Rebase(Now);
+	}
+}
+
+float UInventoryComponent::GetDecayTime() const
+{
+	UWorld *World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0f;
+}
+
+void UInventoryComponent::MergeDecay(FItemSlotInfo &SlotInfo, int32 Count, const FItemDecayState *Incoming, bool bNewStack)
+{
+	const UBaseItem *Item = SlotInfo.ItemTypeReference;
+	if (Item == nullptr || (Item->DecayRate <= 0.0f && (Incoming == nullptr || !Incoming->IsDecaying())))
+	{
+		return;
+	}
+
+	const float Now = GetDecayTime();
+
+	// Items without a known state come in new
+	FItemDecayState IncomingState = Incoming ? *Incoming : FItemDecayState();
+	IncomingState.EventSerial = 0;
+	IncomingState.Start(Item->DecayRate, Now);
+
+	if (bNewStack)
+	{
+		SlotInfo.Decay = IncomingState;
+	}
+	else
+	{
+		SlotInfo.Decay = FItemDecayState::Merge(SlotInfo.Decay, SlotInfo.StackSize, IncomingState, Count, Item->DecayMergePolicy, Now);
+	}
+}
+
+void UInventoryComponent::UpdateDecay(int32 ItemIndex)
+{
+	if (!Items.IsValidIndex(ItemIndex) || Items[ItemIndex].ItemTypeReference == nullptr || !Items[ItemIndex].Decay.IsDecaying())
+	{
+		return;
+	}
+
+	FItemSlotInfo &SlotInfo = Items[ItemIndex];
+	FItemDecayState &Decay = SlotInfo.Decay;
+	const TArray<float> &Thresholds = SlotInfo.ItemTypeReference->DecayThresholds;
+
+	// Small tolerance, so an event due exactly now isn't missed to rounding and rescheduled forever
+	const float Condition = Decay.GetCondition(GetDecayTime()) - KINDA_SMALL_NUMBER;
+
+	const int32 FirstCrossed = Decay.ThresholdsPassed;
+	while (Decay.ThresholdsPassed < Thresholds.Num() && Condition <= Thresholds[Decay.ThresholdsPassed])
+	{
+		Decay.ThresholdsPassed++;
+	}
+	const int32 LastCrossed = Decay.ThresholdsPassed;
+
+	// Only the next threshold is ever scheduled; rescheduling makes any older event stale
+	Decay.EventSerial = 0;
+	UItemDecayScheduler *Scheduler = UItemDecayScheduler::Get(this);
+	if (Scheduler != nullptr && Decay.ThresholdsPassed < Thresholds.Num())
+	{
+		Decay.EventSerial = Scheduler->Schedule(this, Decay.GetTimeAtCondition(Thresholds[Decay.ThresholdsPassed]));
+	}
+
+	// Listeners may change the inventory, so they get a copy and come last
+	const FItemSlotInfo Reported = SlotInfo;
+	for (int32 Threshold = FirstCrossed; Threshold < LastCrossed; Threshold++)
+	{
+		OnItemDecayThresholdDelegate.Broadcast(Reported, Threshold);
+	}
+}
+
+// Try to craft an item
+bool UInventoryComponent::CraftItem(int32 SlotA, int32 SlotB, UInventorySystemManager *InventorySystemManager)
+{
+	if (InventorySystemManager == nullptr || !InventorySystemManager->IsValidLowLevel())
+	{
+		UE_LOG(InventorySystemLog, Error, TEXT("Inventory system manager NULL. Cannot craft item."));
+		return false;
+	}
+
+	int32 ItemAIndex = GetItemInfoIndexAtSlot(SlotA);
+	int32 ItemBIndex = GetItemInfoIndexAtSlot(SlotB);
+
+	if (!Items.IsValidIndex(ItemAIndex) || !Items.IsValidIndex(ItemBIndex))
 	{
 		UE_LOG(InventorySystemLog, Warning, TEXT("Failed to craft item. Either invalid index: [A:%d] - [B:%d]"), ItemAIndex, ItemBIndex);
 		return false;
@@ -396,8 +1234,9 @@ bool UInventoryComponent::CraftItem(int32 SlotA, int32 SlotB, UInventorySystemMa
 		int32 OldASlot = ItemA.SlotIndex; // We will place the new item in the first item slot. Does not matter really.
 		int32 OldBSlot = ItemB.SlotIndex;
 		// For now, drop the entire stack. We'll add stack-specific crafting later...
-		DropItem(ItemA.SlotIndex, INDEX_NONE);
-		DropItem(ItemB.SlotIndex, INDEX_NONE);
+		// Dropping A may move B's record, so go by slot.
+		DropItem(OldASlot, INDEX_NONE);
+		DropItem(OldBSlot, INDEX_NONE);
 
 		// Let blueprints in on the action for UI updates
 		DroppedCraftItems(OldASlot, OldBSlot);
@@ -411,134 +1250,415 @@ bool UInventoryComponent::CraftItem(int32 SlotA, int32 SlotB, UInventorySystemMa
 	}
 }
 
-// Swap slot positions
-bool UInventoryComponent::SwapSlot(int32 SlotA, int32 SlotB)
+bool UInventoryComponent::SortInventory(EInventorySortKey Key)
 {
-	// No need for a swap
-	if (IsSlotOpen(SlotA) && IsSlotOpen(SlotB))
+	SCOPE_CYCLE_COUNTER(STAT_InventorySort);
+
+	if (Items.Num() == 0)
 	{
 		return true;
 	}
-	else if (!IsValidSlot(SlotA) || !IsValidSlot(SlotB))
+
+	// Work out every item's sort key once
+	TArray<FString> Names;
+	TArray<FString> IDs;
+	TArray<InventorySort::FEntry> Entries;
+	Names.SetNum(Items.Num());
+	IDs.SetNum(Items.Num());
+	Entries.SetNumUninitialized(Items.Num());
+
+	for (int32 i = 0; i < Items.Num(); i++)
 	{
-		UE_LOG(InventorySystemLog, Warning, TEXT("SwapSlot : Either or both slot indices are out of range."));
-		return false;
+		const FItemSlotInfo &SlotInfo = Items[i];
+		const UBaseItem *Item = SlotInfo.ItemTypeReference;
+		Names[i] = Item ? Item->Name.ToString() : FString();
+		IDs[i] = SlotInfo.ItemID.ToString();
+
+		const uint64 NamePrefix = InventorySort::PackPrefix(Names[i]);
+		InventorySort::FEntry &Entry = Entries[i];
+		switch (Key)
+		{
+		case EInventorySortKey::ISK_Type:
+			Entry.Key = ((uint64)(Item ? (uint8)Item->GetItemType() : 0) << 56) | (NamePrefix >> 8);
+			break;
+		case EInventorySortKey::ISK_Value:
+			// Flip the sign bit so values order as unsigned, then invert for descending
+			Entry.Key = ((uint64)~((uint32)(Item ? Item->Value : 0) ^ 0x80000000u) << 32) | (NamePrefix >> 32);
+			break;
+		case EInventorySortKey::ISK_ItemID:
+			Entry.Key = InventorySort::PackPrefix(IDs[i]);
+			break;
+		default:
+			Entry.Key = NamePrefix;
+			break;
+		}
+		// Fuller stacks first
+		Entry.Tiebreak = ~(uint32)FMath::Max(SlotInfo.StackSize, 0);
+		Entry.ItemIndex = i;
 	}
 
-	int32 ItemAIndex = INDEX_NONE, ItemBIndex = INDEX_NONE;
+	InventorySort::RadixSort(Entries);
+
+	// Keys only hold string prefixes. Runs of equal keys are finished with full string compares;
+	// they are short, so insertion sort.
+	const bool bIDFirst = Key == EInventorySortKey::ISK_ItemID;
+	auto Less = [&](const InventorySort::FEntry &A, const InventorySort::FEntry &B) {
+		const FString &PrimaryA = bIDFirst ? IDs[A.ItemIndex] : Names[A.ItemIndex];
+		const FString &PrimaryB = bIDFirst ? IDs[B.ItemIndex] : Names[B.ItemIndex];
+		int32 Compare = PrimaryA.Compare(PrimaryB, ESearchCase::IgnoreCase);
+		if (Compare == 0)
+		{
+			const FString &SecondaryA = bIDFirst ? Names[A.ItemIndex] : IDs[A.ItemIndex];
+			const FString &SecondaryB = bIDFirst ? Names[B.ItemIndex] : IDs[B.ItemIndex];
+			Compare = SecondaryA.Compare(SecondaryB, ESearchCase::IgnoreCase);
+		}
+		return Compare != 0 ? Compare < 0 : A.Tiebreak < B.Tiebreak;
+	};
 
-	// TODO: Too much?
-	if (IsSlotOpen(SlotA) || IsSlotOpen(SlotB))
+	for (int32 RunStart = 0; RunStart < Entries.Num();)
 	{
-		// One is occupied, but the other is open - so we must do some additional work
-		if (IsSlotOpen(SlotA))
+		int32 RunEnd = RunStart + 1;
+		while (RunEnd < Entries.Num() && Entries[RunEnd].Key == Entries[RunStart].Key)
 		{
-			ItemBIndex = GetItemInfoIndexAtSlot(SlotB); // Get index for the item for the occupied slot
-			if (Items.IsValidIndex(ItemBIndex))
-			{
-				Items[ItemBIndex].SlotIndex = SlotA; // Slot A is open, so move this item there
-				_openSlots.Remove(SlotA); // "Close" the moved-to slot
-				_openSlots.AddUnique(SlotB); // Open the previously occupied slot
+			RunEnd++;
+		}
 
-				return true;
-			}
-			else
+		for (int32 i = RunStart + 1; i < RunEnd; i++)
+		{
+			const InventorySort::FEntry Entry = Entries[i];
+			int32 j = i;
+			while (j > RunStart && Less(Entry, Entries[j - 1]))
 			{
-				UE_LOG(InventorySystemLog, Warning, TEXT("SwapSlot : Item B index is invalid."));
-				return false;
+				Entries[j] = Entries[j - 1];
+				j--;
 			}
+			Entries[j] = Entry;
 		}
-		else
+		RunStart = RunEnd;
+	}
+
+	// Pack the grid in sorted order, unrotated where possible
+	FInventoryGrid NewGrid;
+	NewGrid.Init(Rows, Columns);
+
+	TArray<FItemSlotInfo> Sorted;
+	Sorted.Reserve(Items.Num());
+	for (const InventorySort::FEntry &Entry : Entries)
+	{
+		FItemSlotInfo SlotInfo = Items[Entry.ItemIndex];
+		SlotInfo.bRotated = false;
+
+		int32 X, Y;
+		bool bRotated;
+		if (!NewGrid.FindFit(GetFootprint(SlotInfo), true, X, Y, bRotated))
 		{
-			ItemAIndex = GetItemInfoIndexAtSlot(SlotA); // Get index for the item for the occupied slot
-			if (Items.IsValidIndex(ItemAIndex))
-			{
-				Items[ItemAIndex].SlotIndex = SlotB; // Slot B is open, move item over
-				_openSlots.Remove(SlotB); // Remove from open slots list
-				_openSlots.AddUnique(SlotA); // Add the previously occupied slot to open slots list
+			UE_LOG(InventorySystemLog, Warning, TEXT("SortInventory : The items don't pack in sorted order. Nothing changed."));
+			return false;
+		}
 
-				return true;
-			}
-			else
+		SlotInfo.bRotated = bRotated;
+		SlotInfo.SlotIndex = Y * Columns + X;
+		NewGrid.Set(X, Y, GetFootprint(SlotInfo), true);
+		Sorted.Add(SlotInfo);
+	}
+
+	// Apply as one change
+	Exchange(Items, Sorted);
+	Grid = NewGrid;
+	SlotStorage.Rebuild(Items, Slots);
+
+	OnInventoryRearrangedDelegate.Broadcast();
+	return true;
+}
+
+int32 UInventoryComponent::ConsolidateStacks()
+{
+	SCOPE_CYCLE_COUNTER(STAT_InventoryConsolidate);
+
+	// Walk the slots in order so items gather in the first stacks.
+	// Per item ID, the stack currently taking items; it only moves forward.
+	TMap<FName, int32> Receivers;
+	TArray<int32> Emptied;
+	TArray<int32> ReceiverSlots;
+	const float Now = GetDecayTime();
+
+	for (int32 Slot = 0; Slot < SlotStorage.GetNumSlots(); Slot++)
+	{
+		const int32 ItemIndex = SlotStorage.ItemIndices[Slot];
+		if (ItemIndex == INDEX_NONE || SlotStorage.MaxStackSizes[Slot] <= 1
+			|| (SlotStorage.Capabilities[Slot] & ItemCapabilityBit(EItemCapability::IC_Weapon)) != 0)
+		{
+			continue;
+		}
+
+		FItemSlotInfo &Donor = Items[ItemIndex];
+		int32 *ReceiverIndex = Receivers.Find(Donor.ItemID);
+		if (ReceiverIndex == nullptr || Items[*ReceiverIndex].StackSize >= Items[*ReceiverIndex].MaxStackSize)
+		{
+			if (Donor.StackSize < Donor.MaxStackSize)
 			{
-				UE_LOG(InventorySystemLog, Warning, TEXT("SwapSlot : Item A index is invalid."));
-				return false;
+				Receivers.Add(Donor.ItemID, ItemIndex);
 			}
+			continue;
+		}
+
+		FItemSlotInfo &Receiver = Items[*ReceiverIndex];
+		const UBaseItem *Item = Receiver.ItemTypeReference;
+		if (Item != nullptr && !Item->CanMergeDecay(Receiver.Decay, Donor.Decay, Now))
+		{
+			continue;
+		}
+
+		const int32 Moved = FMath::Min(Receiver.MaxStackSize - Receiver.StackSize, Donor.StackSize);
+		MergeDecay(Receiver, Moved, &Donor.Decay, false);
+		Receiver.StackSize += Moved;
+		Donor.StackSize -= Moved;
+		ReceiverSlots.AddUnique(Receiver.SlotIndex);
+
+		if (Donor.StackSize <= 0)
+		{
+			Emptied.Add(ItemIndex);
+		}
+		else
+		{
+			// The receiver is full; what's left of the donor takes the next items
+			*ReceiverIndex = ItemIndex;
 		}
 	}
-	else
+
+	// Counts and weight are unchanged, so no AccumulateStack. Remove from the back so
+	// RemoveAtSwap never moves a record that is still to be removed.
+	Emptied.Sort([](int32 A, int32 B) { return A > B; });
+	for (int32 ItemIndex : Emptied)
+	{
+		RemoveItemAt(ItemIndex);
+	}
+	SlotStorage.Rebuild(Items, Slots);
+
+	// Merged stacks have a new decay state; schedule their next threshold
+	for (int32 Slot : ReceiverSlots)
 	{
-		// Both are occupied, simply swap index
-		ItemAIndex = GetItemInfoIndexAtSlot(SlotA);
-		ItemBIndex = GetItemInfoIndexAtSlot(SlotB);
+		UpdateDecay(GetItemInfoIndexAtSlot(Slot));
+	}
+
+	if (ReceiverSlots.Num() > 0)
+	{
+		OnInventoryRearrangedDelegate.Broadcast();
+	}
+	return Emptied.Num();
+}
 
-		if (!Items.IsValidIndex(ItemAIndex) || !Items.IsValidIndex(ItemBIndex))
+// Swap slot positions
+bool UInventoryComponent::SwapSlot(int32 SlotA, int32 SlotB)
+{
+	if (!IsValidSlot(SlotA) || !IsValidSlot(SlotB))
+	{
+		UE_LOG(InventorySystemLog, Warning, TEXT("SwapSlot : Either or both slot indices are out of range."));
+		return false;
+	}
+
+	const int32 ItemAIndex = GetItemInfoIndexAtSlot(SlotA);
+	const int32 ItemBIndex = GetItemInfoIndexAtSlot(SlotB);
+
+	// No need for a swap
+	if (SlotA == SlotB || (ItemAIndex == INDEX_NONE && ItemBIndex == INDEX_NONE))
+	{
+		return true;
+	}
+
+	const FIntPoint FootprintA = Items.IsValidIndex(ItemAIndex) ? GetFootprint(Items[ItemAIndex]) : FIntPoint::ZeroValue;
+	const FIntPoint FootprintB = Items.IsValidIndex(ItemBIndex) ? GetFootprint(Items[ItemBIndex]) : FIntPoint::ZeroValue;
+
+	// Lift both items off the grid, then try to put each down at the other's slot
+	if (ItemAIndex != INDEX_NONE)
+	{
+		SetInGrid(SlotA, FootprintA, false);
+	}
+	if (ItemBIndex != INDEX_NONE)
+	{
+		SetInGrid(SlotB, FootprintB, false);
+	}
+
+	bool bFits = true;
+	if (ItemAIndex != INDEX_NONE)
+	{
+		bFits = CanPlaceAt(SlotB, FootprintA);
+		if (bFits)
 		{
-			UE_LOG(InventorySystemLog, Warning, TEXT("SwapSlot : Either itemA/B index is invalid, cannot swap existing items."));
-			return false;
+			SetInGrid(SlotB, FootprintA, true);
+		}
+	}
+	if (bFits && ItemBIndex != INDEX_NONE)
+	{
+		bFits = CanPlaceAt(SlotA, FootprintB);
+		if (bFits)
+		{
+			SetInGrid(SlotA, FootprintB, true);
+		}
+		else if (ItemAIndex != INDEX_NONE)
+		{
+			SetInGrid(SlotB, FootprintA, false);
+		}
+	}
+
+	if (!bFits)
+	{
+		// Put everything back where it was
+		if (ItemAIndex != INDEX_NONE)
+		{
+			SetInGrid(SlotA, FootprintA, true);
+		}
+		if (ItemBIndex != INDEX_NONE)
+		{
+			SetInGrid(SlotB, FootprintB, true);
 		}
 
-		// Swap slots
+		UE_LOG(InventorySystemLog, Warning, TEXT("SwapSlot : No room to swap slot %d and %d."), SlotA, SlotB);
+		return false;
+	}
+
+	if (ItemAIndex != INDEX_NONE)
+	{
 		Items[ItemAIndex].SlotIndex = SlotB;
+	}
+	if (ItemBIndex != INDEX_NONE)
+	{
 		Items[ItemBIndex].SlotIndex = SlotA;
+	}
+	SlotStorage.Swap(SlotA, SlotB);
 
-		return true;
+	return true;
+}
+
+bool UInventoryComponent::RotateItem(int32 Slot)
+{
+	const int32 ItemIndex = GetItemInfoIndexAtSlot(Slot);
+	if (!Items.IsValidIndex(ItemIndex))
+	{
+		UE_LOG(InventorySystemLog, Warning, TEXT("RotateItem : No item in slot %d."), Slot);
+		return false;
+	}
+
+	const FIntPoint Footprint = GetFootprint(Items[ItemIndex]);
+	const FIntPoint Rotated(Footprint.Y, Footprint.X);
+
+	SetInGrid(Slot, Footprint, false);
+	if (!CanPlaceAt(Slot, Rotated))
+	{
+		SetInGrid(Slot, Footprint, true);
+		return false;
+	}
+
+	SetInGrid(Slot, Rotated, true);
+	Items[ItemIndex].bRotated = !Items[ItemIndex].bRotated;
+	return true;
+}
+
+bool UInventoryComponent::FindFit(FIntPoint Footprint, bool bAllowRotation, int32 &OutSlot, bool &bOutRotated) const
+{
+	int32 X, Y;
+	if (!Grid.FindFit(Footprint, bAllowRotation, X, Y, bOutRotated))
+	{
+		OutSlot = INDEX_NONE;
+		return false;
 	}
+
+	OutSlot = Y * Columns + X;
+	return true;
+}
+
+bool UInventoryComponent::CanPlaceAt(int32 Slot, FIntPoint Footprint) const
+{
+	return IsValidSlot(Slot) && Grid.CanPlace(Slot % Columns, Slot / Columns, Footprint);
+}
+
+FIntPoint UInventoryComponent::GetFootprint(const FItemSlotInfo &SlotInfo) const
+{
+	const UBaseItem *Item = SlotInfo.ItemTypeReference;
+	if (Item == nullptr && SlotInfo.ItemTypeClass != nullptr)
+	{
+		Item = SlotInfo.ItemTypeClass->GetDefaultObject<UBaseItem>();
+	}
+	return Item ? Item->GetFootprint(SlotInfo.bRotated) : FIntPoint(1, 1);
 }
 
 // Called to resize the inventory
 bool UInventoryComponent::ResizeInventory(int32 NewRows, int32 NewColumns)
 {
-	if (NewRows * NewColumns < Items.Num())
+	if (NewRows <= 0 || NewColumns <= 0 || NewColumns > FInventoryGrid::MaxColumns)
 	{
-		// We can't discard items that occupy slots
-		UE_LOG(InventorySystemLog, Warning, TEXT("Can't downsize inventory; slots beyond new size are occupied."));
+		UE_LOG(InventorySystemLog, Warning, TEXT("ResizeInventory : Invalid size %d x %d."), NewRows, NewColumns);
 		return false;
 	}
-	int32 oldSlotCount = Slots;
-	// Resize slots
-	Rows = NewRows;
-	Columns = NewColumns;
-	Slots = Rows * Columns;
 
-	// TODO: Go through _openSlots and make sure
-	// we only open new slots from the resize
-	TArray<int32> OccupiedSlots;
-	for (const FItemSlotInfo &SlotInfo : Items)
+	// Lay the items out on a new grid first, so a failed resize changes nothing.
+	// Items that still fit where they are stay; the rest are packed in, in slot order.
+	FInventoryGrid NewGrid;
+	NewGrid.Init(NewRows, NewColumns);
+
+	TArray<int32> Order;
+	Order.Reserve(Items.Num());
+	for (int32 i = 0; i < Items.Num(); i++)
 	{
-		OccupiedSlots.Add(SlotInfo.SlotIndex);
+		Order.Add(i);
 	}
-	OccupiedSlots.Sort();
+	Order.Sort([this](int32 A, int32 B) {
+		return Items[A].SlotIndex < Items[B].SlotIndex;
+	});
+
+	TArray<int32> NewSlots;
+	TArray<bool> NewRotated;
+	NewSlots.Init(INDEX_NONE, Items.Num());
+	NewRotated.Init(false, Items.Num());
 
-	// If we're just adding new slots we can start at the end
-	if (Slots > oldSlotCount)
+	for (int32 i : Order)
 	{
-		for (int i = oldSlotCount; i < Slots; i++)
+		const int32 X = Items[i].SlotIndex % Columns;
+		const int32 Y = Items[i].SlotIndex / Columns;
+		const FIntPoint Footprint = GetFootprint(Items[i]);
+		if (NewGrid.CanPlace(X, Y, Footprint))
 		{
-			_openSlots.AddUnique(i);
+			NewGrid.Set(X, Y, Footprint, true);
+			NewSlots[i] = Y * NewColumns + X;
+			NewRotated[i] = Items[i].bRotated;
 		}
-		return true;
 	}
-	else
+
+	for (int32 i : Order)
 	{
-		// We are downsizing, simply open all slots and set items to
-		// new slots in the order they were
-		_openSlots.Empty();
-		for (int i = 0; i < Slots; i++)
+		if (NewSlots[i] != INDEX_NONE)
 		{
-			_openSlots.Add(i);
+			continue;
 		}
-		// Sort by slotindex to get the same order in the inventory
-		Items.Sort([](const FItemSlotInfo &SlotA, const FItemSlotInfo &SlotB) {
-			return SlotA.SlotIndex < SlotB.SlotIndex;
-		});
-		// Occupy the slots necessary and remove the occupied slot.
-		for (int i = 0; i < Items.Num(); i++)
+
+		// Try the item unrotated first
+		const FIntPoint Footprint = GetFootprint(Items[i]);
+		const FIntPoint Unrotated = Items[i].bRotated ? FIntPoint(Footprint.Y, Footprint.X) : Footprint;
+		int32 X, Y;
+		bool bRotated;
+		if (!NewGrid.FindFit(Unrotated, true, X, Y, bRotated))
 		{
-			Items[i].SlotIndex = _openSlots[i];
-			_openSlots.RemoveAt(i);
+			// We can't discard items that occupy slots
+			UE_LOG(InventorySystemLog, Warning, TEXT("Can't resize inventory to %d x %d; the items don't fit."), NewRows, NewColumns);
+			return false;
 		}
 
-		return true;
+		NewGrid.Set(X, Y, bRotated ? FIntPoint(Unrotated.Y, Unrotated.X) : Unrotated, true);
+		NewSlots[i] = Y * NewColumns + X;
+		NewRotated[i] = bRotated;
 	}
+
+	Rows = NewRows;
+	Columns = NewColumns;
+	Slots = Rows * Columns;
+	Grid = NewGrid;
+
+	for (int32 i = 0; i < Items.Num(); i++)
+	{
+		Items[i].SlotIndex = NewSlots[i];
+		Items[i].bRotated = NewRotated[i];
+	}
+	SlotStorage.Rebuild(Items, Slots);
+
+	return true;
 }
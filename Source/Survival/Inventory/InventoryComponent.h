@@ -3,6 +3,9 @@
 #pragma once
 
 #include "BaseItem.h"
+#include "ItemNames.h"
+#include "InventoryGrid.h"
+#include "InventorySearchIndex.h"
 #include "Components/ActorComponent.h"
 #include "InventoryComponent.generated.h"
 
@@ -33,6 +36,28 @@ struct FItemSlotInfo
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
 	class UBaseItem *ItemTypeReference;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
+	FItemDecayState Decay;
+
+	// Turned 90 degrees in the grid; the footprint's width and height are swapped
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
+	bool bRotated;
+
+	// EItemCapability bits of ItemTypeClass, so dispatch and filtering don't go through reflection
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (Bitmask, BitmaskEnum = "EItemCapability"))
+	uint8 Capabilities;
+
+	FORCEINLINE bool HasCapability(EItemCapability Capability) const
+	{
+		return (Capabilities & ItemCapabilityBit(Capability)) != 0;
+	}
+
+	// Empty or invalid slots have no slot index
+	FORCEINLINE bool IsValid() const
+	{
+		return SlotIndex != INDEX_NONE;
+	}
+
 	bool ItemTypeClassIsValid();
 	bool ItemTypeRefIsValid();
 
@@ -43,12 +68,15 @@ struct FItemSlotInfo
 
 	FItemSlotInfo()
 	{
-		ItemID = FName(TEXT("INVALID"));
+		// Copies the pre-interned name, no name table lookup
+		ItemID = ItemNames::Invalid;
 		SlotIndex = INDEX_NONE;
 		StackSize = 0;
 		MaxStackSize = 0;
 		ItemTypeClass = nullptr;
 		ItemTypeReference = nullptr;
+		Capabilities = 0;
+		bRotated = false;
 	}
 
 	FItemSlotInfo(const FName &ItemID, int32 Slot, int32 StackSize, int32 MaxStackSize,
@@ -60,19 +88,129 @@ struct FItemSlotInfo
 		this->MaxStackSize = MaxStackSize;
 		this->ItemTypeClass = ItemTypeClass;
 		this->ItemTypeReference = ItemTypeReference;
+		this->Capabilities = UBaseItem::GetClassCapabilities(ItemTypeClass);
+		this->bRotated = false;
 	}
 
 	static const FItemSlotInfo InvalidSlot;
 };
 
 
+/**
+* Quick slot with a weapon that is ready to be drawn.
+* The weapon actor is spawned when the weapon is assigned, and only hidden while holstered.
+*/
+USTRUCT(BlueprintType)
+struct FHotBarSlot
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = HotBar)
+	class UBaseWeaponItem *Weapon;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = HotBar)
+	class ABaseWeaponActor *WeaponActor;
+
+	FHotBarSlot()
+	{
+		Weapon = nullptr;
+		WeaponActor = nullptr;
+	}
+};
+
+
+/**
+* Hot per-slot data of an inventory in packed arrays indexed by slot index, so scans
+* (stack lookups, ammo search, slot lookups) only touch the fields they test.
+* The full records (class, decay) stay in UInventoryComponent::Items, which is also what
+* Blueprints and the UI read; ItemIndices maps a slot to its record.
+* Kept in step with Items by the inventory component.
+*/
+struct FInventorySlotStorage
+{
+	TArray<FName> ItemIDs;
+	TArray<int32> StackSizes;
+	TArray<int32> MaxStackSizes;
+	// EItemCapability bits
+	TArray<uint8> Capabilities;
+	// Item instances. Kept alive by Items.
+	TArray<class UBaseItem*> Definitions;
+	// Index into Items, INDEX_NONE for an open slot
+	TArray<int32> ItemIndices;
+
+	int32 NumOccupied;
+
+	// Item names by slot. Only kept up to date once something has searched.
+	FInventorySearchIndex SearchIndex;
+
+	FInventorySlotStorage()
+		: NumOccupied(0)
+	{}
+
+	FORCEINLINE int32 GetNumSlots() const
+	{
+		return ItemIndices.Num();
+	}
+
+	FORCEINLINE bool IsOccupied(int32 Slot) const
+	{
+		return ItemIndices.IsValidIndex(Slot) && ItemIndices[Slot] != INDEX_NONE;
+	}
+
+	// Grow or shrink to NumSlots. New slots are open.
+	void SetNumSlots(int32 NumSlots);
+
+	// Put the record at ItemIndex in its slot
+	void Occupy(const FItemSlotInfo &SlotInfo, int32 ItemIndex);
+
+	void Release(int32 Slot);
+
+	// Swap the contents of two slots, open or not
+	void Swap(int32 SlotA, int32 SlotB);
+
+	// Start over from Items, e.g. after the records were reordered
+	void Rebuild(const TArray<FItemSlotInfo> &Items, int32 NumSlots);
+};
+
+
+/**
+* Count predicate of an inventory watch (@see UInventoryComponent::AddWatch)
+*/
+UENUM(BlueprintType)
+enum class EInventoryWatchCondition : uint8
+{
+	IWC_AtLeast		UMETA(DisplayName = "At Least"),
+	IWC_AtMost		UMETA(DisplayName = "At Most"),
+	IWC_Exactly		UMETA(DisplayName = "Exactly")
+};
+
+/**
+* Order of UInventoryComponent::SortInventory. Ties are broken by name, then ItemID, then fuller stacks first.
+*/
+UENUM(BlueprintType)
+enum class EInventorySortKey : uint8
+{
+	ISK_Type		UMETA(DisplayName = "Type"),
+	ISK_Value		UMETA(DisplayName = "Value"),		// Most valuable first
+	ISK_Name		UMETA(DisplayName = "Name"),
+	ISK_ItemID		UMETA(DisplayName = "Item ID")
+};
+
+// Watch handle, watched ItemID, number carried, whether the watch condition holds
+DECLARE_DELEGATE_FourParams(FInventoryWatchDelegate, int32, FName, int32, bool);
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FItemSlotAddedSignature, const FItemSlotInfo&, NewSlotInfo);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FInventoryRearrangedSignature);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FItemDecayThresholdSignature, const FItemSlotInfo&, SlotInfo, int32, ThresholdIndex);
 
 /**
 * Inventory component for any character that need an inventory.
 * Handles all inventory specific functionality except pickup logic,
 * which is first handled in the SurvivalCharacter class (@see SurvivalCharacter::HandlePickupItem)
 *
+* The slots form a Rows x Columns grid, slot index Row * Columns + Column. Items cover
+* a footprint of cells (@see UBaseItem::GridWidth) and sit in the slot of its top left cell.
+*
 * Remember, inventory slots and item indices are different. The items are stored as a simple
 * TArray, which has ordered and shuffeling indices. The slot indices however are used
 * to swap places in the UI and such. Therefore SlotIndex and ItemIndex must not be
@@ -104,12 +242,45 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
 	class UBaseWeaponItem *EquippedWeapon;
 
+	// Number of quick slots
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = HotBar)
+	int32 HotBarSize;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = HotBar)
+	TArray<FHotBarSlot> HotBar;
+
+	// Time the last hot-bar swap took
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = HotBar)
+	float LastSwapMicroseconds;
+
+	// Weight in kg that can be carried at full speed
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Weight)
+	float CarryCapacity;
+
+	// Weight in kg at which speed bottoms out at MinEncumberedSpeedScale
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Weight)
+	float MaxCarryWeight;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Weight, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float MinEncumberedSpeedScale;
+
+	// Weight of everything in the inventory, in kg. Kept up to date as stacks change.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Weight)
+	float TotalWeight;
+
+	// Movement speed multiplier for TotalWeight. Read by USurvivalCharacterMovement.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Weight)
+	float EncumbranceSpeedScale;
+
 public:	
 	// Sets default values for this component's properties
 	UInventoryComponent();
 
 	// Called when the game starts
 	virtual void BeginPlay() override;
+
+	// Called when the game ends or the owner is destroyed
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	// Called every frame
 	virtual void TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction ) override;
@@ -123,14 +294,23 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Inventory Events")
 	FItemSlotAddedSignature OnItemSlotAddedDelegate;
 
+	// Many slots changed at once (sort, stack all). Refresh the whole inventory view.
+	UPROPERTY(BlueprintAssignable, Category = "Inventory Events")
+	FInventoryRearrangedSignature OnInventoryRearrangedDelegate;
+
+	// A stack crossed one of its item's decay thresholds (@see UBaseItem::DecayThresholds)
+	UPROPERTY(BlueprintAssignable, Category = "Inventory Events")
+	FItemDecayThresholdSignature OnItemDecayThresholdDelegate;
+
 
 	///////////////////////////////////////////////////////////////
 	// Inventory handling
 
 
-	// Adds a regular item to the inventory or to the stack of a similar item
-	bool AddItem(const FName &ItemID, int32 NewStackSize, EItemType ItemType, TSubclassOf<class UBaseItem> ItemTypeClass);
-	bool AddItemToSlot(int32 SlotIndex, const FName &ItemID, int32 NewStackSize, EItemType ItemType, TSubclassOf<class UBaseItem> ItemTypeClass);
+	// Adds a regular item to the inventory or to the stack of a similar item. Decay is the condition
+	// the items come in at (e.g. from a pickup); nullptr adds them new.
+	bool AddItem(const FName &ItemID, int32 NewStackSize, EItemType ItemType, TSubclassOf<class UBaseItem> ItemTypeClass, const FItemDecayState *Decay = nullptr);
+	bool AddItemToSlot(int32 SlotIndex, const FName &ItemID, int32 NewStackSize, EItemType ItemType, TSubclassOf<class UBaseItem> ItemTypeClass, const FItemDecayState *Decay = nullptr);
 
 	// Use an item
 	bool UseItem(int32 Slot, class ASurvivalCharacter *Target);
@@ -138,26 +318,120 @@ public:
 	// Equips an item
 	void EquipItem(int32 Slot, class ASurvivalCharacter *Target);
 
-	// UnEquips the equipped item, if any
+	// UnEquips the equipped item, if any. The only unequip path; the character is notified from here.
 	void UnEquipItem();
 
+	///////////////////////////////////////////////////////////////
+	// Hot-bar
+
+	// Put the weapon in inventory Slot in a quick slot, spawning its weapon actor up front
+	UFUNCTION(BlueprintCallable, Category = HotBar)
+	bool AssignHotBarSlot(int32 HotBarSlot, int32 Slot);
+
+	UFUNCTION(BlueprintCallable, Category = HotBar)
+	void ClearHotBarSlot(int32 HotBarSlot);
+
+	// Draw the weapon in a quick slot. Only flips visibility and weapon state.
+	UFUNCTION(BlueprintCallable, Category = HotBar)
+	bool SelectHotBarSlot(int32 HotBarSlot);
+
+	// Quick slot holding Weapon, or INDEX_NONE
+	int32 FindHotBarSlot(const class UBaseWeaponItem *Weapon) const;
+
 	// Drop an item or the stacksize of an item
 	bool DropItem(int32 Slot, int32 StackSize);
 
 	// Craft an item out of two others, if a recipe matches
 	bool CraftItem(int32 SlotA, int32 SlotB, class UInventorySystemManager *InventorySystemManager);
 
-	// Swap places in the inventory
+	// Swap places in the inventory. Fails if either item doesn't fit at the other's place.
 	bool SwapSlot(int32 SlotA, int32 SlotB);
 
+	// Turn the item in Slot 90 degrees in place, if there is room
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool RotateItem(int32 Slot);
+
+	// Slot for the top left cell of the first free place for Footprint, trying it rotated too if
+	// bAllowRotation. Returns false if it fits nowhere.
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool FindFit(FIntPoint Footprint, bool bAllowRotation, int32 &OutSlot, bool &bOutRotated) const;
+
+	// Whether Footprint fits with its top left cell in Slot
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool CanPlaceAt(int32 Slot, FIntPoint Footprint) const;
+
+	// Cells the item in SlotInfo covers, with its rotation
+	FIntPoint GetFootprint(const FItemSlotInfo &SlotInfo) const;
+
 	// Reloads the equipped weapon
 	bool ReloadEquippedWeapon();
 
+	///////////////////////////////////////////////////////////////
+	// Sorting
+
+	// Reorder the inventory by Key and pack it from the first slot. The new layout is worked out
+	// up front and applied in one go, with one OnInventoryRearrangedDelegate broadcast.
+	// Returns false, changing nothing, if the items' footprints don't pack in that order.
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool SortInventory(EInventorySortKey Key);
+
+	// Merge partial stacks of the same item into as few stacks as possible, in one pass.
+	// Returns the number of slots freed.
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	int32 ConsolidateStacks();
+
+	///////////////////////////////////////////////////////////////
+	// Decay
+
+	// Condition of the item in Slot right now, 100 for items that don't decay
+	UFUNCTION(BlueprintCallable, Category = Decay)
+	float GetItemCondition(int32 Slot);
+
+	// Called by the decay scheduler when the stack with this event serial may have crossed a threshold
+	void HandleDecayEvent(uint32 Serial);
+
+	// Fold the decay so far into every stack's base condition, e.g. before saving
+	void RebaseDecay();
+
+	///////////////////////////////////////////////////////////////
+	// Totals
+
+	// Number of items with ItemID across all stacks
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	int32 GetItemCount(FName ItemID) const;
+
+	// Recompute the totals from Items and compare with the running ones. Logs and returns false on a mismatch.
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool VerifyTotals() const;
+
+	///////////////////////////////////////////////////////////////
+	// Watches
+
+	// Have Callback told when the number of ItemID carried starts or stops meeting Condition Count
+	// (quests, objectives). With bReportProgress it is told about every change of the number.
+	// Notifications are batched and delivered once per frame; the first one reports the current state.
+	// Returns a handle for RemoveWatch.
+	int32 AddWatch(FName ItemID, EInventoryWatchCondition Condition, int32 Count, FInventoryWatchDelegate Callback, bool bReportProgress = false);
+
+	void RemoveWatch(int32 WatchHandle);
+
+	// Whether the watch's condition held at the last notification
+	bool IsWatchSatisfied(int32 WatchHandle) const;
+
 
 	///////////////////////////////////////////////////////////////
 	// Inventory utilities to make our lives easier.. 
 
 
+	// Slots of the items with a word in their localized name starting with each word of Query, e.g. "ap" or
+	// "red ap" for "Red Apple". Case insensitive. All occupied slots for an empty query. Returns the number found.
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	int32 SearchItems(const FString &Query, TArray<int32> &OutSlots);
+
+	// Slots of the items that have every capability in CapabilityMask (EItemCapability bits). Returns the number found.
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	int32 FilterByCapabilities(UPARAM(meta = (Bitmask, BitmaskEnum = "EItemCapability")) int32 CapabilityMask, TArray<int32> &OutSlots) const;
+
 	// Tries to find a specific ammo type in the inventory. Useful for live-reload
 	int32 FindAmmoItemInSlot(EAmmoType AmmoType);
 
@@ -165,35 +439,35 @@ public:
 	FORCEINLINE void SetInSlot(const FItemSlotInfo &SlotInfo)
 	{
 		// Add item to inventory
-		Items.Add(SlotInfo);
+		const int32 ItemIndex = Items.Add(SlotInfo);
+		AccumulateStack(SlotInfo, SlotInfo.StackSize);
+		SlotStorage.Occupy(SlotInfo, ItemIndex);
 
-		// Make sure to remove the now occupied slot index from the open slots array
-		// This will be added back when the item is removed/depleted in the inventory
-		_openSlots.Remove(SlotInfo.SlotIndex);
+		// Take the cells of the footprint. They are freed when the item is removed/depleted in the inventory
+		SetInGrid(SlotInfo.SlotIndex, GetFootprint(SlotInfo), true);
 	}
 
 	// Utility to get an open inventory slot index
 	FORCEINLINE int32 GetOpenSlotIndex()
 	{
 		// If no slots are available, we return invalid index
-		if (_openSlots.Num() == 0)
+		int32 X, Y;
+		if (!Grid.FindFit(FIntPoint(1, 1), X, Y))
 			return INDEX_NONE;
 
-		return _openSlots[0]; // Return the first available slot
+		return Y * Columns + X; // Return the first available slot
 	}
 
 	// Utility check if a slot index is valid or not
-	FORCEINLINE bool IsValidSlot(int32 Slot)
+	FORCEINLINE bool IsValidSlot(int32 Slot) const
 	{
-		return Slot <= (Slots-1);
+		return Slot >= 0 && Slot < Slots;
 	}
 
 	// Utility to get the FInventoryItemSlotInfo at the specified Inventory slot index.
 	FORCEINLINE int32 GetItemInfoIndexAtSlot(int32 SlotIndex)
 	{
-		return Items.IndexOfByPredicate([SlotIndex](const FItemSlotInfo &SlotInfo) {
-			return SlotInfo.SlotIndex == SlotIndex;
-		});
+		return SlotStorage.ItemIndices.IsValidIndex(SlotIndex) ? SlotStorage.ItemIndices[SlotIndex] : INDEX_NONE;
 	}
 
 	// Utility to get the ItemSlotInfo in Slot. Returns nullptr if not valid; safe to call.
@@ -211,7 +485,7 @@ public:
 	// Utility to definitively check if a slotinfo is valid or not
 	FORCEINLINE bool IsValidSlotInfo(const FItemSlotInfo &SlotInfo)
 	{
-		return SlotInfo.SlotIndex != INDEX_NONE;
+		return SlotInfo.IsValid();
 	}
 
 	// Utility to thouroughly check if an itemslot is valid. Checks underlying UBaseItem reference class
@@ -225,36 +499,51 @@ public:
 	}
 
 	// Utility to check if the slotindex is open
-	FORCEINLINE bool IsSlotOpen(int32 SlotIndex)
+	FORCEINLINE bool IsSlotOpen(int32 SlotIndex) const
 	{
-		return _openSlots.Contains(SlotIndex);
+		return IsValidSlot(SlotIndex) && Grid.IsFree(SlotIndex % Columns, SlotIndex / Columns);
 	}
 
 	// Utility to get the ItemIndex of a stackable slot
 	FORCEINLINE int32 GetStackableSlotIndex(const FName &ItemID, int32 StackSize)
 	{
-		for (const FItemSlotInfo &SlotInfo : Items)
+		for (int32 Slot = 0; Slot < SlotStorage.GetNumSlots(); Slot++)
 		{
-			if (SlotInfo.ItemID.IsEqual(ItemID) && SlotInfo.StackSize + StackSize <= SlotInfo.MaxStackSize)
+			if (SlotStorage.ItemIDs[Slot] == ItemID && SlotStorage.StackSizes[Slot] + StackSize <= SlotStorage.MaxStackSizes[Slot])
 			{
-				return SlotInfo.SlotIndex;
+				return Slot;
 			}
 		}
 		return INDEX_NONE;
 	}
 
-	// Utility to get the ItemIndex of an item that matches ItemID and has room for StackSize
-	FORCEINLINE int32 GetStackableItemsIndex(const FName &ItemID, int32 StackSize)
+	// Utility to get the ItemIndex of an item that matches ItemID and has room for StackSize.
+	// With Decay, only stacks whose decay merge policy accepts items in that state match.
+	FORCEINLINE int32 GetStackableItemsIndex(const FName &ItemID, int32 StackSize, const FItemDecayState *Decay = nullptr)
 	{
-		return Items.IndexOfByPredicate([ItemID, StackSize](const FItemSlotInfo &SlotInfo) {
-			return (SlotInfo.ItemID.IsEqual(ItemID) && SlotInfo.StackSize + StackSize <= SlotInfo.MaxStackSize);
-		});
+		const float Now = GetDecayTime();
+		for (int32 Slot = 0; Slot < SlotStorage.GetNumSlots(); Slot++)
+		{
+			if (SlotStorage.ItemIDs[Slot] != ItemID || SlotStorage.StackSizes[Slot] + StackSize > SlotStorage.MaxStackSizes[Slot])
+			{
+				continue;
+			}
+
+			// Only matching stacks go to the full record
+			const int32 ItemIndex = SlotStorage.ItemIndices[Slot];
+			const UBaseItem *Item = SlotStorage.Definitions[Slot];
+			if (Decay == nullptr || Item == nullptr || Item->CanMergeDecay(Items[ItemIndex].Decay, *Decay, Now))
+			{
+				return ItemIndex;
+			}
+		}
+		return INDEX_NONE;
 	}
 
 	// Utility to check if the inventory is full
-	FORCEINLINE bool IsFull()
+	FORCEINLINE bool IsFull() const
 	{
-		return Items.Num() == Slots;
+		return !Grid.HasFreeCell();
 	}
 
 	FORCEINLINE void PrintInventory()
@@ -269,8 +558,71 @@ public:
 	// Utility to resize the inventory slot count
 	bool ResizeInventory(int32 NewRows, int32 NewColumns);
 
+protected:
+	// Every change to the number of items carried goes through here, keeping the totals
+	// without walking Items. Delta is the change in SlotInfo's stack size.
+	void AccumulateStack(const FItemSlotInfo &SlotInfo, int32 Delta);
+
+	// Take (bOccupied) or free the cells of a footprint with its top left cell in Slot
+	FORCEINLINE void SetInGrid(int32 Slot, const FIntPoint &Footprint, bool bOccupied)
+	{
+		Grid.Set(Slot % Columns, Slot / Columns, Footprint, bOccupied);
+	}
+
+	// Remove the record at ItemIndex and open its slot. The last record moves into ItemIndex.
+	void RemoveItemAt(int32 ItemIndex);
+
+	// World time decay is measured in
+	float GetDecayTime() const;
+
+	// Queue the watches on ItemID for the next flush
+	void MarkWatchDirty(FName ItemID);
+
+	// Notify the watches on the items that changed since the last flush
+	void FlushWatches();
+
+	// Start decay for a new stack, or merge Count incoming items into an existing one. Incoming nullptr is new items.
+	void MergeDecay(FItemSlotInfo &SlotInfo, int32 Count, const FItemDecayState *Incoming, bool bNewStack);
+
+	// Report the thresholds the stack at ItemIndex crossed since last time and schedule its next one
+	void UpdateDecay(int32 ItemIndex);
+
 private:
 	
-	TArray<int32> _openSlots;
+	// Occupied cells
+	FInventoryGrid Grid;
+
+	FInventorySlotStorage SlotStorage;
+
+	// Running totals. Weight is kept in whole grams so it never drifts.
+	int64 TotalWeightGrams;
+	TMap<FName, int32> ItemCounts;
+
+	struct FInventoryWatch
+	{
+		FName ItemID;
+		EInventoryWatchCondition Condition;
+		int32 Count;
+		bool bReportProgress;
+		bool bSatisfied;
+		// Set until the first notification, which always goes out
+		bool bInitial;
+		FInventoryWatchDelegate Callback;
+
+		bool Evaluate(int32 Carried) const;
+	};
+
+	TMap<int32, FInventoryWatch> Watches;
+
+	// Watch handles per ItemID, so a change only visits the watches on that item
+	TMap<FName, TArray<int32>> WatchesByItem;
+
+	// Items changed since the last flush. Component tick only runs while this has entries.
+	TArray<FName> DirtyWatchItems;
+
+	// Number carried per dirty item at the last flush, for progress reports
+	TMap<FName, int32> LastWatchCounts;
+
+	int32 NextWatchHandle;
 	
 };
@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+* Cell occupancy of a grid inventory, one 64 bit word per row.
+* Fit tests for a W x H footprint work on whole rows at once: the rows it would cover
+* are OR'ed together and the free runs of W cells found with shifts and ANDs, so no
+* test loops over cells.
+*/
+struct FInventoryGrid
+{
+	enum
+	{
+		MaxColumns = 64
+	};
+
+	FInventoryGrid()
+		: Rows(0)
+		, Columns(0)
+		, RowMask(0)
+	{}
+
+	int32 Rows;
+	int32 Columns;
+
+	// Bit X of row Y is set if cell (X, Y) is taken
+	TArray<uint64> RowBits;
+
+	// Bits of the cells that exist in a row
+	uint64 RowMask;
+
+	void Init(int32 NewRows, int32 NewColumns)
+	{
+		check(NewColumns <= MaxColumns);
+		Rows = NewRows;
+		Columns = NewColumns;
+		RowMask = Columns >= 64 ? ~(uint64)0 : (((uint64)1 << Columns) - 1);
+		RowBits.Init(0, Rows);
+	}
+
+	FORCEINLINE bool IsFree(int32 X, int32 Y) const
+	{
+		return X >= 0 && X < Columns && Y >= 0 && Y < Rows && (RowBits[Y] & ((uint64)1 << X)) == 0;
+	}
+
+	FORCEINLINE bool HasFreeCell() const
+	{
+		for (uint64 Bits : RowBits)
+		{
+			if (Bits != RowMask)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Whether a footprint with its top left cell at (X, Y) is inside the grid and on free cells only
+	FORCEINLINE bool CanPlace(int32 X, int32 Y, const FIntPoint &Footprint) const
+	{
+		if (X < 0 || Y < 0 || Footprint.X <= 0 || Footprint.Y <= 0 || X + Footprint.X > Columns || Y + Footprint.Y > Rows)
+		{
+			return false;
+		}
+
+		const uint64 Mask = GetRunMask(Footprint.X) << X;
+		for (int32 Row = Y; Row < Y + Footprint.Y; Row++)
+		{
+			if ((RowBits[Row] & Mask) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Take (bOccupied) or free the cells of a footprint. Callers test with CanPlace first.
+	FORCEINLINE void Set(int32 X, int32 Y, const FIntPoint &Footprint, bool bOccupied)
+	{
+		const uint64 Mask = GetRunMask(Footprint.X) << X;
+		for (int32 Row = FMath::Max(Y, 0); Row < FMath::Min(Y + Footprint.Y, Rows); Row++)
+		{
+			RowBits[Row] = bOccupied ? (RowBits[Row] | Mask) : (RowBits[Row] & ~Mask);
+		}
+	}
+
+	// First free place for Footprint, scanning rows top down and cells left to right.
+	// With bAllowRotation the footprint turned 90 degrees is tried as well.
+	bool FindFit(const FIntPoint &Footprint, bool bAllowRotation, int32 &OutX, int32 &OutY, bool &bOutRotated) const
+	{
+		if (FindFit(Footprint, OutX, OutY))
+		{
+			bOutRotated = false;
+			return true;
+		}
+		if (bAllowRotation && Footprint.X != Footprint.Y && FindFit(FIntPoint(Footprint.Y, Footprint.X), OutX, OutY))
+		{
+			bOutRotated = true;
+			return true;
+		}
+		return false;
+	}
+
+	bool FindFit(const FIntPoint &Footprint, int32 &OutX, int32 &OutY) const
+	{
+		if (Footprint.X <= 0 || Footprint.Y <= 0 || Footprint.X > Columns || Footprint.Y > Rows)
+		{
+			return false;
+		}
+
+		for (int32 Y = 0; Y + Footprint.Y <= Rows; Y++)
+		{
+			uint64 Taken = 0;
+			for (int32 Row = Y; Row < Y + Footprint.Y; Row++)
+			{
+				Taken |= RowBits[Row];
+			}
+
+			// Narrow the free cells down to those starting Footprint.X free cells in a row,
+			// doubling the run length checked each step. Cells past the last column count as taken.
+			uint64 Starts = ~Taken & RowMask;
+			int32 Run = 1;
+			while (Run < Footprint.X && Starts != 0)
+			{
+				const int32 Step = FMath::Min(Run, Footprint.X - Run);
+				Starts &= Starts >> Step;
+				Run += Step;
+			}
+
+			if (Starts != 0)
+			{
+				OutX = LowestSetBit(Starts);
+				OutY = Y;
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	static FORCEINLINE uint64 GetRunMask(int32 Width)
+	{
+		return Width >= 64 ? ~(uint64)0 : (((uint64)1 << Width) - 1);
+	}
+
+	static FORCEINLINE int32 LowestSetBit(uint64 Bits)
+	{
+		const uint32 Low = (uint32)Bits;
+		return Low != 0 ? (int32)FMath::CountTrailingZeros(Low) : 32 + (int32)FMath::CountTrailingZeros((uint32)(Bits >> 32));
+	}
+};
@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "InventorySearchIndex.h"
+#include "BaseItem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Inventory Search"), STAT_InventorySearch, STATGROUP_Survival);
+DECLARE_CYCLE_STAT(TEXT("Inventory Search Index Build"), STAT_InventorySearchBuild, STATGROUP_Survival);
+
+
+bool FInventorySearchIndex::IsStale() const
+{
+	return bBuilt && CultureName != FInternationalization::Get().GetCurrentCulture()->GetName();
+}
+
+void FInventorySearchIndex::Build(const TArray<UBaseItem*> &Definitions)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InventorySearchBuild);
+
+	Entries.Reset();
+	CultureName = FInternationalization::Get().GetCurrentCulture()->GetName();
+	bBuilt = true;
+
+	TArray<FString> Words;
+	for (int32 Slot = 0; Slot < Definitions.Num(); Slot++)
+	{
+		if (Definitions[Slot] == nullptr)
+		{
+			continue;
+		}
+
+		Words.Reset();
+		Tokenize(Definitions[Slot]->Name, Words);
+		for (FString &Word : Words)
+		{
+			FEntry Entry;
+			Entry.Word = MoveTemp(Word);
+			Entry.Slot = Slot;
+			Entries.Add(MoveTemp(Entry));
+		}
+	}
+
+	// Sorted once here; incremental changes insert in place
+	Entries.Sort([](const FEntry &A, const FEntry &B) {
+		return A.Word.Compare(B.Word, ESearchCase::CaseSensitive) < 0;
+	});
+}
+
+void FInventorySearchIndex::Reset()
+{
+	Entries.Empty();
+	CultureName.Empty();
+	bBuilt = false;
+}
+
+void FInventorySearchIndex::Add(int32 Slot, const UBaseItem *Item)
+{
+	if (!bBuilt || Item == nullptr)
+	{
+		return;
+	}
+
+	TArray<FString> Words;
+	Tokenize(Item->Name, Words);
+	for (FString &Word : Words)
+	{
+		FEntry Entry;
+		Entry.Slot = Slot;
+		const int32 Index = LowerBound(Word);
+		Entry.Word = MoveTemp(Word);
+		Entries.Insert(MoveTemp(Entry), Index);
+	}
+}
+
+void FInventorySearchIndex::Remove(int32 Slot)
+{
+	if (bBuilt)
+	{
+		Entries.RemoveAll([Slot](const FEntry &Entry) {
+			return Entry.Slot == Slot;
+		});
+	}
+}
+
+void FInventorySearchIndex::SwapSlots(int32 SlotA, int32 SlotB)
+{
+	if (!bBuilt)
+	{
+		return;
+	}
+
+	// Entries are only ordered by word, so slots can be changed in place
+	for (FEntry &Entry : Entries)
+	{
+		if (Entry.Slot == SlotA)
+		{
+			Entry.Slot = SlotB;
+		}
+		else if (Entry.Slot == SlotB)
+		{
+			Entry.Slot = SlotA;
+		}
+	}
+}
+
+int32 FInventorySearchIndex::Search(const FString &Query, TArray<int32> &OutSlots) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_InventorySearch);
+
+	TArray<FString> Words;
+	Tokenize(FText::AsCultureInvariant(Query), Words);
+	if (Words.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Slots matching the first word, narrowed down by each further word
+	TArray<int32> Matches;
+	FindPrefix(Words[0], Matches);
+
+	TArray<int32> WordMatches;
+	for (int32 i = 1; i < Words.Num() && Matches.Num() > 0; i++)
+	{
+		WordMatches.Reset();
+		FindPrefix(Words[i], WordMatches);
+
+		// Both sorted; intersect in place
+		int32 Kept = 0;
+		int32 j = 0;
+		for (int32 Slot : Matches)
+		{
+			while (j < WordMatches.Num() && WordMatches[j] < Slot)
+			{
+				j++;
+			}
+			if (j < WordMatches.Num() && WordMatches[j] == Slot)
+			{
+				Matches[Kept++] = Slot;
+			}
+		}
+		Matches.SetNum(Kept, false);
+	}
+
+	OutSlots.Append(Matches);
+	return Matches.Num();
+}
+
+void FInventorySearchIndex::Tokenize(const FText &Text, TArray<FString> &OutWords)
+{
+	const FString Lower = Text.ToLower().ToString();
+
+	int32 Start = INDEX_NONE;
+	for (int32 i = 0; i <= Lower.Len(); i++)
+	{
+		const bool bWordChar = i < Lower.Len() && FChar::IsAlnum(Lower[i]);
+		if (bWordChar && Start == INDEX_NONE)
+		{
+			Start = i;
+		}
+		else if (!bWordChar && Start != INDEX_NONE)
+		{
+			OutWords.Add(Lower.Mid(Start, i - Start));
+			Start = INDEX_NONE;
+		}
+	}
+}
+
+int32 FInventorySearchIndex::LowerBound(const FString &Word) const
+{
+	int32 Low = 0;
+	int32 High = Entries.Num();
+	while (Low < High)
+	{
+		const int32 Mid = Low + (High - Low) / 2;
+		if (Entries[Mid].Word.Compare(Word, ESearchCase::CaseSensitive) < 0)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+	return Low;
+}
+
+void FInventorySearchIndex::FindPrefix(const FString &Prefix, TArray<int32> &OutSlots) const
+{
+	// Words starting with Prefix sort right after it, in one run
+	for (int32 i = LowerBound(Prefix); i < Entries.Num() && Entries[i].Word.StartsWith(Prefix, ESearchCase::CaseSensitive); i++)
+	{
+		OutSlots.Add(Entries[i].Slot);
+	}
+
+	// An item matches once, however many of its words do
+	OutSlots.Sort();
+	int32 Kept = 0;
+	for (int32 i = 0; i < OutSlots.Num(); i++)
+	{
+		if (Kept == 0 || OutSlots[Kept - 1] != OutSlots[i])
+		{
+			OutSlots[Kept++] = OutSlots[i];
+		}
+	}
+	OutSlots.SetNum(Kept, false);
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+class UBaseItem;
+
+/**
+* Word prefix index of the localized item names in one inventory, for filtering as the player types.
+* Names are lower cased for the current culture and split into words, kept in one array sorted by
+* word. A query is a binary search for the first word with the prefix plus a walk over the matches,
+* so no names are converted per search. Built on first use, kept up to date as slots change after
+* that, and rebuilt when the culture changes.
+*/
+struct FInventorySearchIndex
+{
+	FInventorySearchIndex()
+		: bBuilt(false)
+	{}
+
+	FORCEINLINE bool IsBuilt() const
+	{
+		return bBuilt;
+	}
+
+	// Whether the names were lower cased and split for another culture than the current one
+	bool IsStale() const;
+
+	// Index every item, replacing what was there. Definitions is indexed by slot, nullptr for open slots.
+	void Build(const TArray<UBaseItem*> &Definitions);
+
+	// Drop the index until the next Build
+	void Reset();
+
+	void Add(int32 Slot, const UBaseItem *Item);
+	void Remove(int32 Slot);
+	void SwapSlots(int32 SlotA, int32 SlotB);
+
+	// Slots with a word starting with each word of Query, ascending. Returns the number found.
+	int32 Search(const FString &Query, TArray<int32> &OutSlots) const;
+
+	// Lower case words of Text, for the current culture
+	static void Tokenize(const FText &Text, TArray<FString> &OutWords);
+
+private:
+	struct FEntry
+	{
+		FString Word;
+		int32 Slot;
+	};
+
+	// Sorted by Word
+	TArray<FEntry> Entries;
+
+	// Culture the index was built for
+	FString CultureName;
+
+	bool bBuilt;
+
+	// First entry whose word is not less than Word
+	int32 LowerBound(const FString &Word) const;
+
+	// Sorted, unique slots with a word starting with Prefix
+	void FindPrefix(const FString &Prefix, TArray<int32> &OutSlots) const;
+};
@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "ItemAssetStreamer.h"
+#include "SurvivalGameStateBase.h"
+
+DECLARE_MEMORY_STAT(TEXT("Streamed Item Assets"), STAT_StreamedItemAssetMemory, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Asset Evictions"), STAT_ItemAssetEvictions, STATGROUP_Survival);
+
+
+UItemAssetStreamer::UItemAssetStreamer()
+{
+	MemoryBudgetMegabytes = 256.0f;
+
+	LoadedBytes = 0;
+	UseSerial = 0;
+	Evictions = 0;
+	bBudgetDirty = false;
+}
+
+UItemAssetStreamer *UItemAssetStreamer::Get(const UObject *WorldContextObject)
+{
+	UWorld *World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	ASurvivalGameStateBase *GameState = World ? World->GetGameState<ASurvivalGameStateBase>() : nullptr;
+	return GameState ? GameState->ItemAssetStreamer : nullptr;
+}
+
+void UItemAssetStreamer::RequestItemAssets(const UBaseItem *Item, FSimpleDelegate Callback, bool bPin)
+{
+	TArray<FStringAssetReference> ItemAssets;
+	if (Item != nullptr)
+	{
+		Item->GetStreamableAssets(ItemAssets);
+	}
+	RequestAssets(ItemAssets, Callback, bPin);
+}
+
+void UItemAssetStreamer::RequestWorldMesh(const UBaseItem *Item, FSimpleDelegate Callback)
+{
+	TArray<FStringAssetReference> ItemAssets;
+	if (Item != nullptr && !Item->WorldMesh.IsNull())
+	{
+		ItemAssets.Add(Item->WorldMesh.ToStringReference());
+	}
+	RequestAssets(ItemAssets, Callback, false);
+}
+
+void UItemAssetStreamer::RequestIcon(const UBaseItem *Item)
+{
+	TArray<FStringAssetReference> ItemAssets;
+	if (Item != nullptr && !Item->Icon.IsNull())
+	{
+		ItemAssets.Add(Item->Icon.ToStringReference());
+	}
+	RequestAssets(ItemAssets, FSimpleDelegate(), false);
+}
+
+void UItemAssetStreamer::RequestAssets(const TArray<FStringAssetReference> &ItemAssets, FSimpleDelegate Callback, bool bPin)
+{
+	TArray<FStringAssetReference> ToLoad;
+	for (const FStringAssetReference &Asset : ItemAssets)
+	{
+		FStreamedAsset &Entry = Assets.FindOrAdd(Asset);
+		Entry.LastUseSerial = ++UseSerial;
+		if (bPin)
+		{
+			Entry.PinCount++;
+		}
+		if (!Entry.bLoaded)
+		{
+			ToLoad.Add(Asset);
+		}
+	}
+
+	if (ToLoad.Num() == 0)
+	{
+		Callback.ExecuteIfBound();
+		return;
+	}
+
+	StreamableManager.RequestAsyncLoad(ToLoad, FStreamableDelegate::CreateUObject(this, &UItemAssetStreamer::OnAssetsLoaded, ToLoad, Callback));
+}
+
+void UItemAssetStreamer::PrefetchItemAssets(const UBaseItem *Item)
+{
+	RequestItemAssets(Item, FSimpleDelegate(), false);
+}
+
+void UItemAssetStreamer::ReleaseItemAssets(const UBaseItem *Item)
+{
+	if (Item == nullptr)
+	{
+		return;
+	}
+
+	TArray<FStringAssetReference> ItemAssets;
+	Item->GetStreamableAssets(ItemAssets);
+	for (const FStringAssetReference &Asset : ItemAssets)
+	{
+		FStreamedAsset *Entry = Assets.Find(Asset);
+		if (Entry != nullptr && Entry->PinCount > 0)
+		{
+			Entry->PinCount--;
+		}
+	}
+	bBudgetDirty = true;
+}
+
+void UItemAssetStreamer::OnAssetsLoaded(TArray<FStringAssetReference> LoadedAssets, FSimpleDelegate Callback)
+{
+	for (const FStringAssetReference &Asset : LoadedAssets)
+	{
+		FStreamedAsset *Entry = Assets.Find(Asset);
+		UObject *Object = Asset.ResolveObject();
+		if (Entry == nullptr || Entry->bLoaded || Object == nullptr)
+		{
+			continue;
+		}
+
+		Entry->bLoaded = true;
+		Entry->Bytes = Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		LoadedBytes += Entry->Bytes;
+		INC_MEMORY_STAT_BY(STAT_StreamedItemAssetMemory, Entry->Bytes);
+	}
+
+	bBudgetDirty = true;
+	Callback.ExecuteIfBound();
+}
+
+void UItemAssetStreamer::EnforceBudget()
+{
+	const SIZE_T BudgetBytes = (SIZE_T)(MemoryBudgetMegabytes * 1024.0f * 1024.0f);
+	if (LoadedBytes <= BudgetBytes)
+	{
+		return;
+	}
+
+	struct FEvictionCandidate
+	{
+		uint32 LastUseSerial;
+		FStringAssetReference Asset;
+	};
+
+	TArray<FEvictionCandidate> Candidates;
+	for (auto It = Assets.CreateConstIterator(); It; ++It)
+	{
+		if (It.Value().bLoaded && It.Value().PinCount == 0)
+		{
+			FEvictionCandidate Candidate;
+			Candidate.LastUseSerial = It.Value().LastUseSerial;
+			Candidate.Asset = It.Key();
+			Candidates.Add(Candidate);
+		}
+	}
+
+	// Least recently used first
+	Candidates.Sort([](const FEvictionCandidate &A, const FEvictionCandidate &B)
+	{
+		return A.LastUseSerial < B.LastUseSerial;
+	});
+
+	for (int32 i = 0; i < Candidates.Num() && LoadedBytes > BudgetBytes; i++)
+	{
+		const FStringAssetReference Asset = Candidates[i].Asset;
+		const FStreamedAsset &Entry = Assets.FindChecked(Asset);
+
+		LoadedBytes -= Entry.Bytes;
+		DEC_MEMORY_STAT_BY(STAT_StreamedItemAssetMemory, Entry.Bytes);
+
+		// Drops our reference; garbage collection frees it unless something else still uses it
+		StreamableManager.Unload(Asset);
+		Assets.Remove(Asset);
+
+		Evictions++;
+		INC_DWORD_STAT(STAT_ItemAssetEvictions);
+	}
+}
+
+FItemAssetStreamerStats UItemAssetStreamer::GetStreamerStats() const
+{
+	FItemAssetStreamerStats Stats;
+	for (auto It = Assets.CreateConstIterator(); It; ++It)
+	{
+		if (It.Value().bLoaded)
+		{
+			Stats.LoadedAssets++;
+		}
+		if (It.Value().PinCount > 0)
+		{
+			Stats.PinnedAssets++;
+		}
+	}
+	Stats.LoadedMegabytes = LoadedBytes / (1024.0f * 1024.0f);
+	Stats.Evictions = Evictions;
+	return Stats;
+}
+
+void UItemAssetStreamer::Tick(float DeltaTime)
+{
+	if (bBudgetDirty)
+	{
+		bBudgetDirty = false;
+		EnforceBudget();
+	}
+}
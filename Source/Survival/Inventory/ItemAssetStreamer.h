@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "Engine/StreamableManager.h"
+#include "ItemAssetStreamer.generated.h"
+
+class UBaseItem;
+
+/**
+* Memory use of the streamed item assets
+*/
+USTRUCT(BlueprintType)
+struct FItemAssetStreamerStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Streaming)
+	int32 LoadedAssets;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Streaming)
+	int32 PinnedAssets;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Streaming)
+	float LoadedMegabytes;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Streaming)
+	int32 Evictions;
+
+	FItemAssetStreamerStats()
+	{
+		LoadedAssets = 0;
+		PinnedAssets = 0;
+		LoadedMegabytes = 0.0f;
+		Evictions = 0;
+	}
+};
+
+/**
+* Loads the meshes, icons, sounds and animations of items on demand.
+*
+* Items reference their assets softly (@see UBaseItem::GetStreamableAssets), so they no longer
+* load together with the item class. Pickups in the world load their world mesh only, the
+* rest once they are looked at. Equipped items pin their assets; items that may be
+* equipped soon (carried weapons) are prefetched. Assets that are not pinned stay loaded until
+* the memory budget is exceeded, and are then released least recently used first.
+*
+* Owned by the game state, so it exists on both server and clients.
+*/
+UCLASS(Config = Game)
+class SURVIVAL_API UItemAssetStreamer : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	UItemAssetStreamer();
+
+	// Utility to get the streamer of the world WorldContextObject lives in. May return nullptr.
+	static UItemAssetStreamer *Get(const UObject *WorldContextObject);
+
+	// Memory allowed for unpinned item assets before eviction starts
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Streaming)
+	float MemoryBudgetMegabytes;
+
+	// Load the assets of Item. Callback (optional) runs once they are all loaded, possibly right away.
+	// Pinned assets are never evicted until released with ReleaseItemAssets.
+	void RequestItemAssets(const UBaseItem *Item, FSimpleDelegate Callback = FSimpleDelegate(), bool bPin = false);
+
+	// Load the assets of Item in the background, without pinning them
+	void PrefetchItemAssets(const UBaseItem *Item);
+
+	// Load only the world mesh of Item, for pickups lying in the world. The rest is loaded on inspect or equip.
+	void RequestWorldMesh(const UBaseItem *Item, FSimpleDelegate Callback);
+
+	// Load only the icon of Item, for inventory widgets (@see UBaseItem::GetIcon)
+	void RequestIcon(const UBaseItem *Item);
+
+	// Undo one pinning RequestItemAssets. The assets stay loaded until evicted.
+	void ReleaseItemAssets(const UBaseItem *Item);
+
+	UFUNCTION(BlueprintCallable, Category = Streaming)
+	FItemAssetStreamerStats GetStreamerStats() const;
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	void RequestAssets(const TArray<FStringAssetReference> &ItemAssets, FSimpleDelegate Callback, bool bPin);
+
+	void OnAssetsLoaded(TArray<FStringAssetReference> Assets, FSimpleDelegate Callback);
+
+	// Unload least recently used, unpinned assets until we are within the budget
+	void EnforceBudget();
+
+	struct FStreamedAsset
+	{
+		// Serial of the last request, higher is more recent
+		uint32 LastUseSerial;
+		int32 PinCount;
+		SIZE_T Bytes;
+		bool bLoaded;
+
+		FStreamedAsset()
+			: LastUseSerial(0)
+			, PinCount(0)
+			, Bytes(0)
+			, bLoaded(false)
+		{}
+	};
+
+	FStreamableManager StreamableManager;
+
+	TMap<FStringAssetReference, FStreamedAsset> Assets;
+
+	SIZE_T LoadedBytes;
+	uint32 UseSerial;
+	int32 Evictions;
+
+	// Set when loads finish, so the budget is checked once per frame
+	bool bBudgetDirty;
+};
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "ItemDecayScheduler.h"
+#include "InventoryComponent.h"
+#include "SurvivalGameStateBase.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item Decay Events"), STAT_ItemDecayEvents, STATGROUP_Survival);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Item Decay Pending"), STAT_ItemDecayPending, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Decay Fired"), STAT_ItemDecayFired, STATGROUP_Survival);
+
+
+UItemDecayScheduler::UItemDecayScheduler()
+{
+	NextSerial = 1;
+}
+
+UItemDecayScheduler *UItemDecayScheduler::Get(const UObject *WorldContextObject)
+{
+	UWorld *World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	ASurvivalGameStateBase *GameState = World ? World->GetGameState<ASurvivalGameStateBase>() : nullptr;
+	return GameState ? GameState->ItemDecayScheduler : nullptr;
+}
+
+uint32 UItemDecayScheduler::Schedule(UInventoryComponent *Inventory, float Time)
+{
+	if (Inventory == nullptr)
+	{
+		return 0;
+	}
+
+	FDecayEvent Event;
+	Event.Time = Time;
+	Event.Inventory = Inventory;
+	Event.Serial = NextSerial++;
+	if (NextSerial == 0)
+	{
+		NextSerial = 1;
+	}
+	Events.HeapPush(Event);
+
+	SET_DWORD_STAT(STAT_ItemDecayPending, Events.Num());
+	return Event.Serial;
+}
+
+void UItemDecayScheduler::Tick(float DeltaTime)
+{
+	UWorld *World = GetWorld();
+	if (World == nullptr || Events.Num() == 0)
+	{
+		return;
+	}
+
+	const float Now = World->GetTimeSeconds();
+	if (Events.HeapTop().Time > Now)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_ItemDecayEvents);
+
+	// Only what was due when we started; handlers reschedule their next threshold
+	TArray<FDecayEvent, TInlineAllocator<16>> Due;
+	while (Events.Num() > 0 && Events.HeapTop().Time <= Now)
+	{
+		FDecayEvent Event;
+		Events.HeapPop(Event, false);
+		Due.Add(Event);
+	}
+
+	for (const FDecayEvent &Event : Due)
+	{
+		// Inventories drop stale events themselves (stack gone, merged or rescheduled)
+		UInventoryComponent *Inventory = Event.Inventory.Get();
+		if (Inventory != nullptr)
+		{
+			Inventory->HandleDecayEvent(Event.Serial);
+			INC_DWORD_STAT(STAT_ItemDecayFired);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ItemDecayPending, Events.Num());
+}
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "ItemDecayScheduler.generated.h"
+
+class UInventoryComponent;
+
+/**
+* Fires item decay threshold events (stale, spoiled, worn out, ...) at the time they happen.
+*
+* Decay itself is never simulated (@see FItemDecayState). Each decaying stack only has its
+* next threshold crossing in a min-heap ordered by time, so a frame costs one heap check
+* plus the events that are actually due. Idle inventories cost nothing.
+*
+* Owned by the game state, so it exists wherever inventories do.
+*/
+UCLASS()
+class SURVIVAL_API UItemDecayScheduler : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	UItemDecayScheduler();
+
+	// Utility to get the scheduler of the world WorldContextObject lives in. May return nullptr.
+	static UItemDecayScheduler *Get(const UObject *WorldContextObject);
+
+	// Have Inventory handle a decay event at world time Time. Returns the event serial; an event
+	// is dropped when the stack no longer carries its serial (@see FItemDecayState::EventSerial).
+	uint32 Schedule(UInventoryComponent *Inventory, float Time);
+
+	FORCEINLINE int32 GetNumPendingEvents() const
+	{
+		return Events.Num();
+	}
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	struct FDecayEvent
+	{
+		float Time;
+		TWeakObjectPtr<UInventoryComponent> Inventory;
+		uint32 Serial;
+
+		// Earliest first in the heap
+		FORCEINLINE bool operator<(const FDecayEvent &Other) const
+		{
+			return Time < Other.Time;
+		}
+	};
+
+	TArray<FDecayEvent> Events;
+
+	uint32 NextSerial;
+};
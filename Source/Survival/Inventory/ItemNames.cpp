@@ -0,0 +1,15 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "ItemNames.h"
+#include "InventoryComponent.h"
+
+namespace ItemNames
+{
+#define SURVIVAL_DEFINE_ITEM_NAME(Identifier, String) const FName Identifier(TEXT(String));
+	SURVIVAL_ITEM_NAMES(SURVIVAL_DEFINE_ITEM_NAME)
+#undef SURVIVAL_DEFINE_ITEM_NAME
+}
+
+// Defined here, after the names, so it is constructed after the names it copies
+const FItemSlotInfo FItemSlotInfo::InvalidSlot;
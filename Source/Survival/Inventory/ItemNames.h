@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+* Item IDs and sentinels the code refers to by name. Each is interned in the name table
+* once, when the module loads, so using one is a copy of the FName rather than a lookup.
+*
+* Add new names to the list: Op(Identifier, "String").
+*/
+#define SURVIVAL_ITEM_NAMES(Op) \
+	Op(Invalid,		"INVALID")		/* ItemID of an empty or invalid slot */ \
+	Op(NoID,		"NO_ID")		/* ID of an item that was never given one */
+
+namespace ItemNames
+{
+#define SURVIVAL_DECLARE_ITEM_NAME(Identifier, String) extern SURVIVAL_API const FName Identifier;
+	SURVIVAL_ITEM_NAMES(SURVIVAL_DECLARE_ITEM_NAME)
+#undef SURVIVAL_DECLARE_ITEM_NAME
+}
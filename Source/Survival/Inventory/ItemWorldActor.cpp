@@ -3,13 +3,17 @@
 #include "Survival.h"
 #include "BaseItem.h"
 #include "ItemWorldActor.h"
+#include "ItemWorldManager.h"
+#include "ItemAssetStreamer.h"
+#include "SurvivalGameMode.h"
+#include "UnrealNetwork.h"
 
 
 // Sets default values
 AItemWorldActor::AItemWorldActor()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// Pickups don't need to tick. Merging and expiry is handled centrally by UItemWorldManager.
+	PrimaryActorTick.bCanEverTick = false;
 
 	StaticMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("StaticMesh"));
 
@@ -18,14 +22,112 @@ AItemWorldActor::AItemWorldActor()
 
 	ItemTypeReference = NULL;
 	ItemTypeClass = NULL;
+	bDropped = false;
 
+	// Pickups are dormant on the network and only replicate when their stack changes.
+	// Placed pickups are already known to clients through the map.
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
+	NetUpdateFrequency = 1.0f;
+
+	WorldItemIndex = INDEX_NONE;
+	GridCell = FIntVector::ZeroValue;
+	SpawnTime = 0.0f;
+	LastRelevantTime = 0.0f;
 }
 
 // Called when the game starts or when spawned
 void AItemWorldActor::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// Let the server side maintenance service know about us
+	UWorld *World = GetWorld();
+	if (Role == ROLE_Authority && World != nullptr)
+	{
+		// Fresh pickups start decaying when they appear
+		if (ItemTypeClass != nullptr)
+		{
+			DecayState.Start(ItemTypeClass->GetDefaultObject<UBaseItem>()->DecayRate, World->GetTimeSeconds());
+		}
+
+		// Spawned pickups replicate once to each connection, then go dormant
+		if (!IsNetStartupActor())
+		{
+			SetNetDormancy(DORM_DormantAll);
+		}
+
+		// Only player drops pile up, placed pickups and loot are managed by the level and the loot spawner
+		ASurvivalGameMode *GM = World->GetAuthGameMode<ASurvivalGameMode>();
+		if (bDropped && GM && GM->ItemWorldManager)
+		{
+			GM->ItemWorldManager->RegisterItem(this);
+		}
+	}
+}
+
+// Called when the actor is removed from the world
+void AItemWorldActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (WorldManager.IsValid())
+	{
+		WorldManager->UnregisterItem(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AItemWorldActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AItemWorldActor, ItemTypeClass);
+	DOREPLIFETIME(AItemWorldActor, StackSize);
+	DOREPLIFETIME(AItemWorldActor, DecayState);
+}
+
+void AItemWorldActor::SetStackSize(int32 NewStackSize)
+{
+	if (StackSize != NewStackSize)
+	{
+		StackSize = NewStackSize;
+		FlushNetDormancy();
+	}
+}
+
+void AItemWorldActor::SetHighlighted(bool bHighlighted)
+{
+	if (StaticMesh)
+	{
+		StaticMesh->SetRenderCustomDepth(bHighlighted);
+	}
+
+	// Looked at, so it may be inspected or picked up next; get the icon and detail mesh ready
+	UItemAssetStreamer *Streamer = UItemAssetStreamer::Get(this);
+	if (bHighlighted && Streamer != nullptr && ItemTypeReference != nullptr)
+	{
+		Streamer->PrefetchItemAssets(ItemTypeReference);
+	}
+}
+
+bool AItemWorldActor::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	// With tiers turned off, or without the server side manager, we fall back to regular distance based relevancy
+	if (!UItemWorldManager::AreRelevancyTiersEnabled() || !WorldManager.IsValid())
+	{
+		return Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
+	}
+	return WorldManager->GetRelevancyTier(GridCell, SrcLocation) != EItemRelevancyTier::IRT_Culled;
+}
+
+float AItemWorldActor::GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, class AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth)
+{
+	float Priority = Super::GetNetPriority(ViewPos, ViewDir, Viewer, ViewTarget, InChannel, Time, bLowBandwidth);
+	if (WorldManager.IsValid() && WorldManager->GetRelevancyTier(GridCell, ViewPos) == EItemRelevancyTier::IRT_Far)
+	{
+		Priority *= WorldManager->FarTierPriorityScale;
+	}
+	return Priority;
 }
 
 // Called every frame
@@ -40,6 +142,20 @@ void AItemWorldActor::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
 
+	CreateItemReference();
+}
+
+void AItemWorldActor::OnRep_ItemTypeClass()
+{
+	// Construction ran before the item class arrived on clients, so build the item now
+	if (ItemTypeReference == nullptr || ItemTypeReference->GetClass() != *ItemTypeClass)
+	{
+		CreateItemReference();
+	}
+}
+
+void AItemWorldActor::CreateItemReference()
+{
 	if (ItemTypeClass != NULL)
 	{
 		if (ItemTypeReference != NULL)
@@ -54,15 +170,37 @@ void AItemWorldActor::OnConstruction(const FTransform& Transform)
 		// Create the item associated with this pickup actor
 		ItemTypeReference = NewObject<UBaseItem>(this, ItemTypeClass);
 		
-		// Set mesh to whatever is referenced in the base item def
-		StaticMesh->SetStaticMesh(ItemTypeReference->WorldMesh);
-		if (StaticMesh)
+		// Set mesh to whatever is referenced in the base item def. In game only the world mesh is
+		// streamed in; in the editor there is no streamer, so load it right away.
+		UItemAssetStreamer *Streamer = UItemAssetStreamer::Get(this);
+		if (ItemTypeReference->WorldMesh.IsNull() || ItemTypeReference->WorldMesh.IsValid())
 		{
-			// For now, just set this actors' pickup radius to the bounds of the mesh
-			// and update location of it to the mesh.
-			SphereComponent->SetSphereRadius(StaticMesh->Bounds.GetSphere().W);
-			SphereComponent->SetWorldLocation(StaticMesh->GetComponentLocation());
+			OnWorldMeshLoaded();
 		}
-		
+		else if (Streamer != nullptr)
+		{
+			Streamer->RequestWorldMesh(ItemTypeReference, FSimpleDelegate::CreateUObject(this, &AItemWorldActor::OnWorldMeshLoaded));
+		}
+		else if (!GetWorld()->IsGameWorld())
+		{
+			ItemTypeReference->WorldMesh.LoadSynchronous();
+			OnWorldMeshLoaded();
+		}
+	}
+}
+
+void AItemWorldActor::OnWorldMeshLoaded()
+{
+	if (ItemTypeReference == nullptr || StaticMesh == nullptr)
+	{
+		return;
 	}
+
+	// Only called once the mesh is loaded (or there is none)
+	StaticMesh->SetStaticMesh(ItemTypeReference->WorldMesh.Get());
+
+	// For now, just set this actors' pickup radius to the bounds of the mesh
+	// and update location of it to the mesh.
+	SphereComponent->SetSphereRadius(StaticMesh->Bounds.GetSphere().W);
+	SphereComponent->SetWorldLocation(StaticMesh->GetComponentLocation());
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "BaseItem.h"
 #include "GameFramework/Actor.h"
 #include "ItemWorldActor.generated.h"
 
@@ -10,6 +11,8 @@ class SURVIVAL_API AItemWorldActor : public AActor
 {
 	GENERATED_BODY()
 
+	friend class UItemWorldManager;
+
 	UPROPERTY(VisibleDefaultsOnly, Category = Inventory)
 	class UStaticMeshComponent *StaticMesh;
 
@@ -19,24 +22,72 @@ class SURVIVAL_API AItemWorldActor : public AActor
 public:
 
 	
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Inventory)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, ReplicatedUsing = OnRep_ItemTypeClass, Category = Inventory)
 	TSubclassOf<class UBaseItem> ItemTypeClass;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
 	class UBaseItem *ItemTypeReference;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Inventory)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = Inventory)
 	int32 StackSize;
+
+	// Condition of the stack. Decays lazily like in inventories, without events.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Replicated, Category = Inventory)
+	FItemDecayState DecayState;
+
+	// Dropped by a player. Only dropped pickups are merged and despawned by UItemWorldManager;
+	// placed and loot spawner pickups are left alone. Set before the pickup finishes spawning.
+	UPROPERTY(BlueprintReadWrite, Category = Inventory, meta = (ExposeOnSpawn = "true"))
+	bool bDropped;
+
+	// Changes the stack size and wakes the pickup from net dormancy so the change replicates
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	void SetStackSize(int32 NewStackSize);
 	
 	// Sets default values for this actor's properties
 	AItemWorldActor();
 
+	// Toggles the interaction highlight (custom depth outline) on the pickup mesh
+	void SetHighlighted(bool bHighlighted);
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 	
 	// Called every frame
 	virtual void Tick( float DeltaSeconds ) override;
 
+	// Called when the actor is removed from the world
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void OnConstruction(const FTransform& Transform) override;
+
+	// Called when the item's world mesh is loaded
+	void OnWorldMeshLoaded();
+
+	// Builds the item on clients once its class has replicated
+	UFUNCTION()
+	void OnRep_ItemTypeClass();
+
+	// AActor network interface
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+	virtual float GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, class AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth) override;
+	// End of AActor network interface
+
+private:
+	// Creates ItemTypeReference from ItemTypeClass and requests its world mesh
+	void CreateItemReference();
+
+	///////////////////////////////////////////////////////////
+	// World item maintenance bookkeeping (@see UItemWorldManager)
+
+	TWeakObjectPtr<class UItemWorldManager> WorldManager;
+
+	int32 WorldItemIndex;
+
+	FIntVector GridCell;
+
+	float SpawnTime;
+
+	float LastRelevantTime;
 	
 };
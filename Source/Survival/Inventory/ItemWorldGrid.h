@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+class AItemWorldActor;
+
+/**
+* Uniform spatial hash of world item pickups.
+* World items don't move once dropped, so each item is bucketed once on register
+* and neighbour lookups only visit the cells that overlap the query radius.
+*/
+struct FItemWorldGrid
+{
+	FItemWorldGrid()
+		: CellSize(1000.0f)
+	{}
+
+	// Side length of a cell in world units
+	float CellSize;
+
+	// Items bucketed by cell coordinate
+	TMap<FIntVector, TArray<AItemWorldActor*>> Cells;
+
+	FORCEINLINE FIntVector GetCell(const FVector &Location) const
+	{
+		return FIntVector(
+			FMath::FloorToInt(Location.X / CellSize),
+			FMath::FloorToInt(Location.Y / CellSize),
+			FMath::FloorToInt(Location.Z / CellSize));
+	}
+
+	FORCEINLINE void Add(AItemWorldActor *Item, const FIntVector &Cell)
+	{
+		Cells.FindOrAdd(Cell).Add(Item);
+	}
+
+	FORCEINLINE void Remove(AItemWorldActor *Item, const FIntVector &Cell)
+	{
+		TArray<AItemWorldActor*> *CellItems = Cells.Find(Cell);
+		if (CellItems != nullptr)
+		{
+			CellItems->RemoveSingleSwap(Item);
+			if (CellItems->Num() == 0)
+			{
+				Cells.Remove(Cell);
+			}
+		}
+	}
+
+	FORCEINLINE void Empty()
+	{
+		Cells.Empty();
+	}
+
+	// Calls Func(AItemWorldActor*) for every item in the cells overlapping the sphere.
+	// Callers still have to do the exact distance test.
+	template<typename FuncType>
+	void ForEachInRadius(const FVector &Center, float Radius, FuncType Func) const
+	{
+		const FIntVector Min = GetCell(Center - FVector(Radius));
+		const FIntVector Max = GetCell(Center + FVector(Radius));
+
+		for (int32 X = Min.X; X <= Max.X; X++)
+		{
+			for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+			{
+				for (int32 Z = Min.Z; Z <= Max.Z; Z++)
+				{
+					const TArray<AItemWorldActor*> *CellItems = Cells.Find(FIntVector(X, Y, Z));
+					if (CellItems == nullptr)
+						continue;
+
+					for (AItemWorldActor *Item : *CellItems)
+					{
+						Func(Item);
+					}
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,284 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "ItemWorldManager.h"
+#include "ItemWorldActor.h"
+#include "BaseItem.h"
+
+DECLARE_CYCLE_STAT(TEXT("World Item Maintenance"), STAT_WorldItemMaintenance, STATGROUP_Survival);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("World Items"), STAT_WorldItems, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Items Merged"), STAT_WorldItemsMerged, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Items Despawned"), STAT_WorldItemsDespawned, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Item Relevancy Checks"), STAT_WorldItemRelevancyChecks, STATGROUP_Survival);
+
+static TAutoConsoleVariable<int32> CVarItemRelevancyTiers(
+	TEXT("Survival.ItemRelevancyTiers"),
+	1,
+	TEXT("Use cell based relevancy tiers for world item pickups.\n")
+	TEXT("0: Default actor relevancy, 1: Cell tiers (default)"));
+
+
+UItemWorldManager::UItemWorldManager()
+{
+	MaintenanceBudgetMicroseconds = 200.0f;
+	MergeRadius = 150.0f;
+	MaxItemLifetime = 600.0f;
+	RelevanceDistance = 5000.0f;
+	IrrelevantLifetime = 180.0f;
+	GridCellSize = 1000.0f;
+
+	NearRelevancyCells = 1;
+	FarRelevancyCells = 3;
+	FarTierPriorityScale = 0.25f;
+
+	MaintenanceCursor = 0;
+}
+
+void UItemWorldManager::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// Config values are loaded now
+	Grid.CellSize = FMath::Max(GridCellSize, 1.0f);
+}
+
+bool UItemWorldManager::AreRelevancyTiersEnabled()
+{
+	return CVarItemRelevancyTiers.GetValueOnGameThread() != 0;
+}
+
+EItemRelevancyTier UItemWorldManager::GetRelevancyTier(const FIntVector &ItemCell, const FVector &ViewLocation) const
+{
+	if (!AreRelevancyTiersEnabled())
+	{
+		return EItemRelevancyTier::IRT_Near;
+	}
+
+	INC_DWORD_STAT(STAT_WorldItemRelevancyChecks);
+
+	// Chebyshev distance in cells
+	const FIntVector Delta = Grid.GetCell(ViewLocation) - ItemCell;
+	const int32 CellDistance = FMath::Max3(FMath::Abs(Delta.X), FMath::Abs(Delta.Y), FMath::Abs(Delta.Z));
+
+	if (CellDistance <= NearRelevancyCells)
+	{
+		return EItemRelevancyTier::IRT_Near;
+	}
+	else if (CellDistance <= FarRelevancyCells)
+	{
+		return EItemRelevancyTier::IRT_Far;
+	}
+	return EItemRelevancyTier::IRT_Culled;
+}
+
+void UItemWorldManager::RegisterItem(AItemWorldActor *Item)
+{
+	if (Item == nullptr || Item->WorldItemIndex != INDEX_NONE)
+	{
+		return;
+	}
+
+	UWorld *World = GetWorld();
+	const float Now = World ? World->GetTimeSeconds() : 0.0f;
+
+	Item->WorldManager = this;
+	Item->WorldItemIndex = WorldItems.Add(Item);
+	Item->SpawnTime = Now;
+	Item->LastRelevantTime = Now;
+	Item->GridCell = Grid.GetCell(Item->GetActorLocation());
+	Grid.Add(Item, Item->GridCell);
+
+	SET_DWORD_STAT(STAT_WorldItems, WorldItems.Num());
+}
+
+void UItemWorldManager::UnregisterItem(AItemWorldActor *Item)
+{
+	if (Item == nullptr || !WorldItems.IsValidIndex(Item->WorldItemIndex) || WorldItems[Item->WorldItemIndex] != Item)
+	{
+		return;
+	}
+
+	const int32 Index = Item->WorldItemIndex;
+	Grid.Remove(Item, Item->GridCell);
+
+	// Swap the last item into the hole and fix up its index
+	WorldItems.RemoveAtSwap(Index, 1, false);
+	if (WorldItems.IsValidIndex(Index))
+	{
+		WorldItems[Index]->WorldItemIndex = Index;
+	}
+
+	Item->WorldItemIndex = INDEX_NONE;
+	Item->WorldManager = nullptr;
+
+	SET_DWORD_STAT(STAT_WorldItems, WorldItems.Num());
+}
+
+void UItemWorldManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_WorldItemMaintenance);
+
+	Stats.LastSliceItems = 0;
+	Stats.LastSliceMicroseconds = 0.0f;
+
+	UWorld *World = GetWorld();
+	if (World == nullptr || WorldItems.Num() == 0)
+	{
+		return;
+	}
+
+	const uint32 StartCycles = FPlatformTime::Cycles();
+	const double BudgetSeconds = MaintenanceBudgetMicroseconds * 0.000001;
+	const float Now = World->GetTimeSeconds();
+
+	// Gather player view locations once per slice. There are only a handful.
+	TArray<FVector> ViewLocations;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController *PC = It->Get();
+		if (PC != nullptr && PC->GetPawn() != nullptr)
+		{
+			ViewLocations.Add(PC->GetPawn()->GetActorLocation());
+		}
+	}
+
+	// Visit each item at most once per slice, even when the budget would allow more
+	const int32 MaxVisits = WorldItems.Num();
+	int32 Visits = 0;
+	while (Visits < MaxVisits && WorldItems.Num() > 0)
+	{
+		if (FPlatformTime::ToSeconds(FPlatformTime::Cycles() - StartCycles) >= BudgetSeconds)
+		{
+			break;
+		}
+
+		if (!WorldItems.IsValidIndex(MaintenanceCursor))
+		{
+			MaintenanceCursor = 0;
+		}
+
+		AItemWorldActor *Item = WorldItems[MaintenanceCursor];
+		Visits++;
+
+		MaintainItem(Item, Now, ViewLocations);
+
+		// Despawns swap other items into the cursor position. Only advance
+		// if the item we just visited is still where we left it.
+		if (WorldItems.IsValidIndex(MaintenanceCursor) && WorldItems[MaintenanceCursor] == Item)
+		{
+			MaintenanceCursor++;
+		}
+	}
+
+	Stats.LastSliceItems = Visits;
+	Stats.LastSliceMicroseconds = FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - StartCycles) * 1000.0f;
+}
+
+bool UItemWorldManager::CanMaintain(const AItemWorldActor *Item) const
+{
+	return Item != nullptr && !Item->IsPendingKill() && Item->bDropped
+		&& Item->ItemTypeReference != nullptr && Item->ItemTypeReference->CanDrop;
+}
+
+bool UItemWorldManager::MaintainItem(AItemWorldActor *Item, float Now, const TArray<FVector> &ViewLocations)
+{
+	if (!CanMaintain(Item))
+	{
+		return true;
+	}
+
+	// Expire by age
+	if (MaxItemLifetime > 0.0f && Now - Item->SpawnTime >= MaxItemLifetime)
+	{
+		UE_LOG(InventorySystemLog, Verbose, TEXT("Despawning expired world item '%s'"), *Item->GetName());
+		Stats.TotalExpired++;
+		INC_DWORD_STAT(STAT_WorldItemsDespawned);
+		Item->Destroy();
+		return false;
+	}
+
+	// Expire by relevance
+	if (IrrelevantLifetime > 0.0f)
+	{
+		const float RelevanceDistanceSq = FMath::Square(RelevanceDistance);
+		const FVector ItemLocation = Item->GetActorLocation();
+		for (const FVector &ViewLocation : ViewLocations)
+		{
+			if (FVector::DistSquared(ItemLocation, ViewLocation) <= RelevanceDistanceSq)
+			{
+				Item->LastRelevantTime = Now;
+				break;
+			}
+		}
+
+		if (Now - Item->LastRelevantTime >= IrrelevantLifetime)
+		{
+			UE_LOG(InventorySystemLog, Verbose, TEXT("Despawning irrelevant world item '%s'"), *Item->GetName());
+			Stats.TotalIrrelevant++;
+			INC_DWORD_STAT(STAT_WorldItemsDespawned);
+			Item->Destroy();
+			return false;
+		}
+	}
+
+	MergeNearby(Item);
+	return true;
+}
+
+void UItemWorldManager::MergeNearby(AItemWorldActor *Item)
+{
+	const int32 MaxStackSize = Item->ItemTypeReference->MaxStackSize;
+	if (MergeRadius <= 0.0f || MaxStackSize <= 1 || Item->StackSize >= MaxStackSize)
+	{
+		return;
+	}
+
+	const FName &ItemID = Item->ItemTypeReference->ID;
+	const FVector ItemLocation = Item->GetActorLocation();
+	const float MergeRadiusSq = FMath::Square(MergeRadius);
+
+	// Collect first; destroying items while walking the grid would invalidate the cell arrays
+	TArray<AItemWorldActor*, TInlineAllocator<8>> Candidates;
+	Grid.ForEachInRadius(ItemLocation, MergeRadius, [&](AItemWorldActor *Other)
+	{
+		if (Other != Item && CanMaintain(Other)
+			&& Other->ItemTypeReference->ID.IsEqual(ItemID)
+			&& FVector::DistSquared(ItemLocation, Other->GetActorLocation()) <= MergeRadiusSq)
+		{
+			Candidates.Add(Other);
+		}
+	});
+
+	const UBaseItem *ItemType = Item->ItemTypeReference;
+	const float Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0f;
+
+	for (AItemWorldActor *Other : Candidates)
+	{
+		const int32 Transfer = FMath::Min(MaxStackSize - Item->StackSize, Other->StackSize);
+		if (Transfer <= 0)
+		{
+			break;
+		}
+
+		if (!ItemType->CanMergeDecay(Item->DecayState, Other->DecayState, Now))
+		{
+			continue;
+		}
+
+		if (Item->DecayState.IsDecaying() || Other->DecayState.IsDecaying())
+		{
+			Item->DecayState = FItemDecayState::Merge(Item->DecayState, Item->StackSize, Other->DecayState, Transfer, ItemType->DecayMergePolicy, Now);
+		}
+
+		// Stack changes wake the dormant pickups for one replication update
+		Item->SetStackSize(Item->StackSize + Transfer);
+		Other->SetStackSize(Other->StackSize - Transfer);
+
+		if (Other->StackSize <= 0)
+		{
+			Stats.TotalMerged++;
+			INC_DWORD_STAT(STAT_WorldItemsMerged);
+			Other->Destroy();
+		}
+	}
+}
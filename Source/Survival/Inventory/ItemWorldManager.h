@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "ItemWorldGrid.h"
+#include "ItemWorldManager.generated.h"
+
+class AItemWorldActor;
+
+/**
+* Network relevancy tier of a world pickup relative to a viewer
+*/
+UENUM(BlueprintType)
+enum class EItemRelevancyTier : uint8
+{
+	IRT_Near		UMETA(DisplayName = "Near"),
+	IRT_Far			UMETA(DisplayName = "Far"),
+	IRT_Culled		UMETA(DisplayName = "Culled")
+};
+
+/**
+* Counters reported by the world item maintenance service
+*/
+USTRUCT(BlueprintType)
+struct FItemWorldMaintenanceStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	// Pickups merged into a nearby stack since the session started
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "World Items")
+	int32 TotalMerged;
+
+	// Pickups removed because they got too old
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "World Items")
+	int32 TotalExpired;
+
+	// Pickups removed because no player has been near them for too long
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "World Items")
+	int32 TotalIrrelevant;
+
+	// Number of pickups visited by the last slice
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "World Items")
+	int32 LastSliceItems;
+
+	// Time spent in the last slice
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "World Items")
+	float LastSliceMicroseconds;
+
+	FItemWorldMaintenanceStats()
+	{
+		TotalMerged = 0;
+		TotalExpired = 0;
+		TotalIrrelevant = 0;
+		LastSliceItems = 0;
+		LastSliceMicroseconds = 0.0f;
+	}
+};
+
+/**
+* Server side service keeping track of every AItemWorldActor in the world.
+*
+* Runs a time-sliced maintenance pass that merges nearby pickups with the same
+* ItemID into one stack (up to MaxStackSize) and despawns pickups that are too old
+* or have been out of every player's reach for too long. Each frame only visits as many
+* items as fit in MaintenanceBudgetMicroseconds, continuing where the last slice stopped.
+*
+* Only pickups dropped by players (AItemWorldActor::bDropped) are tracked. Placed pickups
+* and loot spawner pickups are never merged or despawned, nor are items that cannot be
+* dropped (keys etc.).
+*
+* The same spatial hash drives network relevancy: pickups are bucketed into tiers
+* by their cell distance to the viewer, so a relevancy check is a constant time cell
+* comparison rather than a distance query against the whole level.
+*/
+UCLASS(Config = Game)
+class SURVIVAL_API UItemWorldManager : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	UItemWorldManager();
+
+	// Hard per-frame time budget for the maintenance slice
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "World Items")
+	float MaintenanceBudgetMicroseconds;
+
+	// Pickups with the same ItemID closer than this are merged. 0 disables merging.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "World Items")
+	float MergeRadius;
+
+	// Pickups older than this (seconds) are despawned. 0 disables expiry by age.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "World Items")
+	float MaxItemLifetime;
+
+	// A pickup is relevant while any player pawn is within this distance
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "World Items")
+	float RelevanceDistance;
+
+	// Pickups that have not been relevant for this long (seconds) are despawned. 0 disables.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "World Items")
+	float IrrelevantLifetime;
+
+	// Cell size of the spatial hash used for neighbour lookups
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "World Items")
+	float GridCellSize;
+
+	// Pickups within this many cells of the viewer's cell are in the near tier
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "World Items|Network")
+	int32 NearRelevancyCells;
+
+	// Pickups within this many cells of the viewer's cell are in the far tier. Beyond that they are culled.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "World Items|Network")
+	int32 FarRelevancyCells;
+
+	// Net priority multiplier for pickups in the far tier
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "World Items|Network")
+	float FarTierPriorityScale;
+
+	// Whether pickups use cell tiers for relevancy (Survival.ItemRelevancyTiers)
+	static bool AreRelevancyTiersEnabled();
+
+	// Get the relevancy tier of an item cell for a viewer at ViewLocation. Returns IRT_Near if tiering is disabled.
+	EItemRelevancyTier GetRelevancyTier(const FIntVector &ItemCell, const FVector &ViewLocation) const;
+
+	// Called by pickups when they begin/end play on the server
+	void RegisterItem(AItemWorldActor *Item);
+	void UnregisterItem(AItemWorldActor *Item);
+
+	UFUNCTION(BlueprintCallable, Category = "World Items")
+	FItemWorldMaintenanceStats GetMaintenanceStats() const
+	{
+		return Stats;
+	}
+
+	FORCEINLINE int32 GetNumWorldItems() const
+	{
+		return WorldItems.Num();
+	}
+
+	virtual void PostInitProperties() override;
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	// Runs merge/expiry checks on a single item. Returns false if the item was despawned.
+	bool MaintainItem(AItemWorldActor *Item, float Now, const TArray<FVector> &ViewLocations);
+
+	// Pulls stack size from nearby pickups with the same ItemID into Item
+	void MergeNearby(AItemWorldActor *Item);
+
+	// Utility to check if an item takes part in maintenance at all
+	bool CanMaintain(const AItemWorldActor *Item) const;
+
+	UPROPERTY()
+	TArray<AItemWorldActor*> WorldItems;
+
+	FItemWorldGrid Grid;
+
+	// Index into WorldItems where the next slice starts
+	int32 MaintenanceCursor;
+
+	FItemWorldMaintenanceStats Stats;
+};
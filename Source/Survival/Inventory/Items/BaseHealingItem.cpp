@@ -3,8 +3,15 @@
 #include "Survival.h"
 #include "SurvivalCharacter.h"
 #include "BaseHealingItem.h"
+#include "StatusEffectManager.h"
 
 
+UBaseHealingItem::UBaseHealingItem()
+{
+	HealDuration = 0.0f;
+	HealInterval = 1.0f;
+}
+
 bool UBaseHealingItem::OnUse_Implementation(class ASurvivalCharacter *Target)
 {
 	if (!Target || !Target->IsValidLowLevel())
@@ -13,6 +20,15 @@ bool UBaseHealingItem::OnUse_Implementation(class ASurvivalCharacter *Target)
 		return false;
 	}
 
+	// Heal over time. Only the server has the status effect manager, clients heal right away as before.
+	UStatusEffectManager *StatusEffects = UStatusEffectManager::Get(Target);
+	if (StatusEffects != nullptr && HealDuration > 0.0f && HealInterval > 0.0f)
+	{
+		const int32 NumTicks = FMath::Max(FMath::RoundToInt(HealDuration / HealInterval), 1);
+		StatusEffects->ApplyEffect(Target, EStatusEffectType::SE_Regeneration, HealAmount / NumTicks, HealInterval, NumTicks);
+		return true;
+	}
+
 	Target->TakeHeal(this->HealAmount, this);
 	return true;
 }
@@ -15,10 +15,19 @@ class SURVIVAL_API UBaseHealingItem : public UBaseItem, public IUsableInterface
 	GENERATED_BODY()
 	
 public:
+	UBaseHealingItem();
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Healing Item")
 	float HealAmount;
 
+	/** Seconds HealAmount is spread over. 0 heals instantly. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Healing Item")
+	float HealDuration;
+
+	/** Seconds between heals while HealDuration runs */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Healing Item")
+	float HealInterval;
+
 	// IUsableInterface
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "Usable Interface")
 	bool OnUse(class ASurvivalCharacter *Target);
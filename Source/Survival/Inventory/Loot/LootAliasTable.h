@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+* Walker/Vose alias table for O(1) sampling of a discrete weighted distribution.
+* Built once from the weights, after which every sample costs one random index
+* and one random float, regardless of how many outcomes there are.
+*
+* Sampling is read-only and safe to do from several threads at once,
+* as long as each thread uses its own random stream.
+*/
+struct FLootAliasTable
+{
+	// Probability of keeping column i rather than taking its alias
+	TArray<float> Probability;
+
+	// Outcome to take if column i is not kept
+	TArray<int32> Alias;
+
+	FORCEINLINE int32 Num() const
+	{
+		return Probability.Num();
+	}
+
+	// Builds the table from non-negative weights. Returns false if they sum to zero.
+	bool Build(const TArray<float> &Weights)
+	{
+		const int32 Count = Weights.Num();
+		Probability.Reset(Count);
+		Alias.Reset(Count);
+
+		float TotalWeight = 0.0f;
+		for (float Weight : Weights)
+		{
+			TotalWeight += FMath::Max(Weight, 0.0f);
+		}
+		if (Count == 0 || TotalWeight <= 0.0f)
+		{
+			return false;
+		}
+
+		Probability.AddUninitialized(Count);
+		Alias.AddUninitialized(Count);
+
+		// Scale so the average column is exactly 1
+		TArray<float> Scaled;
+		Scaled.AddUninitialized(Count);
+		TArray<int32> Small, Large;
+		Small.Reserve(Count);
+		Large.Reserve(Count);
+
+		for (int32 i = 0; i < Count; i++)
+		{
+			Scaled[i] = FMath::Max(Weights[i], 0.0f) * Count / TotalWeight;
+			if (Scaled[i] < 1.0f)
+			{
+				Small.Add(i);
+			}
+			else
+			{
+				Large.Add(i);
+			}
+		}
+
+		// Fill each underfull column with the remainder of an overfull one
+		while (Small.Num() > 0 && Large.Num() > 0)
+		{
+			const int32 Less = Small.Pop(false);
+			const int32 More = Large.Pop(false);
+
+			Probability[Less] = Scaled[Less];
+			Alias[Less] = More;
+
+			Scaled[More] = (Scaled[More] + Scaled[Less]) - 1.0f;
+			if (Scaled[More] < 1.0f)
+			{
+				Small.Add(More);
+			}
+			else
+			{
+				Large.Add(More);
+			}
+		}
+
+		// Whatever is left is full up to float error
+		for (int32 i : Large)
+		{
+			Probability[i] = 1.0f;
+			Alias[i] = i;
+		}
+		for (int32 i : Small)
+		{
+			Probability[i] = 1.0f;
+			Alias[i] = i;
+		}
+
+		return true;
+	}
+
+	// Draws an outcome index. The table must have been built successfully.
+	FORCEINLINE int32 Sample(FRandomStream &Stream) const
+	{
+		const int32 Column = Stream.RandHelper(Probability.Num());
+		return Stream.GetFraction() < Probability[Column] ? Column : Alias[Column];
+	}
+};
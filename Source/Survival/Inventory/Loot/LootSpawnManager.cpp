@@ -0,0 +1,219 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "LootSpawnManager.h"
+#include "LootSpawnPoint.h"
+#include "LootTable.h"
+#include "Inventory/ItemWorldActor.h"
+#include "Async/ParallelFor.h"
+#include "EngineUtils.h"
+
+DECLARE_CYCLE_STAT(TEXT("Loot Roll"), STAT_LootRoll, STATGROUP_Survival);
+DECLARE_CYCLE_STAT(TEXT("Loot Spawn"), STAT_LootSpawn, STATGROUP_Survival);
+
+
+ULootSpawnManager::ULootSpawnManager()
+{
+	Seed = 1337;
+	MinParallelBatchSize = 64;
+	ItemWorldActorClass = AItemWorldActor::StaticClass();
+}
+
+void ULootSpawnManager::PopulateAll()
+{
+	UWorld *World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	Points.Reset();
+	RespawnHeap.Reset();
+
+	TArray<int32> PointIndices;
+	for (TActorIterator<ALootSpawnPoint> It(World); It; ++It)
+	{
+		ALootSpawnPoint *SpawnPoint = *It;
+		if (SpawnPoint->LootTable == nullptr)
+		{
+			UE_LOG(InventorySystemLog, Warning, TEXT("Loot spawn point '%s' has no loot table."), *SpawnPoint->GetName());
+			continue;
+		}
+
+		FLootPoint Point;
+		Point.SpawnPoint = SpawnPoint;
+		// Path names are stable between runs, unlike FName hashes
+		Point.NameHash = FCrc::StrCrc32(*SpawnPoint->GetPathName());
+		Point.Generation = 0;
+
+		PointIndices.Add(Points.Add(Point));
+	}
+
+	RollAndSpawn(PointIndices);
+
+	UE_LOG(InventorySystemLog, Log, TEXT("Populated %d loot spawn points (%d spawned) - roll %.0fus, spawn %.0fus"),
+		LastSpawnStats.Points, LastSpawnStats.Spawned, LastSpawnStats.RollMicroseconds, LastSpawnStats.SpawnMicroseconds);
+}
+
+void ULootSpawnManager::Tick(float DeltaTime)
+{
+	UWorld *World = GetWorld();
+	if (World == nullptr || RespawnHeap.Num() == 0)
+	{
+		return;
+	}
+
+	// Pop every respawn that is due and roll them as one batch
+	const float Now = World->GetTimeSeconds();
+	TArray<int32> PointIndices;
+	while (RespawnHeap.Num() > 0 && RespawnHeap.HeapTop().Time <= Now)
+	{
+		FLootRespawn Respawn;
+		RespawnHeap.HeapPop(Respawn, false);
+		PointIndices.Add(Respawn.PointIndex);
+	}
+
+	if (PointIndices.Num() > 0)
+	{
+		RollAndSpawn(PointIndices);
+	}
+}
+
+void ULootSpawnManager::OnLootDestroyed(AActor *DestroyedActor)
+{
+	int32 PointIndex = INDEX_NONE;
+	if (!ActiveLoot.RemoveAndCopyValue(DestroyedActor, PointIndex) || !Points.IsValidIndex(PointIndex))
+	{
+		return;
+	}
+
+	ALootSpawnPoint *SpawnPoint = Points[PointIndex].SpawnPoint.Get();
+	UWorld *World = GetWorld();
+	if (SpawnPoint != nullptr && World != nullptr && SpawnPoint->RespawnDelay > 0.0f)
+	{
+		FLootRespawn Respawn;
+		Respawn.Time = World->GetTimeSeconds() + SpawnPoint->RespawnDelay;
+		Respawn.PointIndex = PointIndex;
+		RespawnHeap.HeapPush(Respawn);
+	}
+}
+
+void ULootSpawnManager::RollAndSpawn(const TArray<int32> &PointIndices)
+{
+	UWorld *World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	struct FLootRoll
+	{
+		int32 PointIndex;
+		float RespawnDelay;
+		ULootTable *LootTable;
+		int32 SpawnFlags;
+		int32 Seed;
+		FTransform Transform;
+
+		int32 EntryIndex;
+		int32 StackSize;
+	};
+
+	LastSpawnStats = FLootSpawnStats();
+	LastSpawnStats.Points = PointIndices.Num();
+
+	// Game thread: snapshot the points and make sure every sampler we need is built
+	TArray<FLootRoll> Rolls;
+	Rolls.Reserve(PointIndices.Num());
+	for (int32 PointIndex : PointIndices)
+	{
+		FLootPoint &Point = Points[PointIndex];
+		ALootSpawnPoint *SpawnPoint = Point.SpawnPoint.Get();
+		if (SpawnPoint == nullptr || SpawnPoint->LootTable == nullptr)
+		{
+			continue;
+		}
+
+		SpawnPoint->LootTable->PrepareSampler(SpawnPoint->SpawnFlags);
+
+		FLootRoll Roll;
+		Roll.PointIndex = PointIndex;
+		Roll.RespawnDelay = SpawnPoint->RespawnDelay;
+		Roll.LootTable = SpawnPoint->LootTable;
+		Roll.SpawnFlags = SpawnPoint->SpawnFlags;
+		Roll.Seed = (int32)HashCombine(HashCombine((uint32)Seed, Point.NameHash), (uint32)Point.Generation);
+		Roll.Transform = SpawnPoint->GetActorTransform();
+		Roll.EntryIndex = INDEX_NONE;
+		Roll.StackSize = 0;
+		Rolls.Add(Roll);
+
+		Point.Generation++;
+	}
+
+	// Worker threads: sample the tables. Read only access to the prepared samplers.
+	{
+		SCOPE_CYCLE_COUNTER(STAT_LootRoll);
+		const uint32 StartCycles = FPlatformTime::Cycles();
+
+		ParallelFor(Rolls.Num(), [&Rolls](int32 Index)
+		{
+			FLootRoll &Roll = Rolls[Index];
+			const FLootTableSampler *Sampler = Roll.LootTable->FindSampler(Roll.SpawnFlags);
+			if (Sampler == nullptr || Sampler->EntryIndices.Num() == 0)
+			{
+				return;
+			}
+
+			FRandomStream Stream(Roll.Seed);
+			Roll.EntryIndex = Sampler->EntryIndices[Sampler->AliasTable.Sample(Stream)];
+			if (Roll.EntryIndex != INDEX_NONE)
+			{
+				const FLootTableEntry &Entry = Roll.LootTable->Entries[Roll.EntryIndex];
+				Roll.StackSize = Stream.RandRange(FMath::Max(Entry.MinStackSize, 1), FMath::Max(Entry.MaxStackSize, Entry.MinStackSize));
+			}
+		}, Rolls.Num() < MinParallelBatchSize);
+
+		LastSpawnStats.RollMicroseconds = FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - StartCycles) * 1000.0f;
+	}
+
+	// Game thread: create the pickups
+	{
+		SCOPE_CYCLE_COUNTER(STAT_LootSpawn);
+		const uint32 StartCycles = FPlatformTime::Cycles();
+
+		UClass *PickupClass = ItemWorldActorClass ? *ItemWorldActorClass : AItemWorldActor::StaticClass();
+		const float Now = World->GetTimeSeconds();
+		for (const FLootRoll &Roll : Rolls)
+		{
+			if (Roll.EntryIndex == INDEX_NONE)
+			{
+				// Rolled empty. Try again later, as if the loot had been taken.
+				if (Roll.RespawnDelay > 0.0f)
+				{
+					FLootRespawn Respawn;
+					Respawn.Time = Now + Roll.RespawnDelay;
+					Respawn.PointIndex = Roll.PointIndex;
+					RespawnHeap.HeapPush(Respawn);
+				}
+				continue;
+			}
+
+			AItemWorldActor *Pickup = World->SpawnActorDeferred<AItemWorldActor>(PickupClass, Roll.Transform,
+				nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+			if (Pickup == nullptr)
+			{
+				continue;
+			}
+
+			Pickup->ItemTypeClass = Roll.LootTable->Entries[Roll.EntryIndex].ItemTypeClass;
+			Pickup->StackSize = Roll.StackSize;
+			Pickup->FinishSpawning(Roll.Transform);
+
+			Pickup->OnDestroyed.AddDynamic(this, &ULootSpawnManager::OnLootDestroyed);
+			ActiveLoot.Add(Pickup, Roll.PointIndex);
+			LastSpawnStats.Spawned++;
+		}
+
+		LastSpawnStats.SpawnMicroseconds = FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - StartCycles) * 1000.0f;
+	}
+}
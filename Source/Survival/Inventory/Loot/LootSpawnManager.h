@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "LootSpawnManager.generated.h"
+
+class ALootSpawnPoint;
+class AItemWorldActor;
+
+/**
+* Timings of the last loot population batch
+*/
+USTRUCT(BlueprintType)
+struct FLootSpawnStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Loot)
+	int32 Points;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Loot)
+	int32 Spawned;
+
+	// Time spent rolling the loot (worker threads)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Loot)
+	float RollMicroseconds;
+
+	// Time spent creating the pickup actors (game thread)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Loot)
+	float SpawnMicroseconds;
+
+	FLootSpawnStats()
+	{
+		Points = 0;
+		Spawned = 0;
+		RollMicroseconds = 0.0f;
+		SpawnMicroseconds = 0.0f;
+	}
+};
+
+/**
+* Server side service filling loot spawn points from their loot tables.
+*
+* All points are populated when play starts, and again RespawnDelay seconds after
+* their loot is taken. Rolls are seeded per point and generation, so the same seed
+* always produces the same loot no matter how the work is split between threads.
+* Rolling happens on worker threads; only creating the pickup actors happens on the game thread.
+*/
+UCLASS(Config = Game)
+class SURVIVAL_API ULootSpawnManager : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	ULootSpawnManager();
+
+	// World seed for all loot rolls
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Loot)
+	int32 Seed;
+
+	// Batches smaller than this are rolled on the game thread
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Loot)
+	int32 MinParallelBatchSize;
+
+	// Pickup actor class spawned for rolled loot
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Loot)
+	TSubclassOf<AItemWorldActor> ItemWorldActorClass;
+
+	// Gathers every loot spawn point in the world and populates them
+	void PopulateAll();
+
+	UFUNCTION(BlueprintCallable, Category = Loot)
+	FLootSpawnStats GetLastSpawnStats() const
+	{
+		return LastSpawnStats;
+	}
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	// Called when loot we spawned is picked up or otherwise destroyed
+	UFUNCTION()
+	void OnLootDestroyed(AActor *DestroyedActor);
+
+	// Rolls loot for the points on worker threads, then spawns the results
+	void RollAndSpawn(const TArray<int32> &PointIndices);
+
+	struct FLootPoint
+	{
+		TWeakObjectPtr<ALootSpawnPoint> SpawnPoint;
+
+		// Stable per point seed component
+		uint32 NameHash;
+
+		// Number of times this point has been rolled
+		int32 Generation;
+	};
+
+	struct FLootRespawn
+	{
+		float Time;
+		int32 PointIndex;
+
+		FORCEINLINE bool operator<(const FLootRespawn &Other) const
+		{
+			return Time < Other.Time;
+		}
+	};
+
+	TArray<FLootPoint> Points;
+
+	// Loot actors currently in the world, and the point they came from
+	TMap<AActor*, int32> ActiveLoot;
+
+	// Min-heap of pending respawns by time
+	TArray<FLootRespawn> RespawnHeap;
+
+	FLootSpawnStats LastSpawnStats;
+};
@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "LootSpawnPoint.h"
+
+
+// Sets default values
+ALootSpawnPoint::ALootSpawnPoint()
+{
+	// Spawn points are passive markers
+	PrimaryActorTick.bCanEverTick = false;
+	bHidden = true;
+
+	SceneComponent = CreateDefaultSubobject<USceneComponent>(TEXT("SceneComponent"));
+	RootComponent = SceneComponent;
+
+	LootTable = nullptr;
+	SpawnFlags = 0;
+	RespawnDelay = 0.0f;
+}
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameFramework/Actor.h"
+#include "LootSpawnPoint.generated.h"
+
+/**
+* Placed in levels to mark where loot can appear.
+* The loot itself is rolled and spawned by ULootSpawnManager.
+*/
+UCLASS()
+class SURVIVAL_API ALootSpawnPoint : public AActor
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleDefaultsOnly, Category = Loot)
+	class USceneComponent *SceneComponent;
+
+public:
+	// Sets default values for this actor's properties
+	ALootSpawnPoint();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Loot)
+	class ULootTable *LootTable;
+
+	// Categories of this point; loot table entries can require them
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Loot, meta = (Bitmask, BitmaskEnum = "ELootSpawnFlags"))
+	int32 SpawnFlags;
+
+	// Seconds after the loot is taken before the point rolls again. 0 never respawns.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Loot)
+	float RespawnDelay;
+};
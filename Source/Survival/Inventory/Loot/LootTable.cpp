@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "LootTable.h"
+
+/////////////////////////////////////////////////////
+// ULootTableFactory
+
+ULootTableFactory::ULootTableFactory(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	bCreateNew = true;
+	bEditAfterNew = true;
+	SupportedClass = ULootTable::StaticClass();
+}
+
+UObject* ULootTableFactory::FactoryCreateNew(UClass* Class, UObject* InParent, FName Name, EObjectFlags Flags, UObject* Context, FFeedbackContext* Warn)
+{
+	ULootTable* NewObjectAsset = NewObject<ULootTable>(InParent, Class, Name, Flags | RF_Transactional);
+	return NewObjectAsset;
+}
+
+/////////////////////////////////////////////////////
+// ULootTable
+
+ULootTable::ULootTable()
+{
+	EmptyWeight = 0.0f;
+}
+
+const FLootTableSampler *ULootTable::PrepareSampler(int32 SpawnFlags)
+{
+	check(IsInGameThread());
+
+	const FLootTableSampler *Existing = Samplers.Find(SpawnFlags);
+	if (Existing != nullptr)
+	{
+		return Existing->EntryIndices.Num() > 0 ? Existing : nullptr;
+	}
+
+	FLootTableSampler NewSampler;
+	TArray<float> Weights;
+
+	for (int32 i = 0; i < Entries.Num(); i++)
+	{
+		FLootTableEntry &Entry = Entries[i];
+		if (Entry.ItemTypeClass == nullptr || Entry.Weight <= 0.0f
+			|| (Entry.RequiredSpawnFlags & SpawnFlags) != Entry.RequiredSpawnFlags)
+		{
+			continue;
+		}
+
+		const UBaseItem *ItemDefaults = Entry.ItemTypeClass->GetDefaultObject<UBaseItem>();
+		Entry.ItemID = ItemDefaults ? ItemDefaults->ID : NAME_None;
+
+		Weights.Add(Entry.Weight);
+		NewSampler.EntryIndices.Add(i);
+	}
+
+	if (EmptyWeight > 0.0f && Weights.Num() > 0)
+	{
+		Weights.Add(EmptyWeight);
+		NewSampler.EntryIndices.Add(INDEX_NONE);
+	}
+
+	if (!NewSampler.AliasTable.Build(Weights))
+	{
+		NewSampler.EntryIndices.Empty();
+	}
+
+	// Cache failures as well, so we don't rebuild them for every spawn point
+	const FLootTableSampler &Added = Samplers.Add(SpawnFlags, MoveTemp(NewSampler));
+	return Added.EntryIndices.Num() > 0 ? &Added : nullptr;
+}
+
+#if WITH_EDITOR
+void ULootTable::PostEditChangeProperty(FPropertyChangedEvent &PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	Samplers.Empty();
+}
+#endif
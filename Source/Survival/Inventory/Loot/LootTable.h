@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "UObject/NoExportTypes.h"
+#include "UnrealEd.h"
+#include "LootAliasTable.h"
+#include "LootTable.generated.h"
+
+/**
+* Spawn point categories loot table entries can be restricted to
+*/
+UENUM(BlueprintType, meta = (Bitflags))
+enum class ELootSpawnFlags : uint8
+{
+	LSF_Indoors			UMETA(DisplayName = "Indoors"),
+	LSF_Outdoors		UMETA(DisplayName = "Outdoors"),
+	LSF_Residential		UMETA(DisplayName = "Residential"),
+	LSF_Medical			UMETA(DisplayName = "Medical"),
+	LSF_Military		UMETA(DisplayName = "Military")
+};
+
+USTRUCT(BlueprintType)
+struct FLootTableEntry
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loot Table")
+	TSubclassOf<class UBaseItem> ItemTypeClass;
+
+	// Resolved from the item class defaults when the table is sampled
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Loot Table")
+	FName ItemID;
+
+	// Relative chance of this entry being picked
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loot Table")
+	float Weight;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loot Table")
+	int32 MinStackSize;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loot Table")
+	int32 MaxStackSize;
+
+	// The entry is only available at spawn points that have all of these flags
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loot Table", meta = (Bitmask, BitmaskEnum = "ELootSpawnFlags"))
+	int32 RequiredSpawnFlags;
+
+	FLootTableEntry()
+	{
+		ItemTypeClass = nullptr;
+		ItemID = NAME_None;
+		Weight = 1.0f;
+		MinStackSize = 1;
+		MaxStackSize = 1;
+		RequiredSpawnFlags = 0;
+	}
+};
+
+/**
+* Precomputed sampler for the entries of a loot table available under one set of spawn flags
+*/
+struct FLootTableSampler
+{
+	FLootAliasTable AliasTable;
+
+	// Maps alias table outcomes to entry indices. INDEX_NONE means "spawn nothing".
+	TArray<int32> EntryIndices;
+};
+
+UCLASS()
+class ULootTableFactory : public UFactory
+{
+	GENERATED_UCLASS_BODY()
+
+	virtual UObject *FactoryCreateNew(UClass *Class, UObject *InParent, FName Name, EObjectFlags Flags, UObject* Context, FFeedbackContext* Warn) override;
+};
+
+/**
+* Data driven loot table used by loot spawn points.
+* Has its own object factory in the editor (Create new asset -> Misc -> Loot Table)
+*/
+UCLASS(Blueprintable, BlueprintType)
+class SURVIVAL_API ULootTable : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	ULootTable();
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loot Table")
+	TArray<FLootTableEntry> Entries;
+
+	// Relative chance of a spawn point staying empty
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loot Table")
+	float EmptyWeight;
+
+	// Builds (game thread only) and returns the sampler for spawn points with SpawnFlags.
+	// Returns nullptr if nothing can spawn there.
+	const FLootTableSampler *PrepareSampler(int32 SpawnFlags);
+
+	// Returns an already prepared sampler. Safe to call from worker threads.
+	FORCEINLINE const FLootTableSampler *FindSampler(int32 SpawnFlags) const
+	{
+		return Samplers.Find(SpawnFlags);
+	}
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent &PropertyChangedEvent) override;
+#endif
+
+private:
+	// Samplers by spawn flags. Built on demand, emptied when the table is edited.
+	TMap<int32, FLootTableSampler> Samplers;
+};
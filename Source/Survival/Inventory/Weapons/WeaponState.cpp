@@ -1,24 +0,0 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#include "Survival.h"
-#include "WeaponState.h"
-
-/*
-ASurvivalCharacter *UWeaponState::GetCharOwner()
-{
-	return GetOuterUBaseWeaponItem()->GetTypedOuter<ASurvivalCharacter>();
-}
-
-UWorld *UWeaponState::GetWorld() const
-{
-	ASurvivalCharacter *Char = GetOuterUBaseWeaponItem()->GetTypedOuter<ASurvivalCharacter>();
-	if (Char && Char->IsValidLowLevel())
-	{
-		return Char->GetWorld();
-	}
-	else
-	{
-		return nullptr;
-	}
-}*/
-
@@ -1,8 +0,0 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#include "Survival.h"
-#include "WeaponStateEquipping.h"
-
-
-
-
@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "WeaponStateMachine.h"
+
+// Indexed by EWeaponState. Keep in the same order as the enum.
+const FWeaponStateHandlers FWeaponStateTable::Handlers[] =
+{
+	/* WS_Invalid */		{ nullptr,									nullptr,	nullptr,									false },
+	/* WS_Inactive */		{ nullptr,									nullptr,	nullptr,									false },
+	/* WS_Idle */			{ nullptr,									nullptr,	&FWeaponStateTable::TickIdle,				true },
+	/* WS_Equipping */		{ &FWeaponStateTable::EnterEquipping,		nullptr,	&FWeaponStateTable::TickEquipping,			true },
+	/* WS_UnEquipping */	{ nullptr,									nullptr,	&FWeaponStateTable::TickUnEquipping,		true },
+	/* WS_Firing */			{ &FWeaponStateTable::EnterFiring,			nullptr,	&FWeaponStateTable::TickFiring,				true },
+	/* WS_Reloading */		{ &FWeaponStateTable::EnterReloading,		nullptr,	&FWeaponStateTable::TickReloading,			true },
+	/* WS_AmmoEmpty */		{ &FWeaponStateTable::EnterAmmoEmpty,		nullptr,	nullptr,									false }
+};
+
+const FWeaponStateHandlers *FWeaponStateTable::Find(EWeaponState State)
+{
+	const int32 Index = (int32)State;
+	if (State == EWeaponState::WS_Invalid || Index >= ARRAY_COUNT(Handlers))
+	{
+		return nullptr;
+	}
+	return &Handlers[Index];
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Equipping [Equip -> Idle]
+
+void FWeaponStateTable::EnterEquipping(UBaseWeaponItem &Weapon, FWeaponStateData &Data, EWeaponState PrevState)
+{
+	Data.bWantsToFire = false;
+}
+
+void FWeaponStateTable::TickEquipping(UBaseWeaponItem &Weapon, FWeaponStateData &Data, float DeltaTime)
+{
+	if (Data.StateTime >= Weapon.EquipTime)
+	{
+		Weapon.GotoState(EWeaponState::WS_Idle);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Unequipping [UnEquip -> Inactive]
+
+void FWeaponStateTable::TickUnEquipping(UBaseWeaponItem &Weapon, FWeaponStateData &Data, float DeltaTime)
+{
+	if (Data.StateTime >= Weapon.EquipTime)
+	{
+		Weapon.GotoState(EWeaponState::WS_Inactive);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Idle [Idle -> Fire | Idle -> Reload]
+
+void FWeaponStateTable::TickIdle(UBaseWeaponItem &Weapon, FWeaponStateData &Data, float DeltaTime)
+{
+	// Trigger held through equip or reload
+	if (Data.bWantsToFire)
+	{
+		Weapon.GotoState(EWeaponState::WS_Firing);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Ammo empty [AmmoEmpty -> Reload]. Nothing to update until a reload.
+
+void FWeaponStateTable::EnterAmmoEmpty(UBaseWeaponItem &Weapon, FWeaponStateData &Data, EWeaponState PrevState)
+{
+	Data.bWantsToFire = false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Firing [dryfire / fireprojectile]
+
+void FWeaponStateTable::EnterFiring(UBaseWeaponItem &Weapon, FWeaponStateData &Data, EWeaponState PrevState)
+{
+	UWorld *World = Weapon.GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	// A finished reload already scheduled the next shot at its exact end time
+	if (PrevState == EWeaponState::WS_Reloading)
+	{
+		return;
+	}
+
+	// The first shot goes off now, unless the last burst's refire delay hasn't run out yet
+	Data.NextShotTime = FMath::Max(Data.NextShotTime, World->GetTimeSeconds());
+}
+
+void FWeaponStateTable::TickFiring(UBaseWeaponItem &Weapon, FWeaponStateData &Data, float DeltaTime)
+{
+	UWorld *World = Weapon.GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	// Emit every shot due up to the end of this frame, each with its exact time.
+	// At high fire rates or low frame rates that is several shots per frame.
+	const float Now = World->GetTimeSeconds();
+	int32 Shots = 0;
+	while (Data.bWantsToFire && Data.NextShotTime <= Now && Shots < MaxShotsPerFrame)
+	{
+		if (!Weapon.HasAmmo())
+		{
+			Weapon.GotoState(EWeaponState::WS_AmmoEmpty);
+			return;
+		}
+
+		Weapon.FireShot(Data.NextShotTime);
+		Shots++;
+
+		if (Weapon.fRefireDelay > 0.0f)
+		{
+			Data.NextShotTime += Weapon.fRefireDelay;
+		}
+		else
+		{
+			// No refire delay: one shot per trigger pull
+			Data.NextShotTime = Now;
+			Data.bWantsToFire = false;
+		}
+	}
+
+	// Don't bank shots we could not fire
+	if (Shots == MaxShotsPerFrame)
+	{
+		Data.NextShotTime = FMath::Max(Data.NextShotTime, Now);
+	}
+
+	if (!Data.bWantsToFire)
+	{
+		Weapon.GotoState(EWeaponState::WS_Idle);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Reloading
+
+void FWeaponStateTable::EnterReloading(UBaseWeaponItem &Weapon, FWeaponStateData &Data, EWeaponState PrevState)
+{
+	UWorld *World = Weapon.GetWorld();
+	Data.ReloadEndTime = (World ? World->GetTimeSeconds() : 0.0f) + Weapon.fReloadTime;
+}
+
+void FWeaponStateTable::TickReloading(UBaseWeaponItem &Weapon, FWeaponStateData &Data, float DeltaTime)
+{
+	UWorld *World = Weapon.GetWorld();
+	if (World == nullptr || World->GetTimeSeconds() < Data.ReloadEndTime)
+	{
+		return;
+	}
+
+	Weapon.FinishReload();
+
+	// Shots continue from the moment the reload completed, not from this frame
+	Data.NextShotTime = FMath::Max(Data.NextShotTime, Data.ReloadEndTime);
+	Weapon.GotoState(Data.bWantsToFire ? EWeaponState::WS_Firing : EWeaponState::WS_Idle);
+}
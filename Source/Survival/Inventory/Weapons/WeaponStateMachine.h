@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Inventory/BaseItem.h"
+#include "WeaponStateMachine.generated.h"
+
+class UBaseWeaponItem;
+
+/**
+* Compact per-weapon state. Everything a weapon needs to run its state machine;
+* the behaviour itself lives in the shared FWeaponStateTable.
+*/
+USTRUCT(BlueprintType)
+struct FWeaponStateData
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Weapon States")
+	EWeaponState CurrentState;
+
+	// Seconds spent in the current state
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Weapon States")
+	float StateTime;
+
+	// Trigger is held
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Weapon States")
+	bool bWantsToFire;
+
+	// World time the next shot is due. Advanced by exactly fRefireDelay per shot, so the
+	// fire rate doesn't depend on the frame rate.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Weapon States")
+	float NextShotTime;
+
+	// World time the current reload completes
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Weapon States")
+	float ReloadEndTime;
+
+	FWeaponStateData()
+	{
+		CurrentState = EWeaponState::WS_Inactive;
+		StateTime = 0.0f;
+		bWantsToFire = false;
+		NextShotTime = 0.0f;
+		ReloadEndTime = 0.0f;
+	}
+};
+
+/**
+* Enter/exit/tick handlers for one weapon state
+*/
+struct FWeaponStateHandlers
+{
+	typedef void(*FEnterFunc)(UBaseWeaponItem &Weapon, FWeaponStateData &Data, EWeaponState PrevState);
+	typedef void(*FExitFunc)(UBaseWeaponItem &Weapon, FWeaponStateData &Data);
+	typedef void(*FTickFunc)(UBaseWeaponItem &Weapon, FWeaponStateData &Data, float DeltaTime);
+
+	FEnterFunc OnEnter;
+	FExitFunc OnExit;
+	FTickFunc OnTick;
+
+	// Weapons in this state are ticked by the weapon update manager
+	bool bNeedsTick;
+};
+
+/**
+* Shared, stateless transition table keyed by EWeaponState.
+* Transitions are a table lookup; no per-weapon state objects are needed.
+*/
+class SURVIVAL_API FWeaponStateTable
+{
+public:
+	// Get the handlers for State. Returns nullptr for WS_Invalid and out of range values.
+	static const FWeaponStateHandlers *Find(EWeaponState State);
+
+private:
+	static void EnterEquipping(UBaseWeaponItem &Weapon, FWeaponStateData &Data, EWeaponState PrevState);
+	static void TickEquipping(UBaseWeaponItem &Weapon, FWeaponStateData &Data, float DeltaTime);
+
+	static void TickUnEquipping(UBaseWeaponItem &Weapon, FWeaponStateData &Data, float DeltaTime);
+
+	static void TickIdle(UBaseWeaponItem &Weapon, FWeaponStateData &Data, float DeltaTime);
+
+	static void EnterAmmoEmpty(UBaseWeaponItem &Weapon, FWeaponStateData &Data, EWeaponState PrevState);
+
+	static void EnterFiring(UBaseWeaponItem &Weapon, FWeaponStateData &Data, EWeaponState PrevState);
+	static void TickFiring(UBaseWeaponItem &Weapon, FWeaponStateData &Data, float DeltaTime);
+
+	static void EnterReloading(UBaseWeaponItem &Weapon, FWeaponStateData &Data, EWeaponState PrevState);
+	static void TickReloading(UBaseWeaponItem &Weapon, FWeaponStateData &Data, float DeltaTime);
+
+	// Safety cap on shots emitted in one frame, e.g. after a long hitch
+	static const int32 MaxShotsPerFrame = 32;
+
+	static const FWeaponStateHandlers Handlers[];
+};
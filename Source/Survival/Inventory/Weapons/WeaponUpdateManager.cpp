@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "WeaponUpdateManager.h"
+#include "SurvivalGameStateBase.h"
+
+DECLARE_CYCLE_STAT(TEXT("Weapon Update"), STAT_WeaponUpdate, STATGROUP_Survival);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Weapons"), STAT_ActiveWeapons, STATGROUP_Survival);
+
+
+UWeaponUpdateManager::UWeaponUpdateManager()
+{
+	TickIndex = INDEX_NONE;
+}
+
+UWeaponUpdateManager *UWeaponUpdateManager::Get(const UObject *WorldContextObject)
+{
+	UWorld *World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	ASurvivalGameStateBase *GameState = World ? World->GetGameState<ASurvivalGameStateBase>() : nullptr;
+	return GameState ? GameState->WeaponUpdateManager : nullptr;
+}
+
+void UWeaponUpdateManager::RegisterWeapon(UBaseWeaponItem *Weapon)
+{
+	if (Weapon == nullptr || Weapon->UpdateIndex != INDEX_NONE)
+	{
+		return;
+	}
+
+	Weapon->UpdateIndex = ActiveWeapons.Add(Weapon);
+	SET_DWORD_STAT(STAT_ActiveWeapons, ActiveWeapons.Num());
+}
+
+void UWeaponUpdateManager::UnregisterWeapon(UBaseWeaponItem *Weapon)
+{
+	if (Weapon == nullptr || !ActiveWeapons.IsValidIndex(Weapon->UpdateIndex) || ActiveWeapons[Weapon->UpdateIndex] != Weapon)
+	{
+		return;
+	}
+
+	const int32 Index = Weapon->UpdateIndex;
+	ActiveWeapons.RemoveAtSwap(Index, 1, false);
+	if (ActiveWeapons.IsValidIndex(Index))
+	{
+		ActiveWeapons[Index]->UpdateIndex = Index;
+	}
+	Weapon->UpdateIndex = INDEX_NONE;
+
+	// If the weapon being ticked removed itself, the swapped-in weapon now sits
+	// at the index we're on. Step back so it gets ticked too.
+	if (TickIndex != INDEX_NONE && Index == TickIndex)
+	{
+		TickIndex--;
+	}
+
+	SET_DWORD_STAT(STAT_ActiveWeapons, ActiveWeapons.Num());
+}
+
+void UWeaponUpdateManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_WeaponUpdate);
+
+	for (TickIndex = 0; TickIndex < ActiveWeapons.Num(); TickIndex++)
+	{
+		UBaseWeaponItem *Weapon = ActiveWeapons[TickIndex];
+		if (Weapon == nullptr)
+		{
+			// Reference cleared by garbage collection
+			ActiveWeapons.RemoveAtSwap(TickIndex, 1, false);
+			if (ActiveWeapons.IsValidIndex(TickIndex) && ActiveWeapons[TickIndex] != nullptr)
+			{
+				ActiveWeapons[TickIndex]->UpdateIndex = TickIndex;
+			}
+			TickIndex--;
+			continue;
+		}
+		else if (Weapon->IsPendingKill())
+		{
+			// Don't keep destroyed weapons alive through our array
+			UnregisterWeapon(Weapon);
+			continue;
+		}
+
+		Weapon->TickWeapon(DeltaTime);
+	}
+	TickIndex = INDEX_NONE;
+}
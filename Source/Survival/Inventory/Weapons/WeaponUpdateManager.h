@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "WeaponUpdateManager.generated.h"
+
+class UBaseWeaponItem;
+
+/**
+* Ticks the weapons that are doing something.
+*
+* Weapons register themselves when they leave the inactive state and unregister
+* when they go back to it (@see UBaseWeaponItem::GotoState), so weapons sitting in
+* inventories and storage cost nothing per frame. Active weapons are kept in one
+* contiguous array and updated in a single loop.
+*
+* Owned by the game state, so it exists on both server and clients.
+*/
+UCLASS()
+class SURVIVAL_API UWeaponUpdateManager : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	UWeaponUpdateManager();
+
+	// Utility to get the manager of the world WorldContextObject lives in. May return nullptr.
+	static UWeaponUpdateManager *Get(const UObject *WorldContextObject);
+
+	void RegisterWeapon(UBaseWeaponItem *Weapon);
+	void UnregisterWeapon(UBaseWeaponItem *Weapon);
+
+	FORCEINLINE int32 GetNumActiveWeapons() const
+	{
+		return ActiveWeapons.Num();
+	}
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	UPROPERTY()
+	TArray<UBaseWeaponItem*> ActiveWeapons;
+
+	// Set while ticking, so unregistering mid-loop can fix up the iteration
+	int32 TickIndex;
+};
@@ -0,0 +1,427 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "NeedsSimulation.h"
+#include "SurvivalGameMode.h"
+#include "Combat/DamagePipeline.h"
+
+DECLARE_CYCLE_STAT(TEXT("Needs Update"), STAT_NeedsUpdate, STATGROUP_Survival);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Needs Characters"), STAT_NeedsCharacters, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Needs Updated"), STAT_NeedsUpdated, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Needs Threshold Events"), STAT_NeedsThresholdEvents, STATGROUP_Survival);
+
+
+//////////////////////////////////////////////////////////////////////////
+// FNeedsBuffer
+
+int32 FNeedsBuffer::Add()
+{
+	// Grow a whole SIMD lane group at a time
+	if (Num % 4 == 0)
+	{
+		ForEachFloatArray([](TArray<float> &Array) { Array.AddZeroed(4); });
+	}
+
+	Characters.Add(nullptr);
+	Thresholds.AddZeroed();
+
+	// May be a padding lane the update has run over
+	ZeroLane(Num);
+
+	return Num++;
+}
+
+void FNeedsBuffer::ZeroLane(int32 Index)
+{
+	ForEachFloatArray([Index](TArray<float> &Array) { Array[Index] = 0.0f; });
+}
+
+void FNeedsBuffer::RemoveAtSwap(int32 Index)
+{
+	check(Index >= 0 && Index < Num);
+
+	const int32 Last = Num - 1;
+	ForEachFloatArray([Index, Last](TArray<float> &Array)
+	{
+		Array[Index] = Array[Last];
+		Array[Last] = 0.0f;
+	});
+
+	Characters.RemoveAtSwap(Index, 1, false);
+	Thresholds.RemoveAtSwap(Index, 1, false);
+
+	Num--;
+	if (Num % 4 == 0)
+	{
+		const int32 PaddedNum = Num;
+		ForEachFloatArray([PaddedNum](TArray<float> &Array) { Array.RemoveAt(PaddedNum, 4, false); });
+	}
+}
+
+void FNeedsBuffer::Empty()
+{
+	ForEachFloatArray([](TArray<float> &Array) { Array.Empty(); });
+	Characters.Empty();
+	Thresholds.Empty();
+	Num = 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// UNeedsSimulation
+
+UNeedsSimulation::UNeedsSimulation()
+{
+	UpdateInterval = 0.5f;
+	MaxCharactersPerFrame = 1024;
+
+	HungerRate = 0.05f;
+	ThirstRate = 0.08f;
+	StaminaRegenRate = 10.0f;
+	TemperatureAdaptRate = 0.01f;
+	BleedClotRate = 0.1f;
+
+	DefaultAmbientTemperature = 37.0f;
+	FreezingTemperature = 35.0f;
+	OverheatingTemperature = 39.0f;
+	ExhaustedStamina = 0.0f;
+
+	StarvingDamage = 1.0f;
+	DehydratedDamage = 2.0f;
+	ExposureDamage = 1.0f;
+
+	LanesOwed = 0.0f;
+	Cursor = 0;
+}
+
+UNeedsSimulation *UNeedsSimulation::Get(const UObject *WorldContextObject)
+{
+	UWorld *World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	ASurvivalGameMode *GameMode = World ? World->GetAuthGameMode<ASurvivalGameMode>() : nullptr;
+	return GameMode ? GameMode->NeedsSimulation : nullptr;
+}
+
+void UNeedsSimulation::RegisterCharacter(ASurvivalCharacter *Character)
+{
+	UWorld *World = GetWorld();
+	if (Character == nullptr || World == nullptr || Character->NeedsIndex != INDEX_NONE)
+	{
+		return;
+	}
+
+	const FSurvivalNeeds &Initial = Character->Needs;
+
+	const int32 Index = Needs.Add();
+	Needs.Hunger[Index] = Initial.Hunger;
+	Needs.Thirst[Index] = Initial.Thirst;
+	Needs.Temperature[Index] = Initial.Temperature;
+	Needs.AmbientTemperature[Index] = DefaultAmbientTemperature;
+	Needs.Stamina[Index] = Initial.Stamina;
+	Needs.MaxStamina[Index] = Character->MaxStamina;
+	Needs.Bleeding[Index] = Initial.Bleeding;
+	Needs.LastUpdateTime[Index] = World->GetTimeSeconds();
+	Needs.Characters[Index] = Character;
+	Needs.Thresholds[Index] = ComputeThresholds(Index);
+
+	Character->NeedsIndex = Index;
+
+	SET_DWORD_STAT(STAT_NeedsCharacters, Needs.Num);
+}
+
+void UNeedsSimulation::UnregisterCharacter(ASurvivalCharacter *Character)
+{
+	if (Character == nullptr || !Needs.Characters.IsValidIndex(Character->NeedsIndex) || Needs.Characters[Character->NeedsIndex] != Character)
+	{
+		return;
+	}
+
+	WriteBack(Character->NeedsIndex);
+
+	const int32 Index = Character->NeedsIndex;
+	Needs.RemoveAtSwap(Index);
+	if (Index < Needs.Num)
+	{
+		Needs.Characters[Index]->NeedsIndex = Index;
+	}
+	Character->NeedsIndex = INDEX_NONE;
+
+	SET_DWORD_STAT(STAT_NeedsCharacters, Needs.Num);
+}
+
+bool UNeedsSimulation::GetNeeds(const ASurvivalCharacter *Character, FSurvivalNeeds &OutNeeds) const
+{
+	if (Character == nullptr || !Needs.Characters.IsValidIndex(Character->NeedsIndex))
+	{
+		return false;
+	}
+
+	const int32 Index = Character->NeedsIndex;
+	OutNeeds.Hunger = Needs.Hunger[Index];
+	OutNeeds.Thirst = Needs.Thirst[Index];
+	OutNeeds.Temperature = Needs.Temperature[Index];
+	OutNeeds.Stamina = Needs.Stamina[Index];
+	OutNeeds.Bleeding = Needs.Bleeding[Index];
+	return true;
+}
+
+void UNeedsSimulation::ModifyNeed(ASurvivalCharacter *Character, ENeedType Need, float Delta)
+{
+	if (Character == nullptr || !Needs.Characters.IsValidIndex(Character->NeedsIndex))
+	{
+		return;
+	}
+
+	const int32 Index = Character->NeedsIndex;
+	switch (Need)
+	{
+	case ENeedType::NT_Hunger:
+		Needs.Hunger[Index] = FMath::Clamp(Needs.Hunger[Index] + Delta, 0.0f, 100.0f);
+		break;
+	case ENeedType::NT_Thirst:
+		Needs.Thirst[Index] = FMath::Clamp(Needs.Thirst[Index] + Delta, 0.0f, 100.0f);
+		break;
+	case ENeedType::NT_Temperature:
+		Needs.Temperature[Index] += Delta;
+		break;
+	case ENeedType::NT_Stamina:
+		Needs.Stamina[Index] = FMath::Clamp(Needs.Stamina[Index] + Delta, 0.0f, Needs.MaxStamina[Index]);
+		break;
+	case ENeedType::NT_Bleeding:
+		Needs.Bleeding[Index] = FMath::Max(Needs.Bleeding[Index] + Delta, 0.0f);
+		break;
+	}
+
+	// Eating or bandaging should show right away, not at the next update
+	PostUpdate(Index);
+}
+
+bool UNeedsSimulation::ConsumeStamina(ASurvivalCharacter *Character, float Amount)
+{
+	if (Character == nullptr || !Needs.Characters.IsValidIndex(Character->NeedsIndex))
+	{
+		return false;
+	}
+
+	const int32 Index = Character->NeedsIndex;
+	if (Needs.Stamina[Index] < Amount)
+	{
+		return false;
+	}
+
+	Needs.Stamina[Index] -= Amount;
+	PostUpdate(Index);
+	return true;
+}
+
+void UNeedsSimulation::SetAmbientTemperature(ASurvivalCharacter *Character, float Temperature)
+{
+	if (Character != nullptr && Needs.Characters.IsValidIndex(Character->NeedsIndex))
+	{
+		Needs.AmbientTemperature[Character->NeedsIndex] = Temperature;
+	}
+}
+
+void UNeedsSimulation::Tick(float DeltaTime)
+{
+	UWorld *World = GetWorld();
+	if (Needs.Num == 0 || World == nullptr)
+	{
+		LanesOwed = 0.0f;
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_NeedsUpdate);
+
+	// Every lane is owed one update per interval
+	const int32 PaddedNum = Needs.GetPaddedNum();
+	const int32 NumGroups = PaddedNum / 4;
+	LanesOwed += PaddedNum * DeltaTime / FMath::Max(UpdateInterval, KINDA_SMALL_NUMBER);
+
+	const int32 MaxGroups = FMath::Max(FMath::DivideAndRoundUp(MaxCharactersPerFrame, 4), 1);
+	int32 Groups = FMath::Min(FMath::FloorToInt(LanesOwed / 4.0f), MaxGroups);
+	LanesOwed -= Groups * 4;
+
+	// Drop what we could not catch up on rather than spiral. Lanes keep their own
+	// last update time, so nothing is lost, it just arrives in larger steps.
+	LanesOwed = FMath::Min(LanesOwed, (float)(MaxGroups * 4));
+
+	const float Now = World->GetTimeSeconds();
+	if (Cursor >= PaddedNum)
+	{
+		Cursor = 0;
+	}
+
+	Groups = FMath::Min(Groups, NumGroups);
+	while (Groups > 0)
+	{
+		// Contiguous run up to the end of the buffer, then wrap
+		const int32 Run = FMath::Min(Groups, (PaddedNum - Cursor) / 4);
+		UpdateGroups(Cursor, Run, Now);
+
+		Cursor = (Cursor + Run * 4) % PaddedNum;
+		Groups -= Run;
+	}
+}
+
+void UNeedsSimulation::UpdateGroups(int32 Start, int32 NumGroups, float Now)
+{
+	const int32 End = Start + NumGroups * 4;
+
+	// Run over the arrays first, then do the per-character work
+	{
+		const VectorRegister Zero = VectorZero();
+		const VectorRegister One = VectorOne();
+		const VectorRegister NowVec = VectorSetFloat1(Now);
+		const VectorRegister HungerRateVec = VectorSetFloat1(HungerRate);
+		const VectorRegister ThirstRateVec = VectorSetFloat1(ThirstRate);
+		const VectorRegister StaminaRegenVec = VectorSetFloat1(StaminaRegenRate);
+		const VectorRegister AdaptRateVec = VectorSetFloat1(TemperatureAdaptRate);
+		const VectorRegister ClotRateVec = VectorSetFloat1(BleedClotRate);
+		const VectorRegister FreezingVec = VectorSetFloat1(FreezingTemperature);
+		const VectorRegister OverheatingVec = VectorSetFloat1(OverheatingTemperature);
+		const VectorRegister StarvingDamageVec = VectorSetFloat1(StarvingDamage);
+		const VectorRegister DehydratedDamageVec = VectorSetFloat1(DehydratedDamage);
+		const VectorRegister ExposureDamageVec = VectorSetFloat1(ExposureDamage);
+
+		float *RESTRICT Hunger = Needs.Hunger.GetData();
+		float *RESTRICT Thirst = Needs.Thirst.GetData();
+		float *RESTRICT Temperature = Needs.Temperature.GetData();
+		float *RESTRICT Stamina = Needs.Stamina.GetData();
+		float *RESTRICT Bleeding = Needs.Bleeding.GetData();
+		float *RESTRICT LastUpdateTime = Needs.LastUpdateTime.GetData();
+		float *RESTRICT Damage = Needs.Damage.GetData();
+		const float *RESTRICT AmbientTemperature = Needs.AmbientTemperature.GetData();
+		const float *RESTRICT MaxStamina = Needs.MaxStamina.GetData();
+
+		for (int32 i = Start; i < End; i += 4)
+		{
+			// Each lane advances by its own time since its last update
+			const VectorRegister Dt = VectorSubtract(NowVec, VectorLoad(&LastUpdateTime[i]));
+			VectorStore(NowVec, &LastUpdateTime[i]);
+
+			// Damage is taken for the state the lane was in over the elapsed time
+			const VectorRegister H = VectorLoad(&Hunger[i]);
+			const VectorRegister W = VectorLoad(&Thirst[i]);
+			const VectorRegister T = VectorLoad(&Temperature[i]);
+			const VectorRegister B = VectorLoad(&Bleeding[i]);
+
+			VectorRegister DamageRate = B;
+			DamageRate = VectorAdd(DamageRate, VectorSelect(VectorCompareGT(H, Zero), Zero, StarvingDamageVec));
+			DamageRate = VectorAdd(DamageRate, VectorSelect(VectorCompareGT(W, Zero), Zero, DehydratedDamageVec));
+			DamageRate = VectorAdd(DamageRate, VectorSelect(VectorCompareGE(FreezingVec, T), ExposureDamageVec, Zero));
+			DamageRate = VectorAdd(DamageRate, VectorSelect(VectorCompareGE(T, OverheatingVec), ExposureDamageVec, Zero));
+			VectorStore(VectorMultiply(DamageRate, Dt), &Damage[i]);
+
+			VectorStore(VectorMax(VectorSubtract(H, VectorMultiply(HungerRateVec, Dt)), Zero), &Hunger[i]);
+			VectorStore(VectorMax(VectorSubtract(W, VectorMultiply(ThirstRateVec, Dt)), Zero), &Thirst[i]);
+
+			// Close part of the gap to ambient, never overshooting
+			const VectorRegister Adapt = VectorMin(VectorMultiply(AdaptRateVec, Dt), One);
+			VectorStore(VectorMultiplyAdd(VectorSubtract(VectorLoad(&AmbientTemperature[i]), T), Adapt, T), &Temperature[i]);
+
+			VectorStore(VectorMin(VectorMultiplyAdd(StaminaRegenVec, Dt, VectorLoad(&Stamina[i])), VectorLoad(&MaxStamina[i])), &Stamina[i]);
+			VectorStore(VectorMax(VectorSubtract(B, VectorMultiply(ClotRateVec, Dt)), Zero), &Bleeding[i]);
+		}
+	}
+
+	// Padding lanes are never real characters. Undo what the update did to them.
+	for (int32 i = FMath::Max(Start, Needs.Num); i < End; i++)
+	{
+		Needs.ZeroLane(i);
+	}
+
+	const int32 LastReal = FMath::Min(End, Needs.Num);
+	for (int32 i = Start; i < LastReal; i++)
+	{
+		PostUpdate(i);
+	}
+
+	INC_DWORD_STAT_BY(STAT_NeedsUpdated, FMath::Max(LastReal - Start, 0));
+}
+
+void UNeedsSimulation::PostUpdate(int32 Index)
+{
+	ASurvivalCharacter *Character = Needs.Characters[Index];
+
+	// Damage from the update. Set back to 0 so direct changes (@see ModifyNeed) don't apply it twice.
+	const float Damage = Needs.Damage[Index];
+	Needs.Damage[Index] = 0.0f;
+	if (Damage > 0.0f && !Character->IsDead())
+	{
+		UDamagePipeline *DamagePipeline = UDamagePipeline::Get(this);
+		if (DamagePipeline != nullptr)
+		{
+			DamagePipeline->QueueDamage(Character, Damage, UDamageType::StaticClass(), nullptr, nullptr);
+		}
+		else
+		{
+			Character->ApplyResolvedDamage(Damage);
+		}
+	}
+
+	WriteBack(Index);
+
+	// Only transitions are reported
+	const uint8 OldThresholds = Needs.Thresholds[Index];
+	const uint8 NewThresholds = ComputeThresholds(Index);
+	const uint8 Changed = OldThresholds ^ NewThresholds;
+	if (Changed == 0)
+	{
+		return;
+	}
+
+	Needs.Thresholds[Index] = NewThresholds;
+	for (uint8 Bit = 0; Bit < (uint8)ENeedThreshold::NTH_Count; Bit++)
+	{
+		if (Changed & (1 << Bit))
+		{
+			const ENeedThreshold Threshold = (ENeedThreshold)Bit;
+			const bool bActive = (NewThresholds & (1 << Bit)) != 0;
+
+			Character->OnNeedThresholdChanged(Threshold, bActive);
+			OnThresholdChanged.Broadcast(Character, Threshold, bActive);
+
+			INC_DWORD_STAT(STAT_NeedsThresholdEvents);
+		}
+	}
+}
+
+uint8 UNeedsSimulation::ComputeThresholds(int32 Index) const
+{
+	uint8 Thresholds = 0;
+	if (Needs.Hunger[Index] <= 0.0f)
+	{
+		Thresholds |= 1 << (uint8)ENeedThreshold::NTH_Starving;
+	}
+	if (Needs.Thirst[Index] <= 0.0f)
+	{
+		Thresholds |= 1 << (uint8)ENeedThreshold::NTH_Dehydrated;
+	}
+	if (Needs.Temperature[Index] <= FreezingTemperature)
+	{
+		Thresholds |= 1 << (uint8)ENeedThreshold::NTH_Freezing;
+	}
+	if (Needs.Temperature[Index] >= OverheatingTemperature)
+	{
+		Thresholds |= 1 << (uint8)ENeedThreshold::NTH_Overheating;
+	}
+	if (Needs.Stamina[Index] <= ExhaustedStamina)
+	{
+		Thresholds |= 1 << (uint8)ENeedThreshold::NTH_Exhausted;
+	}
+	if (Needs.Bleeding[Index] > 0.0f)
+	{
+		Thresholds |= 1 << (uint8)ENeedThreshold::NTH_Bleeding;
+	}
+	return Thresholds;
+}
+
+void UNeedsSimulation::WriteBack(int32 Index)
+{
+	FSurvivalNeeds &Copy = Needs.Characters[Index]->Needs;
+	Copy.Hunger = Needs.Hunger[Index];
+	Copy.Thirst = Needs.Thirst[Index];
+	Copy.Temperature = Needs.Temperature[Index];
+	Copy.Stamina = Needs.Stamina[Index];
+	Copy.Bleeding = Needs.Bleeding[Index];
+}
@@ -0,0 +1,257 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "NeedsSimulation.generated.h"
+
+class ASurvivalCharacter;
+
+UENUM(BlueprintType)
+enum class ENeedType : uint8
+{
+	NT_Hunger		UMETA(DisplayName = "Hunger"),
+	NT_Thirst		UMETA(DisplayName = "Thirst"),
+	NT_Temperature	UMETA(DisplayName = "Temperature"),
+	NT_Stamina		UMETA(DisplayName = "Stamina"),
+	NT_Bleeding		UMETA(DisplayName = "Bleeding")
+};
+
+/** States a character enters and leaves as its needs cross thresholds. Used as bit indices. */
+UENUM(BlueprintType)
+enum class ENeedThreshold : uint8
+{
+	NTH_Starving	UMETA(DisplayName = "Starving"),
+	NTH_Dehydrated	UMETA(DisplayName = "Dehydrated"),
+	NTH_Freezing	UMETA(DisplayName = "Freezing"),
+	NTH_Overheating	UMETA(DisplayName = "Overheating"),
+	NTH_Exhausted	UMETA(DisplayName = "Exhausted"),
+	NTH_Bleeding	UMETA(DisplayName = "Bleeding"),
+
+	NTH_Count		UMETA(Hidden)
+};
+
+/**
+* A character's needs. The simulation owns the live values, characters keep a replicated copy.
+*/
+USTRUCT(BlueprintType)
+struct FSurvivalNeeds
+{
+	GENERATED_USTRUCT_BODY()
+
+	// 100 is fed, 0 is starving
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float Hunger;
+
+	// 100 is hydrated, 0 is dehydrated
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float Thirst;
+
+	// Body temperature in degrees celsius
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float Temperature;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float Stamina;
+
+	// Damage per second from bleeding. Clots over time.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float Bleeding;
+
+	FSurvivalNeeds()
+	{
+		Hunger = 100.0f;
+		Thirst = 100.0f;
+		Temperature = 37.0f;
+		Stamina = 100.0f;
+		Bleeding = 0.0f;
+	}
+};
+
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FNeedThresholdChanged, ASurvivalCharacter*, ENeedThreshold, bool);
+
+/**
+* Structure-of-arrays storage for the needs of every registered character.
+* Float arrays are padded to a multiple of 4 so they can be updated 4 characters
+* at a time without a scalar tail. The update runs over padding lanes too; they are
+* zeroed again after every update and before being handed out by Add.
+*/
+struct FNeedsBuffer
+{
+	// Hot data, updated with SIMD
+	TArray<float> Hunger;
+	TArray<float> Thirst;
+	TArray<float> Temperature;
+	TArray<float> AmbientTemperature;
+	TArray<float> Stamina;
+	TArray<float> MaxStamina;
+	TArray<float> Bleeding;
+	TArray<float> LastUpdateTime;
+
+	// Written by the update, damage to apply for the elapsed time
+	TArray<float> Damage;
+
+	// Cold data
+	TArray<ASurvivalCharacter*> Characters;
+	// Thresholds currently active, one bit per ENeedThreshold
+	TArray<uint8> Thresholds;
+
+	int32 Num;
+
+	FNeedsBuffer()
+		: Num(0)
+	{}
+
+	FORCEINLINE int32 GetPaddedNum() const
+	{
+		return Align(Num, 4);
+	}
+
+	// Returns a lane with every field zeroed
+	int32 Add();
+	void RemoveAtSwap(int32 Index);
+	void Empty();
+
+	// Set every float of lane Index to 0
+	void ZeroLane(int32 Index);
+
+private:
+	// All padded float arrays, for bulk operations
+	template<typename FuncType>
+	void ForEachFloatArray(FuncType Func)
+	{
+		Func(Hunger); Func(Thirst);
+		Func(Temperature); Func(AmbientTemperature);
+		Func(Stamina); Func(MaxStamina);
+		Func(Bleeding); Func(LastUpdateTime);
+		Func(Damage);
+	}
+};
+
+/**
+* Simulates hunger, thirst, body temperature, stamina regen and bleeding for every
+* registered character (players and NPCs) in one batch, instead of each character
+* ticking its own stats.
+*
+* Each character is updated about every UpdateInterval seconds. The update is spread
+* over frames in groups of 4 characters and capped at MaxCharactersPerFrame, so the
+* per-frame cost is bounded no matter how many characters exist ("stat Survival").
+* Starvation, dehydration, exposure and bleeding damage goes through the damage pipeline.
+* Characters are told when they enter or leave a threshold state, never every update.
+*
+* Server only, owned by the game mode.
+*/
+UCLASS(Config = Game)
+class SURVIVAL_API UNeedsSimulation : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	UNeedsSimulation();
+
+	// Utility to get the simulation of the world WorldContextObject lives in. Only exists on the server, may return nullptr.
+	static UNeedsSimulation *Get(const UObject *WorldContextObject);
+
+	// Seconds between updates of one character
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float UpdateInterval;
+
+	// Cap on characters updated per frame. Rounded up to a multiple of 4.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	int32 MaxCharactersPerFrame;
+
+	// Hunger lost per second
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float HungerRate;
+
+	// Thirst lost per second
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float ThirstRate;
+
+	// Stamina regained per second
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float StaminaRegenRate;
+
+	// Fraction of the gap to the ambient temperature closed per second
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float TemperatureAdaptRate;
+
+	// Bleeding damage per second lost per second
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float BleedClotRate;
+
+	// Temperature characters drift towards unless something sets it (@see SetAmbientTemperature)
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float DefaultAmbientTemperature;
+
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float FreezingTemperature;
+
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float OverheatingTemperature;
+
+	// At or below this stamina a character is exhausted
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float ExhaustedStamina;
+
+	// Damage per second while starving
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float StarvingDamage;
+
+	// Damage per second while dehydrated
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float DehydratedDamage;
+
+	// Damage per second while freezing or overheating
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Needs)
+	float ExposureDamage;
+
+	void RegisterCharacter(ASurvivalCharacter *Character);
+	void UnregisterCharacter(ASurvivalCharacter *Character);
+
+	// Current needs of Character. Returns false if it isn't registered.
+	bool GetNeeds(const ASurvivalCharacter *Character, FSurvivalNeeds &OutNeeds) const;
+
+	// Add Delta to one need (eating, drinking, bandaging, ...). Values are clamped to their valid range.
+	void ModifyNeed(ASurvivalCharacter *Character, ENeedType Need, float Delta);
+
+	// Spend stamina. Returns false, spending nothing, if there isn't enough.
+	bool ConsumeStamina(ASurvivalCharacter *Character, float Amount);
+
+	// Set the temperature Character's body drifts towards, e.g. from weather or shelter
+	void SetAmbientTemperature(ASurvivalCharacter *Character, float Temperature);
+
+	// Broadcast when a character enters (true) or leaves (false) a threshold
+	FNeedThresholdChanged OnThresholdChanged;
+
+	FORCEINLINE int32 GetNumCharacters() const
+	{
+		return Needs.Num;
+	}
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	// Update the 4-lane groups starting at lane Start
+	void UpdateGroups(int32 Start, int32 NumGroups, float Now);
+
+	// Damage, threshold events and the replicated copy for an updated character
+	void PostUpdate(int32 Index);
+
+	// Thresholds active for the current values of Index
+	uint8 ComputeThresholds(int32 Index) const;
+
+	// Copy the live values to the character's replicated copy
+	void WriteBack(int32 Index);
+
+	FNeedsBuffer Needs;
+
+	// Lanes owed an update, accumulated from elapsed time
+	float LanesOwed;
+
+	// First lane of the next group to update
+	int32 Cursor;
+};
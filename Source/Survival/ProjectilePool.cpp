@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "ProjectilePool.h"
+#include "SurvivalProjectile.h"
+#include "SurvivalGameStateBase.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Pool"), STAT_ProjectilePool, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Spawned"), STAT_ProjectilesSpawned, STATGROUP_Survival);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Projectiles"), STAT_ActiveProjectiles, STATGROUP_Survival);
+
+
+UProjectilePool::UProjectilePool()
+{
+	PrewarmCount = 32;
+	MaxFreePerClass = 256;
+}
+
+UProjectilePool *UProjectilePool::Get(const UObject *WorldContextObject)
+{
+	UWorld *World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	ASurvivalGameStateBase *GameState = World ? World->GetGameState<ASurvivalGameStateBase>() : nullptr;
+	return GameState ? GameState->ProjectilePool : nullptr;
+}
+
+void UProjectilePool::Prewarm(TSubclassOf<ASurvivalProjectile> ProjectileClass, int32 Count)
+{
+	if (ProjectileClass == nullptr)
+	{
+		return;
+	}
+
+	TArray<TWeakObjectPtr<ASurvivalProjectile>> &Free = FreeProjectiles.FindOrAdd(*ProjectileClass);
+	Free.Reserve(Count);
+	while (Free.Num() < Count)
+	{
+		ASurvivalProjectile *Projectile = SpawnPooled(*ProjectileClass);
+		if (Projectile == nullptr)
+		{
+			break;
+		}
+		Free.Add(Projectile);
+	}
+}
+
+ASurvivalProjectile *UProjectilePool::Acquire(TSubclassOf<ASurvivalProjectile> ProjectileClass, const FVector &Location, const FRotator &Rotation, AActor *Owner, APawn *Instigator)
+{
+	UWorld *World = GetWorld();
+	if (ProjectileClass == nullptr || World == nullptr)
+	{
+		return nullptr;
+	}
+
+	ASurvivalProjectile *Projectile = nullptr;
+	TArray<TWeakObjectPtr<ASurvivalProjectile>> *Free = FreeProjectiles.Find(*ProjectileClass);
+	while (Projectile == nullptr && Free != nullptr && Free->Num() > 0)
+	{
+		// Skip projectiles destroyed behind our back (level unload etc.)
+		ASurvivalProjectile *Candidate = Free->Pop(false).Get();
+		if (Candidate != nullptr && !Candidate->IsPendingKill())
+		{
+			Projectile = Candidate;
+		}
+	}
+
+	if (Projectile == nullptr)
+	{
+		Projectile = SpawnPooled(*ProjectileClass);
+		if (Projectile == nullptr)
+		{
+			return nullptr;
+		}
+	}
+
+	Projectile->SetOwner(Owner);
+	Projectile->Instigator = Instigator;
+	Projectile->ActivateFromPool(Location, Rotation);
+	INC_DWORD_STAT(STAT_ActiveProjectiles);
+
+	if (Projectile->PooledLifetime > 0.0f)
+	{
+		FProjectileExpiry Expiry;
+		Expiry.Time = World->GetTimeSeconds() + Projectile->PooledLifetime;
+		Expiry.Projectile = Projectile;
+		Expiry.Generation = Projectile->PoolGeneration;
+		ExpiryHeap.HeapPush(Expiry);
+	}
+
+	return Projectile;
+}
+
+void UProjectilePool::Release(ASurvivalProjectile *Projectile)
+{
+	if (Projectile == nullptr || !Projectile->bPoolActive)
+	{
+		return;
+	}
+
+	// Invalidates the pending expiry entry of this activation
+	Projectile->PoolGeneration++;
+	Projectile->DeactivateToPool();
+	DEC_DWORD_STAT(STAT_ActiveProjectiles);
+
+	TArray<TWeakObjectPtr<ASurvivalProjectile>> &Free = FreeProjectiles.FindOrAdd(Projectile->GetClass());
+	if (Free.Num() >= MaxFreePerClass)
+	{
+		Projectile->Destroy();
+		return;
+	}
+	Free.Add(Projectile);
+}
+
+void UProjectilePool::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectilePool);
+
+	UWorld *World = GetWorld();
+	if (World == nullptr || ExpiryHeap.Num() == 0)
+	{
+		return;
+	}
+
+	const float Now = World->GetTimeSeconds();
+	while (ExpiryHeap.Num() > 0 && ExpiryHeap.HeapTop().Time <= Now)
+	{
+		FProjectileExpiry Expiry;
+		ExpiryHeap.HeapPop(Expiry, false);
+
+		// Stale if the projectile already came back on hit (and maybe got reused)
+		ASurvivalProjectile *Projectile = Expiry.Projectile.Get();
+		if (Projectile != nullptr && Projectile->PoolGeneration == Expiry.Generation)
+		{
+			Release(Projectile);
+		}
+	}
+}
+
+ASurvivalProjectile *UProjectilePool::SpawnPooled(UClass *ProjectileClass)
+{
+	UWorld *World = GetWorld();
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ASurvivalProjectile *Projectile = World->SpawnActor<ASurvivalProjectile>(ProjectileClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+	if (Projectile == nullptr)
+	{
+		UE_LOG(SurvivalDebugLog, Warning, TEXT("UProjectilePool::SpawnPooled - Failed to spawn %s"), *GetNameSafe(ProjectileClass));
+		return nullptr;
+	}
+
+	INC_DWORD_STAT(STAT_ProjectilesSpawned);
+
+	// Pooled projectiles live until the pool lets go of them
+	Projectile->SetLifeSpan(0.0f);
+	Projectile->DeactivateToPool();
+	return Projectile;
+}
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "ProjectilePool.generated.h"
+
+class ASurvivalProjectile;
+
+/**
+* Recycles projectile actors instead of spawning and destroying one per shot.
+*
+* Projectiles are pre-warmed per class and parked hidden, without collision or
+* movement, until a weapon fires. They return to the pool on hit or when their
+* lifetime runs out. Lifetimes are tracked here in a single min-heap instead of
+* a lifespan timer on every actor.
+*
+* Owned by the game state, so it exists on both server and clients.
+*/
+UCLASS(Config = Game)
+class SURVIVAL_API UProjectilePool : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	UProjectilePool();
+
+	// Utility to get the pool of the world WorldContextObject lives in. May return nullptr.
+	static UProjectilePool *Get(const UObject *WorldContextObject);
+
+	// Number of projectiles spawned up front for each class
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Projectile)
+	int32 PrewarmCount;
+
+	// Free projectiles kept per class. Projectiles released beyond this are destroyed.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Projectile)
+	int32 MaxFreePerClass;
+
+	// Make sure at least Count free projectiles of ProjectileClass exist
+	void Prewarm(TSubclassOf<ASurvivalProjectile> ProjectileClass, int32 Count);
+
+	// Take a projectile out of the pool and launch it. Spawns a new one if the pool is empty.
+	ASurvivalProjectile *Acquire(TSubclassOf<ASurvivalProjectile> ProjectileClass, const FVector &Location, const FRotator &Rotation, AActor *Owner = nullptr, APawn *Instigator = nullptr);
+
+	// Put an active projectile back into the pool
+	void Release(ASurvivalProjectile *Projectile);
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	ASurvivalProjectile *SpawnPooled(UClass *ProjectileClass);
+
+	struct FProjectileExpiry
+	{
+		float Time;
+		TWeakObjectPtr<ASurvivalProjectile> Projectile;
+		// Matches the projectile's pool generation, unless it was released and reused since
+		int32 Generation;
+
+		FORCEINLINE bool operator<(const FProjectileExpiry &Other) const
+		{
+			return Time < Other.Time;
+		}
+	};
+
+	// Free projectiles per class
+	TMap<UClass*, TArray<TWeakObjectPtr<ASurvivalProjectile>>> FreeProjectiles;
+
+	// Min-heap of active projectile lifetimes
+	TArray<FProjectileExpiry> ExpiryHeap;
+};
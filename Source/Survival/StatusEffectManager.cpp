@@ -0,0 +1,260 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "StatusEffectManager.h"
+#include "SurvivalGameMode.h"
+#include "NeedsSimulation.h"
+#include "Combat/DamagePipeline.h"
+
+DECLARE_CYCLE_STAT(TEXT("Status Effects Tick"), STAT_StatusEffectsTick, STATGROUP_Survival);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Status Effects Active"), STAT_StatusEffectsActive, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Status Effects Serviced"), STAT_StatusEffectsServiced, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Status Effects Cascaded"), STAT_StatusEffectsCascaded, STATGROUP_Survival);
+
+
+UStatusEffectManager::UStatusEffectManager()
+{
+	TickResolution = 0.1f;
+
+	for (int32 Level = 0; Level < WheelLevels; Level++)
+	{
+		for (int32 Slot = 0; Slot < WheelSize; Slot++)
+		{
+			Wheel[Level][Slot] = INDEX_NONE;
+		}
+	}
+
+	FreeHead = INDEX_NONE;
+	NumActive = 0;
+	CurrentTick = 0;
+	Accumulator = 0.0f;
+}
+
+UStatusEffectManager *UStatusEffectManager::Get(const UObject *WorldContextObject)
+{
+	UWorld *World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	ASurvivalGameMode *GameMode = World ? World->GetAuthGameMode<ASurvivalGameMode>() : nullptr;
+	return GameMode ? GameMode->StatusEffectManager : nullptr;
+}
+
+FStatusEffectHandle UStatusEffectManager::ApplyEffect(ASurvivalCharacter *Target, EStatusEffectType Type, float Magnitude, float Interval, int32 NumTicks, AController *Instigator)
+{
+	FStatusEffectHandle Handle;
+	if (Target == nullptr || NumTicks <= 0)
+	{
+		return Handle;
+	}
+
+	// Intervals longer than the wheel spans are clamped
+	const uint32 MaxIntervalTicks = (1u << (WheelBits * WheelLevels)) - 1;
+	const uint32 IntervalTicks = (uint32)FMath::Clamp(FMath::RoundToInt(Interval / TickResolution), 1, (int32)MaxIntervalTicks);
+
+	int32 Index = FreeHead;
+	if (Index != INDEX_NONE)
+	{
+		FreeHead = Effects[Index].Next;
+	}
+	else
+	{
+		Index = Effects.AddDefaulted();
+	}
+
+	FStatusEffect &Effect = Effects[Index];
+	Effect.Target = Target;
+	Effect.Instigator = Instigator;
+	Effect.Magnitude = Magnitude;
+	Effect.IntervalTicks = IntervalTicks;
+	Effect.DueTick = CurrentTick + IntervalTicks;
+	Effect.TicksRemaining = (uint16)FMath::Min(NumTicks, (int32)MAX_uint16);
+	Effect.Type = Type;
+
+	Schedule(Index);
+	NumActive++;
+	SET_DWORD_STAT(STAT_StatusEffectsActive, NumActive);
+
+	Handle.Index = Index;
+	Handle.Serial = Effect.Serial;
+	return Handle;
+}
+
+bool UStatusEffectManager::CancelEffect(const FStatusEffectHandle &Handle)
+{
+	if (!IsEffectActive(Handle))
+	{
+		return false;
+	}
+
+	// Unlinking would need a walk of the slot list. The record is freed when its slot comes up.
+	Effects[Handle.Index].TicksRemaining = 0;
+	NumActive--;
+	SET_DWORD_STAT(STAT_StatusEffectsActive, NumActive);
+	return true;
+}
+
+bool UStatusEffectManager::IsEffectActive(const FStatusEffectHandle &Handle) const
+{
+	return Effects.IsValidIndex(Handle.Index)
+		&& Effects[Handle.Index].Serial == Handle.Serial
+		&& Effects[Handle.Index].TicksRemaining > 0;
+}
+
+void UStatusEffectManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffectsTick);
+
+	// The wheel keeps turning while empty so due ticks stay relative to real time
+	Accumulator += DeltaTime;
+	while (Accumulator >= TickResolution)
+	{
+		Accumulator -= TickResolution;
+		AdvanceWheel();
+	}
+}
+
+void UStatusEffectManager::AdvanceWheel()
+{
+	CurrentTick++;
+
+	// When a level wraps, the next level's current slot is now within reach of the level below
+	for (int32 Level = 1; Level < WheelLevels; Level++)
+	{
+		if (((CurrentTick >> ((Level - 1) * WheelBits)) & WheelMask) != 0)
+		{
+			break;
+		}
+		Cascade(Level, (CurrentTick >> (Level * WheelBits)) & WheelMask);
+	}
+
+	// Detach the due list first; rescheduled effects always land in another slot
+	int32 Index = Wheel[0][CurrentTick & WheelMask];
+	Wheel[0][CurrentTick & WheelMask] = INDEX_NONE;
+
+	while (Index != INDEX_NONE)
+	{
+		const int32 Next = Effects[Index].Next;
+
+		if (Effects[Index].TicksRemaining == 0)
+		{
+			// Cancelled
+			FreeEffect(Index);
+		}
+		else if (ServiceEffect(Index))
+		{
+			Effects[Index].DueTick += Effects[Index].IntervalTicks;
+			Schedule(Index);
+		}
+		else
+		{
+			FreeEffect(Index);
+		}
+
+		INC_DWORD_STAT(STAT_StatusEffectsServiced);
+		Index = Next;
+	}
+
+	SET_DWORD_STAT(STAT_StatusEffectsActive, NumActive);
+}
+
+void UStatusEffectManager::Schedule(int32 Index)
+{
+	FStatusEffect &Effect = Effects[Index];
+	const uint32 Delta = Effect.DueTick - CurrentTick;
+
+	// Lowest level whose span covers the delay
+	int32 Level = 0;
+	while (Level < WheelLevels - 1 && Delta >= (1u << ((Level + 1) * WheelBits)))
+	{
+		Level++;
+	}
+
+	const int32 Slot = (Effect.DueTick >> (Level * WheelBits)) & WheelMask;
+	Effect.Next = Wheel[Level][Slot];
+	Wheel[Level][Slot] = Index;
+}
+
+void UStatusEffectManager::Cascade(int32 Level, int32 Slot)
+{
+	int32 Index = Wheel[Level][Slot];
+	Wheel[Level][Slot] = INDEX_NONE;
+
+	while (Index != INDEX_NONE)
+	{
+		const int32 Next = Effects[Index].Next;
+		Schedule(Index);
+		Index = Next;
+
+		INC_DWORD_STAT(STAT_StatusEffectsCascaded);
+	}
+}
+
+bool UStatusEffectManager::ServiceEffect(int32 Index)
+{
+	const FStatusEffect Effect = Effects[Index];
+
+	ASurvivalCharacter *Target = Effect.Target.Get();
+	if (Target == nullptr || Target->IsDead())
+	{
+		NumActive--;
+		return false;
+	}
+
+	switch (Effect.Type)
+	{
+	case EStatusEffectType::SE_Regeneration:
+		Target->TakeHeal(Effect.Magnitude, nullptr);
+		break;
+
+	case EStatusEffectType::SE_Poison:
+	case EStatusEffectType::SE_Bleeding:
+	{
+		UDamagePipeline *DamagePipeline = UDamagePipeline::Get(this);
+		if (DamagePipeline != nullptr)
+		{
+			DamagePipeline->QueueDamage(Target, Effect.Magnitude, UDamageType::StaticClass(), Effect.Instigator.Get(), nullptr);
+		}
+		else
+		{
+			Target->ApplyResolvedDamage(Effect.Magnitude);
+		}
+		break;
+	}
+
+	case EStatusEffectType::SE_Nourishment:
+	case EStatusEffectType::SE_Hydration:
+	{
+		UNeedsSimulation *NeedsSimulation = UNeedsSimulation::Get(this);
+		if (NeedsSimulation != nullptr)
+		{
+			NeedsSimulation->ModifyNeed(Target, Effect.Type == EStatusEffectType::SE_Nourishment ? ENeedType::NT_Hunger : ENeedType::NT_Thirst, Effect.Magnitude);
+		}
+		break;
+	}
+	}
+
+	// Cancelled from inside the tick
+	if (Effects[Index].TicksRemaining == 0)
+	{
+		return false;
+	}
+
+	if (--Effects[Index].TicksRemaining == 0)
+	{
+		NumActive--;
+		return false;
+	}
+	return true;
+}
+
+void UStatusEffectManager::FreeEffect(int32 Index)
+{
+	FStatusEffect &Effect = Effects[Index];
+	Effect.Target.Reset();
+	Effect.Instigator.Reset();
+	Effect.TicksRemaining = 0;
+
+	// Outstanding handles to this record go stale
+	Effect.Serial++;
+
+	Effect.Next = FreeHead;
+	FreeHead = Index;
+}
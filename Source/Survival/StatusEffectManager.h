@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "StatusEffectManager.generated.h"
+
+class ASurvivalCharacter;
+
+UENUM(BlueprintType)
+enum class EStatusEffectType : uint8
+{
+	SE_Regeneration	UMETA(DisplayName = "Regeneration"),	// Heals Magnitude per tick
+	SE_Poison		UMETA(DisplayName = "Poison"),			// Damages Magnitude per tick
+	SE_Bleeding		UMETA(DisplayName = "Bleeding"),		// Damages Magnitude per tick
+	SE_Nourishment	UMETA(DisplayName = "Nourishment"),		// Restores Magnitude hunger per tick
+	SE_Hydration	UMETA(DisplayName = "Hydration")		// Restores Magnitude thirst per tick
+};
+
+/**
+* Refers to one applied effect. Stays safe to use after the effect has ended.
+*/
+USTRUCT(BlueprintType)
+struct FStatusEffectHandle
+{
+	GENERATED_USTRUCT_BODY()
+
+	int32 Index;
+	uint32 Serial;
+
+	FStatusEffectHandle()
+		: Index(INDEX_NONE)
+		, Serial(0)
+	{}
+
+	FORCEINLINE bool IsValid() const
+	{
+		return Index != INDEX_NONE;
+	}
+};
+
+/**
+* Applies status effects over time (regeneration, poison, bleeding, food buffs).
+*
+* Effects are small records scheduled on a hierarchical timing wheel: 4 levels of
+* 64 slots, each slot a linked list of the effects due in it. Every wheel tick only
+* the current slot is serviced, and far-off effects are moved down a level as
+* their time comes closer. The per-frame cost is the number of due effects (plus
+* amortized cascading), no matter how many effects are active. Nothing per effect
+* or per character ticks.
+*
+* Server only, owned by the game mode.
+*/
+UCLASS(Config = Game)
+class SURVIVAL_API UStatusEffectManager : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	UStatusEffectManager();
+
+	// Utility to get the manager of the world WorldContextObject lives in. Only exists on the server, may return nullptr.
+	static UStatusEffectManager *Get(const UObject *WorldContextObject);
+
+	// Seconds per wheel tick. Effect intervals are rounded to this.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Status Effects")
+	float TickResolution;
+
+	// Apply Magnitude to Target every Interval seconds, NumTicks times. The first tick is one interval from now.
+	FStatusEffectHandle ApplyEffect(ASurvivalCharacter *Target, EStatusEffectType Type, float Magnitude, float Interval, int32 NumTicks, AController *Instigator = nullptr);
+
+	// End an effect early. Returns false if it already ended.
+	bool CancelEffect(const FStatusEffectHandle &Handle);
+
+	bool IsEffectActive(const FStatusEffectHandle &Handle) const;
+
+	FORCEINLINE int32 GetNumActiveEffects() const
+	{
+		return NumActive;
+	}
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	enum
+	{
+		WheelBits = 6,
+		WheelSize = 1 << WheelBits,
+		WheelMask = WheelSize - 1,
+		WheelLevels = 4
+	};
+
+	struct FStatusEffect
+	{
+		TWeakObjectPtr<ASurvivalCharacter> Target;
+		TWeakObjectPtr<AController> Instigator;
+		float Magnitude;
+		// Absolute wheel tick the effect is next due
+		uint32 DueTick;
+		uint32 IntervalTicks;
+		uint32 Serial;
+		// Next effect in the same wheel slot, or in the free list
+		int32 Next;
+		// 0 once cancelled or finished
+		uint16 TicksRemaining;
+		EStatusEffectType Type;
+
+		FStatusEffect()
+			: Magnitude(0.0f)
+			, DueTick(0)
+			, IntervalTicks(1)
+			, Serial(0)
+			, Next(INDEX_NONE)
+			, TicksRemaining(0)
+			, Type(EStatusEffectType::SE_Regeneration)
+		{}
+	};
+
+	// Advance the wheel by one tick and service what is due
+	void AdvanceWheel();
+
+	// Put Index in the slot its DueTick falls in
+	void Schedule(int32 Index);
+
+	// Move the effects in a slot of a higher level down to where they belong now
+	void Cascade(int32 Level, int32 Slot);
+
+	// Apply one tick of an effect. Returns false, no longer counted as active, if the effect is over.
+	// May run gameplay code that applies new effects, so takes an index rather than a reference.
+	bool ServiceEffect(int32 Index);
+
+	void FreeEffect(int32 Index);
+
+	// All effect records, in use or free
+	TArray<FStatusEffect> Effects;
+
+	// Head of each slot's list, INDEX_NONE when empty
+	int32 Wheel[WheelLevels][WheelSize];
+
+	// Head of the free record list
+	int32 FreeHead;
+
+	int32 NumActive;
+
+	uint32 CurrentTick;
+
+	// Time not yet turned into wheel ticks
+	float Accumulator;
+};
@@ -17,4 +17,7 @@ DECLARE_LOG_CATEGORY_EXTERN(UtilityLib, Log, All);
 
 DECLARE_LOG_CATEGORY_EXTERN(SurvivalDebugLog, Log, All);
 
+// Stats for the world-wide gameplay systems. Use "stat Survival" to view.
+DECLARE_STATS_GROUP(TEXT("Survival"), STATGROUP_Survival, STATCAT_Advanced);
+
 #endif
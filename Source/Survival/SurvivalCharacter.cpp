@@ -3,23 +3,34 @@
 #include "Survival.h"
 #include "SurvivalCharacter.h"
 #include "SurvivalProjectile.h"
+#include "ProjectilePool.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "BallisticsSimulation.h"
 #include "SurvivalGameMode.h"
 #include "Inventory/InventorySystemManager.h"
 #include "Inventory/Items/BaseHealingItem.h"
 
 #include "Inventory/ItemWorldActor.h"
+#include "Inventory/ItemAssetStreamer.h"
+#include "Interaction/InteractionComponent.h"
+#include "Combat/LagCompensationComponent.h"
+#include "Combat/LagCompensationManager.h"
+#include "Combat/DamagePipeline.h"
+#include "SurvivalCharacterMovement.h"
 #include "Utility/UtilityFunctionsLibrary.h"
 #include "Animation/AnimInstance.h"
 #include "GameFramework/InputSettings.h"
 #include "Kismet/HeadMountedDisplayFunctionLibrary.h"
 #include "MotionControllerComponent.h"
+#include "UnrealNetwork.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogFPChar, Warning, All);
 
 //////////////////////////////////////////////////////////////////////////
 // ASurvivalCharacter
 
-ASurvivalCharacter::ASurvivalCharacter()
+ASurvivalCharacter::ASurvivalCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<USurvivalCharacterMovement>(ACharacter::CharacterMovementComponentName))
 {
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -63,14 +74,26 @@ ASurvivalCharacter::ASurvivalCharacter()
 	// Player stats
 	Health = 100.0f;
 	MaxHealth = 100.0f;
-	Stamina = 100.0f;
+	MaxStamina = 100.0f;
+	NeedsIndex = INDEX_NONE;
+	Armor = 0.0f;
 
 	// Default offset from the character location for projectiles to spawn
 	GunOffset = FVector(100.0f, 0.0f, 10.0f);
+	UnarmedRefireDelay = 0.1f;
+	LastServerShotTime = -BIG_NUMBER;
 
 	// Set tracedistance for player actions (i.e: the distance the player must be from the subject of action (doors, pickup items etc.))
 	ActionTraceDistance = 160.0f;
 
+	// Create interaction component, tracing from the camera
+	InteractionComponent = CreateDefaultSubobject<UInteractionComponent>(TEXT("Interaction"));
+	InteractionComponent->TraceSource = FirstPersonCameraComponent;
+	InteractionComponent->InteractionDistance = ActionTraceDistance;
+
+	// Hitbox history for server side hit validation
+	LagCompensationComponent = CreateDefaultSubobject<ULagCompensationComponent>(TEXT("LagCompensation"));
+
 }
 
 void ASurvivalCharacter::BeginPlay()
@@ -82,6 +105,31 @@ void ASurvivalCharacter::BeginPlay()
 	FP_Gun->AttachToComponent(Mesh1P, FAttachmentTransformRules(EAttachmentRule::SnapToTarget, true), TEXT("GripPoint"));
 
 	Mesh1P->SetHiddenInGame(false, true);
+
+	// Have projectiles ready before the first shot
+	UProjectilePool *Pool = UProjectilePool::Get(this);
+	if (Pool != nullptr && ProjectileClass != NULL && !ProjectileClass->GetDefaultObject<ASurvivalProjectile>()->bUseBatchedBallistics)
+	{
+		Pool->Prewarm(ProjectileClass, Pool->PrewarmCount);
+	}
+
+	// Needs are only simulated on the server
+	UNeedsSimulation *NeedsSimulation = UNeedsSimulation::Get(this);
+	if (NeedsSimulation != nullptr)
+	{
+		NeedsSimulation->RegisterCharacter(this);
+	}
+}
+
+void ASurvivalCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UNeedsSimulation *NeedsSimulation = UNeedsSimulation::Get(this);
+	if (NeedsSimulation != nullptr)
+	{
+		NeedsSimulation->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ASurvivalCharacter::Tick(float DeltaTime)
@@ -89,24 +137,86 @@ void ASurvivalCharacter::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 }
 
+void ASurvivalCharacter::Restart()
+{
+	Super::Restart();
+
+	// Only known once possessed; BeginPlay runs before that
+	InteractionComponent->UpdateTickForController();
+}
+
+void ASurvivalCharacter::UnPossessed()
+{
+	Super::UnPossessed();
+
+	InteractionComponent->UpdateTickForController();
+}
+
 float ASurvivalCharacter::TakeDamage(float DamageAmount, struct FDamageEvent const & DamageEvent, class AController * EventInstigator, AActor * DamageCauser)
 {
 	// Call the base class - this will tell us how much damage to apply  
 	const float ActualDamage = Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
 	if (ActualDamage > 0.f)
 	{
-		Health -= ActualDamage;
-
-		// If the damage depletes our health set our lifespan to zero - which will destroy the actor  
-		if (Health <= 0.f)
+		// Resolved together with the rest of this frame's hits
+		UDamagePipeline *DamagePipeline = UDamagePipeline::Get(this);
+		if (DamagePipeline != nullptr)
+		{
+			DamagePipeline->QueueDamage(this, ActualDamage, DamageEvent.DamageTypeClass, EventInstigator, DamageCauser);
+		}
+		else
 		{
-			SetLifeSpan(0.001f);
+			ApplyResolvedDamage(ActualDamage);
 		}
 	}
 
 	return ActualDamage;
 }
 
+float ASurvivalCharacter::GetDamageResistance(TSubclassOf<UDamageType> DamageType) const
+{
+	for (const FDamageResistance &Resistance : Resistances)
+	{
+		if (Resistance.DamageType == DamageType)
+		{
+			return FMath::Clamp(Resistance.Resistance, 0.0f, 1.0f);
+		}
+	}
+	return 0.0f;
+}
+
+bool ASurvivalCharacter::ApplyResolvedDamage(float Damage)
+{
+	if (IsDead())
+	{
+		return false;
+	}
+
+	Health -= Damage;
+
+	// If the damage depletes our health set our lifespan to zero - which will destroy the actor  
+	if (Health <= 0.f)
+	{
+		SetLifeSpan(0.001f);
+		return true;
+	}
+	return false;
+}
+
+void ASurvivalCharacter::ClientReceiveHitReport_Implementation(const FDamageHitReport &Report)
+{
+	OnHitConfirmed(Report);
+}
+
+void ASurvivalCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ASurvivalCharacter, Health);
+	DOREPLIFETIME(ASurvivalCharacter, Armor);
+	DOREPLIFETIME(ASurvivalCharacter, Needs);
+}
+
 float ASurvivalCharacter::TakeHeal_Implementation(float HealAmount, class UBaseHealingItem *HealCauser)
 {
 	if (HealAmount >= MaxHealth)
@@ -118,7 +228,7 @@ float ASurvivalCharacter::TakeHeal_Implementation(float HealAmount, class UBaseH
 	// TODO: Future idea: Perhaps some heal items will negatively/positively affect the player when he
 	// has some form of status ailments. Do these checks here and alter the heal amount respectively.
 
-	Health += HealAmount;
+	Health = FMath::Min(Health + HealAmount, MaxHealth);
 	return HealAmount;
 }
 
@@ -134,8 +244,9 @@ void ASurvivalCharacter::SetupPlayerInputComponent(class UInputComponent* Player
 	PlayerInputComponent->BindAction("Jump", IE_Released, this, &ACharacter::StopJumping);
 
 	PlayerInputComponent->BindAction("Fire", IE_Pressed, this, &ASurvivalCharacter::OnFire);
+	PlayerInputComponent->BindAction("Fire", IE_Released, this, &ASurvivalCharacter::OnStopFire);
 	PlayerInputComponent->BindAction("Action", IE_Pressed, this, &ASurvivalCharacter::OnAction);
-	//PlayerInputComponent->BindAction("Reload", IE_Pressed, this, &ASurvivalCharacter::OnStartReload);
+	PlayerInputComponent->BindAction("Reload", IE_Pressed, this, &ASurvivalCharacter::OnStartReload);
 	PlayerInputComponent->BindAction("ShowInventory", IE_Pressed, this, &ASurvivalCharacter::OnShowInventory);
 
 	PlayerInputComponent->BindAxis("MoveForward", this, &ASurvivalCharacter::MoveForward);
@@ -152,9 +263,56 @@ void ASurvivalCharacter::SetupPlayerInputComponent(class UInputComponent* Player
 
 void ASurvivalCharacter::OnFire()
 {
+	// Equipped weapons fire on their own schedule while the trigger is held
+	UBaseWeaponItem *Weapon = InventoryComponent ? InventoryComponent->EquippedWeapon : nullptr;
+	if (Weapon != nullptr)
+	{
+		Weapon->StartFire();
+		return;
+	}
 
+	if (GetWorld() != NULL)
+	{
+		FireProjectile(ProjectileClass, GetWorld()->GetTimeSeconds());
+	}
+}
+
+void ASurvivalCharacter::OnStopFire()
+{
+	UBaseWeaponItem *Weapon = InventoryComponent ? InventoryComponent->EquippedWeapon : nullptr;
+	if (Weapon != nullptr)
+	{
+		Weapon->StopFire();
+	}
+}
+
+void ASurvivalCharacter::OnStartReload()
+{
+	UBaseWeaponItem *Weapon = InventoryComponent ? InventoryComponent->EquippedWeapon : nullptr;
+	if (Weapon != nullptr)
+	{
+		Weapon->StartReload();
+	}
+}
+
+void ASurvivalCharacter::FireWeaponShot(UBaseWeaponItem *Weapon, float ShotTime)
+{
+	FireProjectile(GetShotProjectileClass(Weapon), ShotTime);
+}
+
+TSubclassOf<ASurvivalProjectile> ASurvivalCharacter::GetShotProjectileClass(const UBaseWeaponItem *Weapon) const
+{
+	if (Weapon != nullptr && Weapon->ProjectileClass.Num() > 0 && Weapon->ProjectileClass[0] != NULL)
+	{
+		return Weapon->ProjectileClass[0];
+	}
+	return ProjectileClass;
+}
+
+void ASurvivalCharacter::FireProjectile(TSubclassOf<ASurvivalProjectile> FireProjectileClass, float ShotTime)
+{
 	// try and fire a projectile
-	if (ProjectileClass != NULL)
+	if (FireProjectileClass != NULL)
 	{
 		UWorld* const World = GetWorld();
 		if (World != NULL)
@@ -163,12 +321,15 @@ void ASurvivalCharacter::OnFire()
 			// MuzzleOffset is in camera space, so transform it to world space before offsetting from the character location to find the final muzzle position
 			const FVector SpawnLocation = ((FP_MuzzleLocation != nullptr) ? FP_MuzzleLocation->GetComponentLocation() : GetActorLocation()) + SpawnRotation.RotateVector(GunOffset);
 
-			//Set Spawn Collision Handling Override
-			FActorSpawnParameters ActorSpawnParams;
-			ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
+			// Shots scheduled earlier in the frame have already been flying for a while
+			const float ShotAge = FMath::Max(World->GetTimeSeconds() - ShotTime, 0.0f);
+			LaunchProjectile(FireProjectileClass, SpawnLocation, SpawnRotation, ShotAge);
 
-			// spawn the projectile at the muzzle
-			World->SpawnActor<ASurvivalProjectile>(ProjectileClass, SpawnLocation, SpawnRotation, ActorSpawnParams);
+			// The local shot is cosmetic on clients; the server decides what it hit
+			if (Role < ROLE_Authority && World->GetGameState() != nullptr)
+			{
+				ServerFire(SpawnLocation, SpawnRotation.Vector(), World->GetGameState()->GetServerWorldTimeSeconds() - ShotAge);
+			}
 		}
 	}
 
@@ -190,18 +351,157 @@ void ASurvivalCharacter::OnFire()
 	}
 }
 
+void ASurvivalCharacter::LaunchProjectile(TSubclassOf<ASurvivalProjectile> LaunchProjectileClass, FVector SpawnLocation, const FRotator &SpawnRotation, float ShotAge)
+{
+	UWorld *World = GetWorld();
+	if (LaunchProjectileClass == NULL || World == nullptr)
+	{
+		return;
+	}
+
+	// launch a batched round or a pooled projectile from the muzzle
+	const ASurvivalProjectile *Template = LaunchProjectileClass->GetDefaultObject<ASurvivalProjectile>();
+	UBallisticsSimulation *Ballistics = UBallisticsSimulation::Get(this);
+	UProjectilePool *Pool = UProjectilePool::Get(this);
+	if (Ballistics != nullptr && Template->bUseBatchedBallistics)
+	{
+		Ballistics->Fire(LaunchProjectileClass, SpawnLocation, SpawnRotation.Vector(), this, ShotAge);
+	}
+	else
+	{
+		if (Template->GetProjectileMovement() != nullptr)
+		{
+			SpawnLocation += SpawnRotation.Vector() * Template->GetProjectileMovement()->InitialSpeed * ShotAge;
+		}
+
+		if (Pool != nullptr)
+		{
+			Pool->Acquire(LaunchProjectileClass, SpawnLocation, SpawnRotation, this, this);
+		}
+		else
+		{
+			//Set Spawn Collision Handling Override
+			FActorSpawnParameters ActorSpawnParams;
+			ActorSpawnParams.Owner = this;
+			ActorSpawnParams.Instigator = this;
+			ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
+
+			// spawn the projectile at the muzzle
+			World->SpawnActor<ASurvivalProjectile>(LaunchProjectileClass, SpawnLocation, SpawnRotation, ActorSpawnParams);
+		}
+	}
+}
+
+bool ASurvivalCharacter::ServerFire_Validate(FVector_NetQuantize Origin, FVector_NetQuantizeNormal Direction, float ViewTime)
+{
+	return !Direction.IsNearlyZero() && !Origin.ContainsNaN();
+}
+
+void ASurvivalCharacter::ServerFire_Implementation(FVector_NetQuantize Origin, FVector_NetQuantizeNormal Direction, float ViewTime)
+{
+	ULagCompensationManager *LagCompensation = ULagCompensationManager::Get(this);
+	UWorld *World = GetWorld();
+	if (LagCompensation == nullptr || World == nullptr)
+	{
+		return;
+	}
+
+	// Don't let clients shoot from somewhere they are not
+	if (FVector::DistSquared(Origin, GetActorLocation()) > FMath::Square(LagCompensation->MaxShotOriginError + GunOffset.Size()))
+	{
+		UE_LOG(SurvivalDebugLog, Warning, TEXT("%s: Rejected shot from %s, too far from the character"), *GetName(), *Origin.ToString());
+		return;
+	}
+
+	// Nor faster than the weapon fires, or with an empty clip. Shots are timed by when the client
+	// fired them, so network jitter does not bunch them up.
+	UBaseWeaponItem *Weapon = InventoryComponent ? InventoryComponent->EquippedWeapon : nullptr;
+	const float ShotTime = LagCompensation->ClampRewindTime(ViewTime);
+	const float RefireDelay = Weapon ? Weapon->fRefireDelay : UnarmedRefireDelay;
+	if (ShotTime < LastServerShotTime + RefireDelay - LagCompensation->MaxShotTimeError)
+	{
+		UE_LOG(SurvivalDebugLog, Warning, TEXT("%s: Rejected shot %.3fs after the last one"), *GetName(), ShotTime - LastServerShotTime);
+		return;
+	}
+	if (Weapon != nullptr && !Weapon->HasAmmo())
+	{
+		UE_LOG(SurvivalDebugLog, Warning, TEXT("%s: Rejected shot, %s is out of ammo"), *GetName(), *Weapon->ID.ToString());
+		return;
+	}
+
+	LastServerShotTime = ShotTime;
+	if (Weapon != nullptr && Weapon->MaxClipSize > 0)
+	{
+		Weapon->ClipSize--;
+	}
+
+	// Resolve the round the way the client did
+	TSubclassOf<ASurvivalProjectile> ShotProjectileClass = GetShotProjectileClass(Weapon);
+	if (ShotProjectileClass == NULL)
+	{
+		return;
+	}
+
+	// Projectile actors take their time to fly on the client; fly one here as well.
+	// It applies its damage on impact (@see ASurvivalProjectile::OnHit).
+	const ASurvivalProjectile *Template = ShotProjectileClass->GetDefaultObject<ASurvivalProjectile>();
+	UBallisticsSimulation *Ballistics = UBallisticsSimulation::Get(this);
+	const float ShotAge = World->GetTimeSeconds() - ShotTime;
+	if (!Template->bUseBatchedBallistics || Ballistics == nullptr)
+	{
+		LaunchProjectile(ShotProjectileClass, Origin, Direction.Rotation(), ShotAge);
+		return;
+	}
+
+	// Batched rounds drop and take time to arrive, as on the client. The part of the path flown
+	// before now is tested step by step against the hitboxes as they were at that moment;
+	// the simulation takes over from where the round is now.
+	FCollisionQueryParams Params(NAME_None, false, this);
+	FVector Start = Origin;
+	float FlightTime = 0.0f;
+	while (FlightTime < ShotAge)
+	{
+		FlightTime = FMath::Min(FlightTime + Ballistics->FixedTimeStep, ShotAge);
+		const FVector End = Ballistics->GetRoundPathLocation(ShotProjectileClass, Origin, Direction, FlightTime);
+
+		FLagCompensatedHit Hit;
+		if (LagCompensation->RewindLineTest(ShotTime + FlightTime, Start, End, this, Hit))
+		{
+			FHitResult HitResult(Hit.Actor, nullptr, Hit.Location, -Direction);
+			UGameplayStatics::ApplyPointDamage(Hit.Actor, Template->BallisticDamage, Direction, HitResult, GetController(), this, UDamageType::StaticClass());
+			return;
+		}
+
+		// Stopped by the level before it got to where the simulation would pick it up
+		if (World->LineTraceTestByObjectType(Start, End, FCollisionObjectQueryParams(ECC_WorldStatic), Params))
+		{
+			return;
+		}
+		Start = End;
+	}
+
+	Ballistics->Fire(ShotProjectileClass, Origin, Direction, this, ShotAge, false);
+}
+
 void ASurvivalCharacter::OnAction()
 {
+	// Act on what the interaction component has already found. No trace needed.
+	if (InteractionComponent != nullptr && InteractionComponent->HasFocusResult())
+	{
+		HandleAction(InteractionComponent->GetFocusedActor());
+		return;
+	}
+
 	if (FirstPersonCameraComponent == nullptr)
 	{
 		UE_LOG(SurvivalDebugLog, Error, TEXT("FirstPersonCamera component null! Cannot do trace."));
 		return;
 	}
 
+	// No focus result yet (first frames after spawn). Fall back to a blocking trace.
 	UWorld *World = GetWorld();
 
 	// Start trace from the FP camera, and set it a bit in front of the camera location to better match the arm reach.
-	const FRotator StartRotation = GetControlRotation();
 	const FVector Start = FirstPersonCameraComponent->GetComponentLocation() + (FirstPersonCameraComponent->GetForwardVector() * 20.0f);
 	const FVector End = Start + (FirstPersonCameraComponent->GetForwardVector() * ActionTraceDistance);
 	FHitResult HitResult;
@@ -209,39 +509,51 @@ void ASurvivalCharacter::OnAction()
 	//--------------
 	// Do the trace
 
-	if (UUtilityFunctionsLibrary::TraceLine(World, this, Start, End, HitResult, ECollisionChannel::ECC_WorldStatic, false, true))
+	if (UUtilityFunctionsLibrary::TraceLine(World, this, Start, End, HitResult, ECollisionChannel::ECC_WorldStatic))
 	{
-		UE_LOG(SurvivalDebugLog, Warning, TEXT("Trace hit: %s"), *HitResult.GetActor()->GetName());
-		
-		// #1
-		// Check if we found a world item pickup actor
-		AItemWorldActor *ItemPickupActor = Cast<AItemWorldActor>(HitResult.GetActor());
-		if (ItemPickupActor != nullptr && ItemPickupActor->ItemTypeReference != nullptr)
-		{
-			// The world item pickup actor had a valid reference to an item. Handle it individually
-			HandlePickupItem(ItemPickupActor);
-		}
-
-		// #2
-		// Check if we instead found a weapon pickup point
-		/*
-		AWeaponWorldActor *WeaponPickupActor = Cast<AWeaponWorldActor>(HitResult.GetActor());
-		if( WeaponPickupActor != nullptr && WeaponPickupActor->WeaponTypeReference != nullptr)
-		{
-			HandlePickupWeapon(WeaponPickupActor->WeaponTypeReference);
-		}
-		*/
-
-		// #3
-		// Is it a door?
-
+		HandleAction(HitResult.GetActor());
 	}
 	else
 	{
+		HandleAction(nullptr);
+	}
+}
+
+void ASurvivalCharacter::HandleAction(AActor *Target)
+{
+	if (Target == nullptr)
+	{
+#if IN_DEVMODE == 1
+		UE_LOG(SurvivalDebugLog, Warning, TEXT("Action target: NOTHING"));
+#endif
+		return;
+	}
+
 #if IN_DEVMODE == 1
-		UE_LOG(SurvivalDebugLog, Warning, TEXT("Trace hit: NOTHING"));
+	UE_LOG(SurvivalDebugLog, Verbose, TEXT("Action target: %s"), *Target->GetName());
 #endif
+
+	// #1
+	// Check if we found a world item pickup actor
+	AItemWorldActor *ItemPickupActor = Cast<AItemWorldActor>(Target);
+	if (ItemPickupActor != nullptr && ItemPickupActor->ItemTypeReference != nullptr)
+	{
+		// The world item pickup actor had a valid reference to an item. Handle it individually
+		HandlePickupItem(ItemPickupActor);
 	}
+
+	// #2
+	// Check if we instead found a weapon pickup point
+	/*
+	AWeaponWorldActor *WeaponPickupActor = Cast<AWeaponWorldActor>(Target);
+	if( WeaponPickupActor != nullptr && WeaponPickupActor->WeaponTypeReference != nullptr)
+	{
+		HandlePickupWeapon(WeaponPickupActor->WeaponTypeReference);
+	}
+	*/
+
+	// #3
+	// Is it a door?
 }
 
 void ASurvivalCharacter::OnShowInventory()
@@ -299,52 +611,10 @@ void ASurvivalCharacter::HandlePickupItem(AItemWorldActor *ItemPickup)
 		ItemPickup->ItemTypeReference->ID, 
 		ItemPickup->StackSize, 
 		ItemPickup->ItemTypeReference->GetItemType(), 
-		ItemPickup->ItemTypeClass))
+		ItemPickup->ItemTypeClass,
+		&ItemPickup->DecayState))
 	{
 		ItemPickup->Destroy(true);
-
-		// DEBUG print inventory
-		for (int i = 0; i < InventoryComponent->Items.Num(); i++)
-		{
-			const FItemSlotInfo *ItemSlot = &InventoryComponent->Items[i];
-
-			if (ItemSlot->ItemTypeReference->GetItemType() == EItemType::IT_Item)
-			{
-				UE_LOG(InventorySystemLog, Warning, TEXT("Item: [%s] - Slot: %d | Stack: [%d] | MaxStack: [%d] | Class: [%s]"),
-					*ItemSlot->ItemTypeReference->Name.ToString(),
-					ItemSlot->SlotIndex,
-					ItemSlot->StackSize,
-					ItemSlot->MaxStackSize,
-					*ItemSlot->ItemTypeClass->GetSuperClass()->GetName());
-			}
-			else
-			{
-				FString type = FString(TEXT("Base Weapon"));
-				UBaseWeaponItem *Wep = Cast<UBaseWeaponItem>(ItemSlot->ItemTypeReference);
-				if(Wep && Wep->IsValidLowLevel())
-				{
-					if (Wep->WeaponType == EWeaponType::WT_Projectile)
-					{
-						type = FString(TEXT("WT_Projectile"));
-					}
-					else if( Wep->WeaponType == EWeaponType::WT_Bludgeon)
-					{
-						type = FString(TEXT("WT_Bludgeon"));
-					}
-				}
-
-				UE_LOG(InventorySystemLog, Warning, TEXT("Item: [%s] - Slot: %d | Stack: [%d] | MaxStack: [%d] | Clip: [%d] | MaxClip: [%d] | Type: [%s] | Class: [%s]"),
-					*ItemSlot->ItemTypeReference->Name.ToString(),
-					ItemSlot->SlotIndex,
-					ItemSlot->StackSize,
-					ItemSlot->MaxStackSize,
-					Wep->ClipSize,
-					Wep->MaxClipSize,
-					*type,
-					*ItemSlot->ItemTypeClass->GetSuperClass()->GetName());
-			}
-			
-		}
 	}
 	else
 	{
@@ -355,17 +625,27 @@ void ASurvivalCharacter::HandlePickupItem(AItemWorldActor *ItemPickup)
 	// InventoryComponent handles all add/checks
 }
 
-void ASurvivalCharacter::HandleEquipWeapon(UBaseWeaponItem *WeaponItem)
+void ASurvivalCharacter::HandleEquipWeapon(UBaseWeaponItem *WeaponItem, ABaseWeaponActor *PreparedActor)
 {
+	// The hot-bar actor is already showing the weapon
+	if (PreparedActor != nullptr)
+	{
+		FP_Gun->SetHiddenInGame(true);
+		return;
+	}
+
+	FP_Gun->SetHiddenInGame(false);
 	if (WeaponItem)
 	{
-		if (WeaponItem->DetailMesh && WeaponItem->DetailMesh->IsValidLowLevel())
+		// Prefetched weapons are ready right away, others swap in once streamed
+		UItemAssetStreamer *Streamer = UItemAssetStreamer::Get(this);
+		if (WeaponItem->DetailMesh.IsValid() || Streamer == nullptr)
 		{
-			FP_Gun->SetSkeletalMesh(WeaponItem->DetailMesh);
+			OnWeaponMeshLoaded(WeaponItem);
 		}
 		else
 		{
-			UE_LOG(SurvivalDebugLog, Warning, TEXT("HandleEquipWeapon : Detailmesh not valid!"));
+			Streamer->RequestItemAssets(WeaponItem, FSimpleDelegate::CreateUObject(this, &ASurvivalCharacter::OnWeaponMeshLoaded, WeaponItem));
 		}
 	}
 	else
@@ -374,6 +654,34 @@ void ASurvivalCharacter::HandleEquipWeapon(UBaseWeaponItem *WeaponItem)
 	}
 }
 
+void ASurvivalCharacter::OnWeaponMeshLoaded(UBaseWeaponItem *WeaponItem)
+{
+	// Might have switched weapons while loading
+	if (InventoryComponent == nullptr || InventoryComponent->EquippedWeapon != WeaponItem)
+	{
+		return;
+	}
+
+	USkeletalMesh *Mesh = WeaponItem->DetailMesh.Get();
+	if (Mesh != nullptr)
+	{
+		FP_Gun->SetSkeletalMesh(Mesh);
+	}
+	else
+	{
+		UE_LOG(SurvivalDebugLog, Warning, TEXT("HandleEquipWeapon : Detailmesh not valid!"));
+	}
+}
+
+void ASurvivalCharacter::HandleUnEquipWeapon()
+{
+	if (FP_Gun && FP_Gun->IsValidLowLevel())
+	{
+		FP_Gun->SetSkeletalMesh(NULL);
+		FP_Gun->SetHiddenInGame(false);
+	}
+}
+
 bool ASurvivalCharacter::CraftItems(int32 SlotA, int32 SlotB)
 {
 	if (!InventoryComponent)
@@ -457,13 +765,9 @@ void ASurvivalCharacter::Equip(int32 Slot)
 
 void ASurvivalCharacter::UnEquip()
 {
-	if (FP_Gun && FP_Gun->IsValidLowLevel())
+	if (InventoryComponent)
 	{
-		FP_Gun->SetSkeletalMesh(NULL);
-		if (InventoryComponent)
-		{
-			InventoryComponent->UnEquipItem();
-		}
+		InventoryComponent->UnEquipItem();
 	}
 }
 
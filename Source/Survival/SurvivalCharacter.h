@@ -2,6 +2,8 @@
 #pragma once
 #include "GameFramework/Character.h"
 #include "Inventory/InventoryComponent.h"
+#include "Combat/DamagePipeline.h"
+#include "NeedsSimulation.h"
 #include "SurvivalCharacter.generated.h"
 
 
@@ -33,16 +35,31 @@ class ASurvivalCharacter : public ACharacter
 	class UCameraComponent* FirstPersonCameraComponent;
 		
 public:
-	ASurvivalCharacter();
+	ASurvivalCharacter(const FObjectInitializer& ObjectInitializer);
 
 	virtual void BeginPlay();
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void Tick(float Delta) override;
 
+	// Called on the server and the owning client whenever a controller takes over the pawn
+	virtual void Restart() override;
+
+	virtual void UnPossessed() override;
+
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	class UInventoryComponent *InventoryComponent;
 
+	/** Continuously traces for what the player is looking at, used by OnAction */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Gameplay, meta = (AllowPrivateAccess = "true"))
+	class UInteractionComponent *InteractionComponent;
+
+	/** Server side hitbox history, so shots can be tested where the shooter saw us */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Gameplay, meta = (AllowPrivateAccess = "true"))
+	class ULagCompensationComponent *LagCompensationComponent;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Gameplay)
 	float ActionTraceDistance;
 
@@ -62,6 +79,10 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category=Projectile)
 	TSubclassOf<class ASurvivalProjectile> ProjectileClass;
 
+	/** Shortest time between shots the server accepts without a weapon equipped */
+	UPROPERTY(EditDefaultsOnly, Category=Projectile)
+	float UnarmedRefireDelay;
+
 	/** Sound to play each time we fire */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Gameplay)
 	class USoundBase* FireSound;
@@ -74,14 +95,49 @@ public:
 	///////////////////////////////////////////////////////////
 	// Player stats
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Stats")
+	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite, Category = "Player Stats")
 	float Health;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Stats")
 	float MaxHealth;
 
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Stats")
+	float MaxStamina;
+
+	/** Hunger, thirst, temperature, stamina and bleeding. Simulated by UNeedsSimulation, this is its replicated copy. */
+	UPROPERTY(Replicated, EditAnywhere, BlueprintReadOnly, Category = "Player Stats")
+	FSurvivalNeeds Needs;
+
+	/** Called on the server when we enter or leave a need threshold (starving, exhausted, ...) */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Player Stats")
+	void OnNeedThresholdChanged(ENeedThreshold Threshold, bool bActive);
+
+	/** Reduces all incoming damage (@see UDamagePipeline::ArmorHalfPoint) */
+	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite, Category = "Player Stats")
+	float Armor;
+
+	/** Reduces damage of specific damage types */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Stats")
-	float Stamina;
+	TArray<FDamageResistance> Resistances;
+
+	FORCEINLINE bool IsDead() const
+	{
+		return Health <= 0.f;
+	}
+
+	/** Fraction of DamageType damage we ignore */
+	float GetDamageResistance(TSubclassOf<UDamageType> DamageType) const;
+
+	/** Called by the damage pipeline with this frame's damage after mitigation. Returns true if it killed us. */
+	bool ApplyResolvedDamage(float Damage);
+
+	/** Aggregated result of our hits on one victim this frame */
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveHitReport(const FDamageHitReport &Report);
+
+	/** Hit marker / feedback hook */
+	UFUNCTION(BlueprintImplementableEvent, Category = Damage)
+	void OnHitConfirmed(const FDamageHitReport &Report);
 
 
 public:
@@ -114,16 +170,55 @@ public:
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = Inventory)
 	float TakeHeal(float HealAmount, class UBaseHealingItem *HealCauser);
 
-	void HandleEquipWeapon(class UBaseWeaponItem *WeaponItem);
+	/** Show WeaponItem in first person. PreparedActor is the weapon's hot-bar actor, if it has one. */
+	void HandleEquipWeapon(class UBaseWeaponItem *WeaponItem, class ABaseWeaponActor *PreparedActor = nullptr);
+
+	/** Called by the inventory when the equipped weapon is put away */
+	void HandleUnEquipWeapon();
+
+	/** Called when the detail mesh of an equipped weapon is loaded */
+	void OnWeaponMeshLoaded(class UBaseWeaponItem *WeaponItem);
+
+	/** Called by the equipped weapon for each scheduled shot. ShotTime is the exact world time the shot was due. */
+	void FireWeaponShot(class UBaseWeaponItem *Weapon, float ShotTime);
 
 protected:
+	friend class UNeedsSimulation;
+
+	/** Index in the needs simulation, INDEX_NONE when not simulated */
+	int32 NeedsIndex;
+
+	/** Server only: client view time of the last shot ServerFire accepted */
+	float LastServerShotTime;
 	
-	/** Fires a projectile. */
+	/** Pulls the trigger of the equipped weapon, or fires a single projectile without one. */
 	void OnFire();
 
-	/** Performs an appropriate action (pick up item, open door, etc.) */
+	/** Releases the trigger of the equipped weapon */
+	void OnStopFire();
+
+	/** Reloads the equipped weapon */
+	void OnStartReload();
+
+	/** Fires a projectile that was due at world time ShotTime */
+	void FireProjectile(TSubclassOf<class ASurvivalProjectile> FireProjectileClass, float ShotTime);
+
+	/** Launches a batched round or a projectile actor that has been flying for ShotAge seconds */
+	void LaunchProjectile(TSubclassOf<class ASurvivalProjectile> LaunchProjectileClass, FVector SpawnLocation, const FRotator &SpawnRotation, float ShotAge);
+
+	/** The projectile Weapon fires, or ProjectileClass without one */
+	TSubclassOf<class ASurvivalProjectile> GetShotProjectileClass(const class UBaseWeaponItem *Weapon) const;
+
+	/** Validates a client shot against the lag compensated hitboxes at the client's view time */
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerFire(FVector_NetQuantize Origin, FVector_NetQuantizeNormal Direction, float ViewTime);
+
+	/** Performs an appropriate action (pick up item, open door, etc.) on what the player is looking at */
 	void OnAction();
 
+	/** Performs the action on the actor (pick up item, open door, etc.) */
+	void HandleAction(AActor *Target);
+
 	/** Opens the inventory UI */
 	void OnShowInventory();
 
@@ -153,6 +248,7 @@ protected:
 	// APawn / AActor interface
 	virtual void SetupPlayerInputComponent(UInputComponent* InputComponent) override;
 	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const & DamageEvent, class AController * EventInstigator, AActor * DamageCauser) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &OutLifetimeProps) const override;
 	// End of APawn interface
 
 public:
@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "SurvivalCharacterMovement.h"
+#include "Inventory/InventoryComponent.h"
+
+
+float USurvivalCharacterMovement::GetMaxSpeed() const
+{
+	const float MaxSpeed = Super::GetMaxSpeed();
+
+	const ASurvivalCharacter *SurvivalCharacter = Cast<ASurvivalCharacter>(CharacterOwner);
+	if (SurvivalCharacter == nullptr || SurvivalCharacter->InventoryComponent == nullptr)
+	{
+		return MaxSpeed;
+	}
+	return MaxSpeed * SurvivalCharacter->InventoryComponent->EncumbranceSpeedScale;
+}
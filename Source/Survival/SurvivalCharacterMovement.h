@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameFramework/CharacterMovementComponent.h"
+#include "SurvivalCharacterMovement.generated.h"
+
+/**
+* Character movement that slows down with carried weight.
+* The inventory keeps its encumbrance up to date as items change, so this only reads a cached value.
+*/
+UCLASS()
+class SURVIVAL_API USurvivalCharacterMovement : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual float GetMaxSpeed() const override;
+};
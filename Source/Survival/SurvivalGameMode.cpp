@@ -7,6 +7,12 @@
 #include "SurvivalHUD.h"
 #include "SurvivalCharacter.h"
 #include "Inventory/InventorySystemManager.h"
+#include "Inventory/ItemWorldManager.h"
+#include "Inventory/Loot/LootSpawnManager.h"
+#include "Combat/LagCompensationManager.h"
+#include "Combat/DamagePipeline.h"
+#include "NeedsSimulation.h"
+#include "StatusEffectManager.h"
 
 ASurvivalGameMode::ASurvivalGameMode()
 	: Super()
@@ -21,6 +27,12 @@ ASurvivalGameMode::ASurvivalGameMode()
 	PlayerStateClass = ASurvivalPlayerState::StaticClass();
 
 	InventorySystemManager = NewObject<UInventorySystemManager>(this, FName("Inventory System Manager"));
+	ItemWorldManager = nullptr;
+	LootSpawnManager = nullptr;
+	LagCompensationManager = nullptr;
+	DamagePipeline = nullptr;
+	NeedsSimulation = nullptr;
+	StatusEffectManager = nullptr;
 }
 
 void ASurvivalGameMode::InitGame(const FString & MapName, const FString & Options, FString & ErrorMessage)
@@ -38,4 +50,23 @@ void ASurvivalGameMode::InitGame(const FString & MapName, const FString & Option
 	{
 		UE_LOG(SurvivalDebugLog, Error, TEXT("Inventory system manager not valid object!"));
 	}
+
+	// World systems are created per game, never on the CDO
+	ItemWorldManager = NewObject<UItemWorldManager>(this, FName("Item World Manager"));
+	LootSpawnManager = NewObject<ULootSpawnManager>(this, FName("Loot Spawn Manager"));
+	LagCompensationManager = NewObject<ULagCompensationManager>(this, FName("Lag Compensation Manager"));
+	DamagePipeline = NewObject<UDamagePipeline>(this, FName("Damage Pipeline"));
+	NeedsSimulation = NewObject<UNeedsSimulation>(this, FName("Needs Simulation"));
+	StatusEffectManager = NewObject<UStatusEffectManager>(this, FName("Status Effect Manager"));
+}
+
+void ASurvivalGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	// Level actors have begun play; fill the loot spawn points
+	if (LootSpawnManager)
+	{
+		LootSpawnManager->PopulateAll();
+	}
 }
\ No newline at end of file
@@ -14,10 +14,30 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory System Manager")
 	class UInventorySystemManager *InventorySystemManager;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "World Items")
+	class UItemWorldManager *ItemWorldManager;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Loot)
+	class ULootSpawnManager *LootSpawnManager;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Lag Compensation")
+	class ULagCompensationManager *LagCompensationManager;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Damage)
+	class UDamagePipeline *DamagePipeline;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Needs)
+	class UNeedsSimulation *NeedsSimulation;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Status Effects")
+	class UStatusEffectManager *StatusEffectManager;
+
 
 public:
 
 	virtual void InitGame(const FString & MapName, const FString & Options, FString & ErrorMessage) override;
+
+	virtual void StartPlay() override;
 };
 
 
@@ -2,7 +2,33 @@
 
 #include "Survival.h"
 #include "SurvivalGameStateBase.h"
+#include "Utility/SceneQueryBatcher.h"
+#include "Inventory/Weapons/WeaponUpdateManager.h"
+#include "ProjectilePool.h"
+#include "BallisticsSimulation.h"
+#include "Inventory/ItemAssetStreamer.h"
+#include "Inventory/ItemDecayScheduler.h"
 
 
+ASurvivalGameStateBase::ASurvivalGameStateBase()
+{
+	SceneQueryBatcher = nullptr;
+	WeaponUpdateManager = nullptr;
+	ProjectilePool = nullptr;
+	BallisticsSimulation = nullptr;
+	ItemAssetStreamer = nullptr;
+	ItemDecayScheduler = nullptr;
+}
 
+void ASurvivalGameStateBase::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
 
+	// World systems are created per game, never on the CDO
+	SceneQueryBatcher = NewObject<USceneQueryBatcher>(this, FName("Scene Query Batcher"));
+	WeaponUpdateManager = NewObject<UWeaponUpdateManager>(this, FName("Weapon Update Manager"));
+	ProjectilePool = NewObject<UProjectilePool>(this, FName("Projectile Pool"));
+	BallisticsSimulation = NewObject<UBallisticsSimulation>(this, FName("Ballistics Simulation"));
+	ItemAssetStreamer = NewObject<UItemAssetStreamer>(this, FName("Item Asset Streamer"));
+	ItemDecayScheduler = NewObject<UItemDecayScheduler>(this, FName("Item Decay Scheduler"));
+}
@@ -6,14 +6,33 @@
 #include "SurvivalGameStateBase.generated.h"
 
 /**
- * 
+ * Game state. Owns the world systems that both the server and clients need.
  */
 UCLASS()
 class SURVIVAL_API ASurvivalGameStateBase : public AGameStateBase
 {
 	GENERATED_BODY()
 	
-	
-	
-	
+public:
+	ASurvivalGameStateBase();
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Scene Queries")
+	class USceneQueryBatcher *SceneQueryBatcher;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Weapons)
+	class UWeaponUpdateManager *WeaponUpdateManager;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Weapons)
+	class UProjectilePool *ProjectilePool;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Weapons)
+	class UBallisticsSimulation *BallisticsSimulation;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Streaming)
+	class UItemAssetStreamer *ItemAssetStreamer;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
+	class UItemDecayScheduler *ItemDecayScheduler;
+
+	virtual void PostInitializeComponents() override;
 };
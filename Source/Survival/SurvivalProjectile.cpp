@@ -3,6 +3,7 @@
 #include "Survival.h"
 #include "SurvivalProjectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
+#include "ProjectilePool.h"
 
 ASurvivalProjectile::ASurvivalProjectile() 
 {
@@ -27,17 +28,83 @@ ASurvivalProjectile::ASurvivalProjectile()
 	ProjectileMovement->bRotationFollowsVelocity = true;
 	ProjectileMovement->bShouldBounce = true;
 
-	// Die after 3 seconds by default
+	// Die after 3 seconds by default. Pooled projectiles use PooledLifetime instead.
 	InitialLifeSpan = 3.0f;
+	PooledLifetime = 3.0f;
+
+	bUseBatchedBallistics = false;
+	BallisticDamage = 20.0f;
+	BallisticImpulseScale = 100.0f;
+
+	bPoolActive = false;
+	PoolGeneration = 0;
 }
 
 void ASurvivalProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
-	// Only add impulse and destroy projectile if we hit a physics
-	if ((OtherActor != NULL) && (OtherActor != this) && (OtherComp != NULL) && OtherComp->IsSimulatingPhysics())
+	if ((OtherActor == NULL) || (OtherActor == this) || (OtherActor == GetOwner()))
+	{
+		return;
+	}
+
+	// Damage is only dealt where there is an authoritative game mode; projectiles on clients are visuals.
+	// Characters queue it in the damage pipeline from TakeDamage.
+	UWorld *World = GetWorld();
+	const bool bDealsDamage = BallisticDamage > 0.0f && OtherActor->bCanBeDamaged && World != nullptr && World->GetAuthGameMode() != nullptr;
+	if (bDealsDamage)
+	{
+		UGameplayStatics::ApplyPointDamage(OtherActor, BallisticDamage, GetVelocity().GetSafeNormal(), Hit,
+			Instigator ? Instigator->GetController() : nullptr, this, UDamageType::StaticClass());
+	}
+
+	// Only add impulse if we hit a physics
+	const bool bPhysicsHit = (OtherComp != NULL) && OtherComp->IsSimulatingPhysics();
+	if (bPhysicsHit)
 	{
 		OtherComp->AddImpulseAtLocation(GetVelocity() * 100.0f, GetActorLocation());
+	}
 
+	// Keep bouncing off the level, stop at pawns and anything we pushed
+	if (bPhysicsHit || Cast<APawn>(OtherActor) != nullptr)
+	{
+		Recycle();
+	}
+}
+
+void ASurvivalProjectile::ActivateFromPool(const FVector& Location, const FRotator& Rotation)
+{
+	bPoolActive = true;
+
+	SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	ProjectileMovement->SetUpdatedComponent(CollisionComp);
+	ProjectileMovement->Velocity = Rotation.Vector() * ProjectileMovement->InitialSpeed;
+	ProjectileMovement->UpdateComponentVelocity();
+	ProjectileMovement->Activate(true);
+}
+
+void ASurvivalProjectile::DeactivateToPool()
+{
+	bPoolActive = false;
+
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+}
+
+void ASurvivalProjectile::Recycle()
+{
+	UProjectilePool *Pool = bPoolActive ? UProjectilePool::Get(this) : nullptr;
+	if (Pool != nullptr)
+	{
+		Pool->Release(this);
+	}
+	else
+	{
 		Destroy();
 	}
 }
\ No newline at end of file
@@ -8,6 +8,8 @@ class ASurvivalProjectile : public AActor
 {
 	GENERATED_BODY()
 
+	friend class UProjectilePool;
+
 	/** Sphere collision component */
 	UPROPERTY(VisibleDefaultsOnly, Category=Projectile)
 	class USphereComponent* CollisionComp;
@@ -19,6 +21,22 @@ class ASurvivalProjectile : public AActor
 public:
 	ASurvivalProjectile();
 
+	/** Seconds a pooled projectile stays in flight before it returns to the pool */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Projectile)
+	float PooledLifetime;
+
+	/** Simulate this projectile in the batched ballistics simulation instead of as an actor */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Projectile)
+	bool bUseBatchedBallistics;
+
+	/** Damage dealt on hit, by projectile actors and batched rounds alike */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Projectile)
+	float BallisticDamage;
+
+	/** Scale of the round's velocity applied as impulse to physics objects it hits */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Projectile)
+	float BallisticImpulseScale;
+
 	/** called when projectile hits something */
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
@@ -27,5 +45,22 @@ public:
 	FORCEINLINE class USphereComponent* GetCollisionComp() const { return CollisionComp; }
 	/** Returns ProjectileMovement subobject **/
 	FORCEINLINE class UProjectileMovementComponent* GetProjectileMovement() const { return ProjectileMovement; }
+
+protected:
+	/** Called by the pool to launch the projectile from Location */
+	void ActivateFromPool(const FVector& Location, const FRotator& Rotation);
+
+	/** Called by the pool to park the projectile until it is needed again */
+	void DeactivateToPool();
+
+	/** Return to the pool if we came from one, destroy otherwise */
+	void Recycle();
+
+private:
+	/** True while launched from the pool */
+	bool bPoolActive;
+
+	/** Bumped every time the projectile returns to the pool */
+	int32 PoolGeneration;
 };
 
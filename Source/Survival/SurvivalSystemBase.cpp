@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "SurvivalSystemBase.h"
+
+
+UWorld *USurvivalSystemBase::GetWorld() const
+{
+	// Templates never belong to a world
+	if (IsTemplate() || GetOuter() == nullptr)
+	{
+		return nullptr;
+	}
+	return GetOuter()->GetWorld();
+}
+
+bool USurvivalSystemBase::IsTickable() const
+{
+	return !IsTemplate() && !IsPendingKill() && GetWorld() != nullptr;
+}
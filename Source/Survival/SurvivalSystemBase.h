@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "UObject/NoExportTypes.h"
+#include "Tickable.h"
+#include "SurvivalSystemBase.generated.h"
+
+/**
+ * Base for the world-wide gameplay systems owned by the game mode (server only)
+ * or the game state (server and clients). Systems are ticked once per frame as a
+ * whole instead of having every actor/item they manage tick individually.
+ */
+UCLASS(Abstract)
+class SURVIVAL_API USurvivalSystemBase : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// Systems live in the world of the actor that owns them
+	virtual UWorld *GetWorld() const override;
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override {}
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override { return this->GetStatID(); }
+};
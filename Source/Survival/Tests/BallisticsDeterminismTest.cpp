@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "AutomationTest.h"
+#include "SurvivalTestWorld.h"
+#include "BallisticsSimulation.h"
+#include "SurvivalProjectile.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BallisticsDeterminismTest
+{
+	const int32 NumRounds = 10;
+
+	// Long enough for the older rounds to run out of lifetime and be removed mid-run
+	const int32 NumSteps = 150;
+
+	// Same rounds every run: spread out directions, some fired a while ago
+	void FireRounds(UBallisticsSimulation *Simulation)
+	{
+		for (int32 i = 0; i < NumRounds; i++)
+		{
+			const FVector Location(100.0f * i, -50.0f * i, 200.0f + 10.0f * i);
+			const FVector Direction = FRotator(5.0f * i - 20.0f, 36.0f * i, 0.0f).Vector();
+			const float Age = 0.15f * i;
+			Simulation->Fire(ASurvivalProjectile::StaticClass(), Location, Direction, nullptr, Age);
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBallisticsDeterminismTest, "Survival.Ballistics.Determinism", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Runs the same rounds through two simulations with the fixed step and expects
+// bit for bit the same positions and velocities after every step
+bool FBallisticsDeterminismTest::RunTest(const FString &Parameters)
+{
+	using namespace BallisticsDeterminismTest;
+
+	FSurvivalTestWorld TestWorld;
+	AGameStateBase *GameState = TestWorld.World->GetGameState();
+	if (GameState == nullptr)
+	{
+		AddError(TEXT("Test world has no game state"));
+		return false;
+	}
+
+	// Systems live in the world of their owner
+	UBallisticsSimulation *RunA = NewObject<UBallisticsSimulation>(GameState);
+	UBallisticsSimulation *RunB = NewObject<UBallisticsSimulation>(GameState);
+	FireRounds(RunA);
+	FireRounds(RunB);
+
+	if (RunA->GetNumRounds() != NumRounds || RunB->GetNumRounds() != NumRounds)
+	{
+		AddError(FString::Printf(TEXT("Fired %d rounds, %d and %d are in flight"), NumRounds, RunA->GetNumRounds(), RunB->GetNumRounds()));
+		return false;
+	}
+
+	for (int32 Step = 0; Step < NumSteps; Step++)
+	{
+		RunA->Step(RunA->FixedTimeStep);
+		RunB->Step(RunB->FixedTimeStep);
+
+		if (RunA->GetNumRounds() != RunB->GetNumRounds())
+		{
+			AddError(FString::Printf(TEXT("Step %d: %d rounds in flight, second run has %d"), Step, RunA->GetNumRounds(), RunB->GetNumRounds()));
+			return false;
+		}
+
+		for (int32 Round = 0; Round < RunA->GetNumRounds(); Round++)
+		{
+			// Exact comparison; any difference means the runs diverged
+			if (RunA->GetRoundLocation(Round) != RunB->GetRoundLocation(Round) || RunA->GetRoundVelocity(Round) != RunB->GetRoundVelocity(Round))
+			{
+				AddError(FString::Printf(TEXT("Step %d: round %d is at %s moving %s, second run has %s moving %s"), Step, Round,
+					*RunA->GetRoundLocation(Round).ToString(), *RunA->GetRoundVelocity(Round).ToString(),
+					*RunB->GetRoundLocation(Round).ToString(), *RunB->GetRoundVelocity(Round).ToString()));
+				return false;
+			}
+		}
+	}
+
+	// The run is only a meaningful check if rounds expired along the way
+	TestTrue(TEXT("Rounds expired during the run"), RunA->GetNumRounds() < NumRounds);
+	return true;
+}
+
+#endif
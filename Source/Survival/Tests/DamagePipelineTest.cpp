@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "AutomationTest.h"
+#include "SurvivalTestWorld.h"
+#include "Combat/DamagePipeline.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DamagePipelineTest
+{
+	// Keeps what the pipeline broadcast
+	struct FReportLog
+	{
+		int32 Broadcasts;
+		TArray<FDamageHitReport> Reports;
+
+		FReportLog()
+		{
+			Broadcasts = 0;
+		}
+
+		void OnReportsResolved(const TArray<FDamageHitReport> &NewReports)
+		{
+			Broadcasts++;
+			Reports = NewReports;
+		}
+
+		const FDamageHitReport *FindReport(const AActor *Victim) const
+		{
+			return Reports.FindByPredicate([Victim](const FDamageHitReport &Report) { return Report.Victim == Victim; });
+		}
+	};
+
+	// Hit the way projectiles and batched rounds do, through the victim's TakeDamage
+	void ShootAt(ASurvivalCharacter *Victim, float Damage)
+	{
+		UGameplayStatics::ApplyPointDamage(Victim, Damage, FVector::ForwardVector, FHitResult(), nullptr, nullptr, UDamageType::StaticClass());
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDamagePipelineTest, "Survival.Combat.DamagePipeline", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Queues a frame of hits on several characters and checks that each victim takes one
+// health change with resistance and armor applied per hit, and gets one report
+bool FDamagePipelineTest::RunTest(const FString &Parameters)
+{
+	using namespace DamagePipelineTest;
+
+	FSurvivalTestWorld TestWorld;
+	UDamagePipeline *Pipeline = UDamagePipeline::Get(TestWorld.World);
+	ASurvivalCharacter *Resistant = TestWorld.SpawnCharacter();
+	ASurvivalCharacter *Armored = TestWorld.SpawnCharacter();
+	ASurvivalCharacter *Unprotected = TestWorld.SpawnCharacter();
+	if (Pipeline == nullptr || Resistant == nullptr || Armored == nullptr || Unprotected == nullptr)
+	{
+		AddError(TEXT("Failed to set up a damage pipeline and characters"));
+		return false;
+	}
+
+	FReportLog Log;
+	Pipeline->OnReportsResolved.AddRaw(&Log, &FReportLog::OnReportsResolved);
+
+	// Half the default damage type gets through
+	FDamageResistance Resistance;
+	Resistance.DamageType = UDamageType::StaticClass();
+	Resistance.Resistance = 0.5f;
+	Resistant->Resistances.Add(Resistance);
+	Resistant->Armor = 0.0f;
+
+	// Armor at the half point halves everything
+	Armored->Armor = Pipeline->ArmorHalfPoint;
+
+	Unprotected->Armor = 0.0f;
+
+	// A shotgun blast on the resistant character, an untyped hit and a shot on the armored one
+	ShootAt(Resistant, 10.0f);
+	ShootAt(Resistant, 10.0f);
+	ShootAt(Resistant, 10.0f);
+	Pipeline->QueueDamage(Armored, 20.0f, nullptr, nullptr, nullptr);
+	ShootAt(Armored, 20.0f);
+
+	TestEqual(TEXT("Health before resolving"), Resistant->Health, 100.0f);
+	TestEqual(TEXT("Armored health before resolving"), Armored->Health, 100.0f);
+
+	Pipeline->ResolvePending();
+	TestEqual(TEXT("Broadcasts after the first frame"), Log.Broadcasts, 1);
+	TestEqual(TEXT("Reports after the first frame"), Log.Reports.Num(), 2);
+
+	TestEqual(TEXT("Resistant health"), Resistant->Health, 85.0f);
+	const FDamageHitReport *ResistantReport = Log.FindReport(Resistant);
+	if (ResistantReport != nullptr)
+	{
+		TestEqual(TEXT("Resistant report hits"), ResistantReport->Hits, 3);
+		TestEqual(TEXT("Resistant report damage"), ResistantReport->Damage, 15.0f);
+		TestFalse(TEXT("Resistant survived"), ResistantReport->bKilled);
+	}
+	else
+	{
+		AddError(TEXT("No report for the resistant character"));
+	}
+
+	TestEqual(TEXT("Armored health"), Armored->Health, 80.0f);
+	const FDamageHitReport *ArmoredReport = Log.FindReport(Armored);
+	if (ArmoredReport != nullptr)
+	{
+		TestEqual(TEXT("Armored report hits"), ArmoredReport->Hits, 2);
+		TestEqual(TEXT("Armored report damage"), ArmoredReport->Damage, 20.0f);
+	}
+	else
+	{
+		AddError(TEXT("No report for the armored character"));
+	}
+
+	// Nothing queued, nothing changes on the next resolve
+	Pipeline->ResolvePending();
+	TestEqual(TEXT("Reports of an empty frame"), Log.Reports.Num(), 0);
+	TestEqual(TEXT("Resistant health after an empty frame"), Resistant->Health, 85.0f);
+
+	// Two hits that only kill together; death is checked once and reported
+	ShootAt(Unprotected, 60.0f);
+	ShootAt(Unprotected, 60.0f);
+	Pipeline->ResolvePending();
+	TestTrue(TEXT("Killed by the combined hits"), Unprotected->IsDead());
+	const FDamageHitReport *KillReport = Log.FindReport(Unprotected);
+	if (KillReport != nullptr)
+	{
+		TestEqual(TEXT("Kill report hits"), KillReport->Hits, 2);
+		TestTrue(TEXT("Kill reported"), KillReport->bKilled);
+	}
+	else
+	{
+		AddError(TEXT("No report for the killed character"));
+	}
+
+	// The dead take no more damage
+	const float HealthAtDeath = Unprotected->Health;
+	ShootAt(Unprotected, 10.0f);
+	Pipeline->ResolvePending();
+	TestEqual(TEXT("Health after death"), Unprotected->Health, HealthAtDeath);
+	TestEqual(TEXT("Reports for the dead"), Log.Reports.Num(), 0);
+
+	Pipeline->OnReportsResolved.RemoveAll(&Log);
+	return true;
+}
+
+#endif
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "AutomationTest.h"
+#include "SurvivalTestWorld.h"
+#include "Inventory/InventoryComponent.h"
+#include "Inventory/BaseWeaponActor.h"
+#include "Inventory/ItemAssetStreamer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HotBarSwapTest
+{
+	const FName Rifle(TEXT("Test.Rifle"));
+	const FName Pistol(TEXT("Test.Pistol"));
+
+	const int32 NumSwaps = 100;
+
+	// Generous, so a loaded test machine does not fail it; a swap that spawns or loads takes far longer
+	const float MaxSwapMicroseconds = 1000.0f;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHotBarSwapTest, "Survival.Inventory.HotBarSwap", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Swaps back and forth between two hot-bar weapons and checks each swap is quick
+// and neither creates objects nor loads assets
+bool FHotBarSwapTest::RunTest(const FString &Parameters)
+{
+	using namespace HotBarSwapTest;
+
+	const FScopedItemDefaults WeaponDefaults(UBaseWeaponItem::StaticClass(), 1, 0.0f);
+
+	FSurvivalTestWorld TestWorld;
+	ASurvivalCharacter *Character = TestWorld.SpawnCharacter();
+	if (Character == nullptr || Character->InventoryComponent == nullptr)
+	{
+		AddError(TEXT("Failed to spawn a character with an inventory"));
+		return false;
+	}
+	UInventoryComponent *Inventory = Character->InventoryComponent;
+
+	TestTrue(TEXT("Add rifle"), Inventory->AddItemToSlot(0, Rifle, 1, EItemType::IT_Weapon, UBaseWeaponItem::StaticClass()));
+	TestTrue(TEXT("Add pistol"), Inventory->AddItemToSlot(1, Pistol, 1, EItemType::IT_Weapon, UBaseWeaponItem::StaticClass()));
+	TestTrue(TEXT("Assign rifle"), Inventory->AssignHotBarSlot(0, 0));
+	TestTrue(TEXT("Assign pistol"), Inventory->AssignHotBarSlot(1, 1));
+	if (Inventory->HotBar.Num() < 2 || Inventory->HotBar[0].WeaponActor == nullptr || Inventory->HotBar[1].WeaponActor == nullptr)
+	{
+		AddError(TEXT("Hot-bar weapon actors were not spawned"));
+		return false;
+	}
+
+	// The first draw may still start loads; measure from a settled state
+	TestTrue(TEXT("First draw"), Inventory->SelectHotBarSlot(0));
+	FlushAsyncLoading();
+
+	UItemAssetStreamer *Streamer = UItemAssetStreamer::Get(Character);
+	const int32 LoadedAssets = Streamer ? Streamer->GetStreamerStats().LoadedAssets : 0;
+	const int32 NumObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	const int32 NumActors = TestWorld.World->GetActorCount();
+
+	float SlowestSwap = 0.0f;
+	for (int32 Swap = 1; Swap <= NumSwaps; Swap++)
+	{
+		const int32 HotBarSlot = Swap % 2;
+		if (!Inventory->SelectHotBarSlot(HotBarSlot))
+		{
+			AddError(FString::Printf(TEXT("Swap %d to hot-bar slot %d failed"), Swap, HotBarSlot));
+			return false;
+		}
+
+		// Nothing may be left loading behind the swap
+		TestEqual(TEXT("Async loads after swap"), GetNumAsyncPackages(), 0);
+		SlowestSwap = FMath::Max(SlowestSwap, Inventory->LastSwapMicroseconds);
+	}
+
+	TestTrue(FString::Printf(TEXT("Slowest swap took %.1f us, budget %.1f us"), SlowestSwap, MaxSwapMicroseconds), SlowestSwap <= MaxSwapMicroseconds);
+	TestEqual(TEXT("UObjects created by swaps"), GUObjectArray.GetObjectArrayNumMinusAvailable(), NumObjects);
+	TestEqual(TEXT("Actors spawned by swaps"), TestWorld.World->GetActorCount(), NumActors);
+	TestEqual(TEXT("Assets loaded by swaps"), Streamer ? Streamer->GetStreamerStats().LoadedAssets : 0, LoadedAssets);
+
+	// NumSwaps is even, so the rifle is drawn again and the pistol holstered
+	TestTrue(TEXT("Rifle equipped"), Inventory->EquippedWeapon == Inventory->HotBar[0].Weapon);
+	TestFalse(TEXT("Rifle actor drawn"), Inventory->HotBar[0].WeaponActor->bHidden);
+	TestTrue(TEXT("Pistol actor holstered"), Inventory->HotBar[1].WeaponActor->bHidden);
+
+	return true;
+}
+
+#endif
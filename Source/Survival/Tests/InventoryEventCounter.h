@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "UObject/NoExportTypes.h"
+#include "InventoryEventCounter.generated.h"
+
+/**
+* Counts inventory component events for automation tests. The events are dynamic
+* delegates, which only bind to UFUNCTIONs.
+*/
+UCLASS(Transient)
+class UInventoryEventCounter : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	int32 NumRearranged;
+
+	UInventoryEventCounter()
+	{
+		NumRearranged = 0;
+	}
+
+	UFUNCTION()
+	void OnInventoryRearranged()
+	{
+		NumRearranged++;
+	}
+};
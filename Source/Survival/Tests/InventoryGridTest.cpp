@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "AutomationTest.h"
+#include "SurvivalTestWorld.h"
+#include "Inventory/InventoryComponent.h"
+#include "Inventory/Items/BaseAmmoItem.h"
+#include "Inventory/Items/BaseHealingItem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace InventoryGridTest
+{
+	const FName Rifle(TEXT("Test.Rifle"));
+	const FName Crate(TEXT("Test.AmmoCrate"));
+	const FName Bandage(TEXT("Test.Bandage"));
+
+	// Checks that every item lies inside the grid, no two items share a cell,
+	// and the grid has exactly the cells of the items taken
+	void CheckLayout(FAutomationTestBase &Test, UInventoryComponent *Inventory, const TCHAR *Step)
+	{
+		Test.TestTrue(FString::Printf(TEXT("Totals after %s"), Step), Inventory->VerifyTotals());
+
+		TArray<bool> Taken;
+		Taken.Init(false, Inventory->Slots);
+		for (const FItemSlotInfo &SlotInfo : Inventory->Items)
+		{
+			const FIntPoint Footprint = Inventory->GetFootprint(SlotInfo);
+			const int32 X = SlotInfo.SlotIndex % Inventory->Columns;
+			const int32 Y = SlotInfo.SlotIndex / Inventory->Columns;
+			if (SlotInfo.SlotIndex < 0 || X + Footprint.X > Inventory->Columns || Y + Footprint.Y > Inventory->Rows)
+			{
+				Test.AddError(FString::Printf(TEXT("After %s, '%s' in slot %d is outside the grid"), Step, *SlotInfo.ItemID.ToString(), SlotInfo.SlotIndex));
+				continue;
+			}
+
+			for (int32 Row = Y; Row < Y + Footprint.Y; Row++)
+			{
+				for (int32 Column = X; Column < X + Footprint.X; Column++)
+				{
+					const int32 Cell = Row * Inventory->Columns + Column;
+					if (Taken[Cell])
+					{
+						Test.AddError(FString::Printf(TEXT("After %s, '%s' in slot %d overlaps another item in slot %d"), Step, *SlotInfo.ItemID.ToString(), SlotInfo.SlotIndex, Cell));
+					}
+					Taken[Cell] = true;
+				}
+			}
+		}
+
+		for (int32 Cell = 0; Cell < Inventory->Slots; Cell++)
+		{
+			if (Inventory->IsSlotOpen(Cell) == Taken[Cell])
+			{
+				Test.AddError(FString::Printf(TEXT("After %s, the grid has cell %d %s"), Step, Cell, Taken[Cell] ? TEXT("open under an item") : TEXT("taken without an item")));
+			}
+		}
+	}
+
+	// Cell (X, Y) of a Columns wide grid
+	FORCEINLINE int32 ToSlot(int32 X, int32 Y, int32 Columns)
+	{
+		return Y * Columns + X;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryGridTest, "Survival.Inventory.Grid", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Places multi-cell items, turned and unturned, fills a grid, and resizes a grid
+// with items in it, checking the layout after each step
+bool FInventoryGridTest::RunTest(const FString &Parameters)
+{
+	using namespace InventoryGridTest;
+
+	const FScopedItemDefaults WeaponDefaults(UBaseWeaponItem::StaticClass(), 1, 3.5f);
+	const FScopedItemDefaults AmmoDefaults(UBaseAmmoItem::StaticClass(), 1, 5.0f);
+	const FScopedItemDefaults HealingDefaults(UBaseHealingItem::StaticClass(), 1, 0.25f);
+	const FScopedItemFootprint WeaponFootprint(UBaseWeaponItem::StaticClass(), 3, 1);
+	const FScopedItemFootprint AmmoFootprint(UBaseAmmoItem::StaticClass(), 2, 2);
+
+	FSurvivalTestWorld TestWorld;
+	ASurvivalCharacter *Fitting = TestWorld.SpawnCharacter();
+	ASurvivalCharacter *Filling = TestWorld.SpawnCharacter();
+	ASurvivalCharacter *Resizing = TestWorld.SpawnCharacter();
+	if (Fitting == nullptr || Filling == nullptr || Resizing == nullptr
+		|| Fitting->InventoryComponent == nullptr || Filling->InventoryComponent == nullptr || Resizing->InventoryComponent == nullptr)
+	{
+		AddError(TEXT("Failed to spawn characters with an inventory"));
+		return false;
+	}
+
+	// Fit: a row of rifles each, then one only fits turned into the last column
+	{
+		UInventoryComponent *Inventory = Fitting->InventoryComponent;
+		TestTrue(TEXT("Make a 4 x 4 grid"), Inventory->ResizeInventory(4, 4));
+
+		int32 Slot = INDEX_NONE;
+		bool bRotated = true;
+		TestTrue(TEXT("Fit in an empty grid"), Inventory->FindFit(FIntPoint(3, 1), false, Slot, bRotated));
+		TestEqual(TEXT("Fit slot in an empty grid"), Slot, 0);
+		TestFalse(TEXT("Fit in an empty grid is not turned"), bRotated);
+
+		for (int32 Row = 0; Row < 4; Row++)
+		{
+			TestTrue(TEXT("Add a rifle"), Inventory->AddItem(Rifle, 1, EItemType::IT_Weapon, UBaseWeaponItem::StaticClass()));
+			TestEqual(TEXT("Rifle slot"), Inventory->Items.Last().SlotIndex, ToSlot(0, Row, 4));
+			TestFalse(TEXT("Rifle is not turned"), Inventory->Items.Last().bRotated);
+		}
+		CheckLayout(*this, Inventory, TEXT("adding a row of rifles"));
+
+		TestFalse(TEXT("No unturned fit"), Inventory->FindFit(FIntPoint(3, 1), false, Slot, bRotated));
+		TestTrue(TEXT("Turned fit"), Inventory->FindFit(FIntPoint(3, 1), true, Slot, bRotated));
+		TestEqual(TEXT("Turned fit slot"), Slot, ToSlot(3, 0, 4));
+		TestTrue(TEXT("Turned fit is turned"), bRotated);
+
+		TestTrue(TEXT("Add a turned rifle"), Inventory->AddItem(Rifle, 1, EItemType::IT_Weapon, UBaseWeaponItem::StaticClass()));
+		const FItemSlotInfo &Turned = Inventory->Items.Last();
+		TestEqual(TEXT("Turned rifle slot"), Turned.SlotIndex, ToSlot(3, 0, 4));
+		TestTrue(TEXT("Turned rifle is turned"), Turned.bRotated);
+		TestTrue(TEXT("Turned rifle footprint"), Inventory->GetFootprint(Turned) == FIntPoint(1, 3));
+		CheckLayout(*this, Inventory, TEXT("adding a turned rifle"));
+
+		// Turning it back would stick out of the grid
+		TestFalse(TEXT("Turn back"), Inventory->RotateItem(ToSlot(3, 0, 4)));
+		CheckLayout(*this, Inventory, TEXT("a failed turn"));
+		TestTrue(TEXT("One cell left"), Inventory->CanPlaceAt(ToSlot(3, 3, 4), FIntPoint(1, 1)));
+	}
+
+	// Auto-fit: crates go into the first free place until the grid is full
+	{
+		UInventoryComponent *Inventory = Filling->InventoryComponent;
+		TestTrue(TEXT("Make a 4 x 4 grid to fill"), Inventory->ResizeInventory(4, 4));
+
+		int32 Added = 0;
+		while (Added < Inventory->Slots && Inventory->AddItem(Crate, 1, EItemType::IT_Item, UBaseAmmoItem::StaticClass()))
+		{
+			Added++;
+		}
+		TestEqual(TEXT("Crates that fit"), Added, 4);
+		TestTrue(TEXT("Grid is full"), Inventory->IsFull());
+		CheckLayout(*this, Inventory, TEXT("filling the grid"));
+
+		const int32 ExpectedSlots[] = { ToSlot(0, 0, 4), ToSlot(2, 0, 4), ToSlot(0, 2, 4), ToSlot(2, 2, 4) };
+		for (int32 i = 0; i < Inventory->Items.Num() && i < (int32)ARRAY_COUNT(ExpectedSlots); i++)
+		{
+			TestEqual(TEXT("Crate slot"), Inventory->Items[i].SlotIndex, ExpectedSlots[i]);
+		}
+
+		TestFalse(TEXT("Add to a full grid"), Inventory->AddItem(Bandage, 1, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+
+		// The freed place is found again
+		TestTrue(TEXT("Drop a crate"), Inventory->DropItem(ToSlot(2, 2, 4), INDEX_NONE));
+		int32 Slot = INDEX_NONE;
+		bool bRotated = false;
+		TestTrue(TEXT("Fit after a drop"), Inventory->FindFit(FIntPoint(2, 2), false, Slot, bRotated));
+		TestEqual(TEXT("Fit slot after a drop"), Slot, ToSlot(2, 2, 4));
+		CheckLayout(*this, Inventory, TEXT("dropping a crate"));
+	}
+
+	// Resize: items keep their cell where they can, the rest are packed in, none are lost
+	{
+		UInventoryComponent *Inventory = Resizing->InventoryComponent;
+		const int32 NumItems = 5;
+		for (int32 i = 0; i < NumItems; i++)
+		{
+			const FName ItemID(*FString::Printf(TEXT("Test.Bandage%d"), i));
+			TestTrue(TEXT("Add a bandage"), Inventory->AddItem(ItemID, 1, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+		}
+		if (Inventory->Items.Num() != NumItems)
+		{
+			AddError(TEXT("Failed to add the bandages to resize with"));
+			return false;
+		}
+
+		// 4 x 2 to 4 x 4: every item stays in its cell
+		TestTrue(TEXT("Grow"), Inventory->ResizeInventory(4, 4));
+		CheckLayout(*this, Inventory, TEXT("growing"));
+		for (int32 i = 0; i < NumItems; i++)
+		{
+			TestEqual(TEXT("Slot after growing"), Inventory->Items[i].SlotIndex, ToSlot(i % 2, i / 2, 4));
+		}
+
+		// 4 x 4 to 2 x 4: the item on the third row is packed into the first free cell
+		TestTrue(TEXT("Shrink"), Inventory->ResizeInventory(2, 4));
+		CheckLayout(*this, Inventory, TEXT("shrinking"));
+		const int32 ShrunkSlots[] = { ToSlot(0, 0, 4), ToSlot(1, 0, 4), ToSlot(0, 1, 4), ToSlot(1, 1, 4), ToSlot(2, 0, 4) };
+		for (int32 i = 0; i < NumItems; i++)
+		{
+			TestEqual(TEXT("Slot after shrinking"), Inventory->Items[i].SlotIndex, ShrunkSlots[i]);
+		}
+
+		// Too small for the items: nothing changes
+		TestFalse(TEXT("Shrink below the items"), Inventory->ResizeInventory(1, 4));
+		TestEqual(TEXT("Slots after a failed shrink"), Inventory->Slots, 8);
+		CheckLayout(*this, Inventory, TEXT("a failed shrink"));
+
+		// Exactly as many cells as items: the two on the second row move to the end of the first
+		TestTrue(TEXT("Shrink to one row"), Inventory->ResizeInventory(1, 5));
+		CheckLayout(*this, Inventory, TEXT("shrinking to one row"));
+		TestEqual(TEXT("Items after shrinking to one row"), Inventory->Items.Num(), NumItems);
+		TestTrue(TEXT("One row is full"), Inventory->IsFull());
+
+		TestTrue(TEXT("Grow back"), Inventory->ResizeInventory(4, 2));
+		CheckLayout(*this, Inventory, TEXT("growing back"));
+		TestEqual(TEXT("Items after growing back"), Inventory->Items.Num(), NumItems);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "AutomationTest.h"
+#include "SurvivalTestWorld.h"
+#include "InventoryEventCounter.h"
+#include "Inventory/InventoryComponent.h"
+#include "Inventory/Items/BaseHealingItem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace InventoryRearrangeTest
+{
+	const FName Apple(TEXT("Test.Apple"));
+	const FName Bandage(TEXT("Test.Bandage"));
+	const FName Canteen(TEXT("Test.Canteen"));
+
+	// Add a stack of ItemID to Slot and give it a name and value to sort by
+	bool AddNamedItem(UInventoryComponent *Inventory, int32 Slot, FName ItemID, int32 StackSize, const TCHAR *Name, int32 Value)
+	{
+		if (!Inventory->AddItemToSlot(Slot, ItemID, StackSize, EItemType::IT_Item, UBaseHealingItem::StaticClass()))
+		{
+			return false;
+		}
+		FItemSlotInfo *SlotInfo = Inventory->GetItemInSlot(Slot);
+		if (SlotInfo == nullptr || SlotInfo->ItemTypeReference == nullptr)
+		{
+			return false;
+		}
+		SlotInfo->ItemTypeReference->Name = FText::FromString(Name);
+		SlotInfo->ItemTypeReference->Value = Value;
+		return true;
+	}
+
+	struct FExpectedStack
+	{
+		int32 Slot;
+		FName ItemID;
+		int32 StackSize;
+	};
+
+	// Checks the inventory holds exactly the expected stacks, each in its slot
+	void CheckLayout(FAutomationTestBase &Test, UInventoryComponent *Inventory, const TCHAR *Step, const TArray<FExpectedStack> &Expected)
+	{
+		Test.TestTrue(FString::Printf(TEXT("Totals after %s"), Step), Inventory->VerifyTotals());
+		Test.TestEqual(FString::Printf(TEXT("Stacks after %s"), Step), Inventory->Items.Num(), Expected.Num());
+		for (const FExpectedStack &Stack : Expected)
+		{
+			const FItemSlotInfo *SlotInfo = Inventory->GetItemInSlot(Stack.Slot);
+			if (SlotInfo == nullptr || SlotInfo->ItemID != Stack.ItemID || SlotInfo->StackSize != Stack.StackSize)
+			{
+				Test.AddError(FString::Printf(TEXT("After %s, slot %d has %d of '%s', expected %d of '%s'"), Step, Stack.Slot,
+					SlotInfo ? SlotInfo->StackSize : 0, SlotInfo ? *SlotInfo->ItemID.ToString() : TEXT("nothing"),
+					Stack.StackSize, *Stack.ItemID.ToString()));
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryRearrangeTest, "Survival.Inventory.Rearrange", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Sorts a scattered inventory by each key and consolidates partial stacks, checking the
+// final layout and that each change is announced with exactly one rearranged event
+bool FInventoryRearrangeTest::RunTest(const FString &Parameters)
+{
+	using namespace InventoryRearrangeTest;
+
+	const FScopedItemDefaults HealingDefaults(UBaseHealingItem::StaticClass(), 10, 0.25f);
+
+	FSurvivalTestWorld TestWorld;
+	ASurvivalCharacter *Sorting = TestWorld.SpawnCharacter();
+	ASurvivalCharacter *Consolidating = TestWorld.SpawnCharacter();
+	if (Sorting == nullptr || Consolidating == nullptr || Sorting->InventoryComponent == nullptr || Consolidating->InventoryComponent == nullptr)
+	{
+		AddError(TEXT("Failed to spawn characters with an inventory"));
+		return false;
+	}
+
+	// Sort: two apple stacks, a bandage and a canteen spread over the slots
+	{
+		UInventoryComponent *Inventory = Sorting->InventoryComponent;
+		UInventoryEventCounter *Counter = NewObject<UInventoryEventCounter>();
+		Inventory->OnInventoryRearrangedDelegate.AddDynamic(Counter, &UInventoryEventCounter::OnInventoryRearranged);
+
+		TestTrue(TEXT("Add a canteen"), AddNamedItem(Inventory, 7, Canteen, 1, TEXT("Canteen"), 5));
+		TestTrue(TEXT("Add apples"), AddNamedItem(Inventory, 2, Apple, 4, TEXT("Apple"), 1));
+		TestTrue(TEXT("Add a bandage"), AddNamedItem(Inventory, 5, Bandage, 2, TEXT("Bandage"), 20));
+		TestTrue(TEXT("Add a second apple stack"), AddNamedItem(Inventory, 0, Apple, 8, TEXT("Apple"), 1));
+
+		// Equal names go fuller stack first
+		TestTrue(TEXT("Sort by name"), Inventory->SortInventory(EInventorySortKey::ISK_Name));
+		CheckLayout(*this, Inventory, TEXT("sorting by name"), { { 0, Apple, 8 }, { 1, Apple, 4 }, { 2, Bandage, 2 }, { 3, Canteen, 1 } });
+		TestEqual(TEXT("Events after sorting by name"), Counter->NumRearranged, 1);
+
+		TestTrue(TEXT("Sort by value"), Inventory->SortInventory(EInventorySortKey::ISK_Value));
+		CheckLayout(*this, Inventory, TEXT("sorting by value"), { { 0, Bandage, 2 }, { 1, Canteen, 1 }, { 2, Apple, 8 }, { 3, Apple, 4 } });
+		TestEqual(TEXT("Events after sorting by value"), Counter->NumRearranged, 2);
+
+		TestTrue(TEXT("Sort by item ID"), Inventory->SortInventory(EInventorySortKey::ISK_ItemID));
+		CheckLayout(*this, Inventory, TEXT("sorting by item ID"), { { 0, Apple, 8 }, { 1, Apple, 4 }, { 2, Bandage, 2 }, { 3, Canteen, 1 } });
+		TestEqual(TEXT("Events after sorting by item ID"), Counter->NumRearranged, 3);
+
+		// Sorting packs to the front; the rest of the grid is open
+		for (int32 Slot = 4; Slot < Inventory->Slots; Slot++)
+		{
+			TestTrue(TEXT("Slot past the sorted items is open"), Inventory->IsSlotOpen(Slot));
+		}
+	}
+
+	// Consolidate: partial stacks fill up the first stacks to MaxStackSize. Stacks stay in their slots.
+	{
+		UInventoryComponent *Inventory = Consolidating->InventoryComponent;
+		UInventoryEventCounter *Counter = NewObject<UInventoryEventCounter>();
+		Inventory->OnInventoryRearrangedDelegate.AddDynamic(Counter, &UInventoryEventCounter::OnInventoryRearranged);
+
+		// Full stacks don't take more, so these are three and two separate stacks
+		for (int32 i = 0; i < 3; i++)
+		{
+			TestTrue(TEXT("Add a bandage stack"), Inventory->AddItem(Bandage, 10, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+		}
+		for (int32 i = 0; i < 2; i++)
+		{
+			TestTrue(TEXT("Add an apple stack"), Inventory->AddItem(Apple, 10, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+		}
+
+		// Leave 6, 5 and 3 bandages, 5 and 2 apples
+		TestTrue(TEXT("Split bandages"), Inventory->DropItem(0, 4));
+		TestTrue(TEXT("Split bandages again"), Inventory->DropItem(1, 5));
+		TestTrue(TEXT("Split bandages a third time"), Inventory->DropItem(2, 7));
+		TestTrue(TEXT("Split apples"), Inventory->DropItem(3, 5));
+		TestTrue(TEXT("Split apples again"), Inventory->DropItem(4, 8));
+		TestEqual(TEXT("Events before consolidating"), Counter->NumRearranged, 0);
+
+		TestEqual(TEXT("Emptied stacks"), Inventory->ConsolidateStacks(), 2);
+		CheckLayout(*this, Inventory, TEXT("consolidating"), { { 0, Bandage, 10 }, { 1, Bandage, 4 }, { 3, Apple, 7 } });
+		TestEqual(TEXT("Bandages after consolidating"), Inventory->GetItemCount(Bandage), 14);
+		TestEqual(TEXT("Apples after consolidating"), Inventory->GetItemCount(Apple), 7);
+		TestEqual(TEXT("Events after consolidating"), Counter->NumRearranged, 1);
+
+		for (const FItemSlotInfo &SlotInfo : Inventory->Items)
+		{
+			TestTrue(TEXT("Stack within MaxStackSize"), SlotInfo.StackSize <= SlotInfo.MaxStackSize);
+		}
+
+		// Nothing left to merge: no change, no event
+		TestEqual(TEXT("Emptied stacks the second time"), Inventory->ConsolidateStacks(), 0);
+		TestEqual(TEXT("Events after consolidating again"), Counter->NumRearranged, 1);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "AutomationTest.h"
+#include "SurvivalTestWorld.h"
+#include "Inventory/InventoryComponent.h"
+#include "Inventory/Items/BaseHealingItem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace InventorySearchTest
+{
+	// Add an item with a display name to Slot
+	bool AddNamedItem(UInventoryComponent *Inventory, int32 Slot, const TCHAR *ItemID, const TCHAR *Name)
+	{
+		if (!Inventory->AddItemToSlot(Slot, FName(ItemID), 1, EItemType::IT_Item, UBaseHealingItem::StaticClass()))
+		{
+			return false;
+		}
+		FItemSlotInfo *SlotInfo = Inventory->GetItemInSlot(Slot);
+		if (SlotInfo == nullptr || SlotInfo->ItemTypeReference == nullptr)
+		{
+			return false;
+		}
+		SlotInfo->ItemTypeReference->Name = FText::FromString(Name);
+		return true;
+	}
+
+	FString SlotsToString(const TArray<int32> &Slots)
+	{
+		FString String;
+		for (int32 Slot : Slots)
+		{
+			String += String.IsEmpty() ? FString::FromInt(Slot) : FString::Printf(TEXT(", %d"), Slot);
+		}
+		return FString::Printf(TEXT("[%s]"), *String);
+	}
+
+	// Searches for Query and checks the slots found, in ascending order
+	void CheckSearch(FAutomationTestBase &Test, UInventoryComponent *Inventory, const TCHAR *Query, const TArray<int32> &Expected)
+	{
+		TArray<int32> Found;
+		const int32 NumFound = Inventory->SearchItems(Query, Found);
+		if (Found != Expected || NumFound != Found.Num())
+		{
+			Test.AddError(FString::Printf(TEXT("Search for '%s' found %d slots %s, expected %s"), Query, NumFound, *SlotsToString(Found), *SlotsToString(Expected)));
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventorySearchTest, "Survival.Inventory.Search", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Searches by word prefixes, then keeps searching as items are removed, swapped and
+// sorted, which update the index in place instead of rebuilding it
+bool FInventorySearchTest::RunTest(const FString &Parameters)
+{
+	using namespace InventorySearchTest;
+
+	const FScopedItemDefaults HealingDefaults(UBaseHealingItem::StaticClass(), 1, 0.25f);
+
+	FSurvivalTestWorld TestWorld;
+	ASurvivalCharacter *Character = TestWorld.SpawnCharacter();
+	if (Character == nullptr || Character->InventoryComponent == nullptr)
+	{
+		AddError(TEXT("Failed to spawn a character with an inventory"));
+		return false;
+	}
+	UInventoryComponent *Inventory = Character->InventoryComponent;
+
+	// Names are set before the first search builds the index
+	TestTrue(TEXT("Add a red apple"), AddNamedItem(Inventory, 0, TEXT("Test.RedApple"), TEXT("Red Apple")));
+	TestTrue(TEXT("Add a green apple"), AddNamedItem(Inventory, 1, TEXT("Test.GreenApple"), TEXT("Green Apple")));
+	TestTrue(TEXT("Add apricot jam"), AddNamedItem(Inventory, 2, TEXT("Test.ApricotJam"), TEXT("Apricot Jam")));
+	TestTrue(TEXT("Add a bandage"), AddNamedItem(Inventory, 3, TEXT("Test.Bandage"), TEXT("Bandage")));
+	TestTrue(TEXT("Add canned beans"), AddNamedItem(Inventory, 4, TEXT("Test.CannedBeans"), TEXT("Canned Beans")));
+
+	// Any word may match, each query word narrows it down, case does not matter
+	CheckSearch(*this, Inventory, TEXT("ap"), { 0, 1, 2 });
+	CheckSearch(*this, Inventory, TEXT("red ap"), { 0 });
+	CheckSearch(*this, Inventory, TEXT("ap red"), { 0 });
+	CheckSearch(*this, Inventory, TEXT("APPLE"), { 0, 1 });
+	CheckSearch(*this, Inventory, TEXT("ba"), { 3 });
+	CheckSearch(*this, Inventory, TEXT("be"), { 4 });
+	CheckSearch(*this, Inventory, TEXT("an"), {});
+	CheckSearch(*this, Inventory, TEXT("zz"), {});
+	CheckSearch(*this, Inventory, TEXT(""), { 0, 1, 2, 3, 4 });
+
+	// Removing an item takes its words out
+	TestTrue(TEXT("Drop the green apple"), Inventory->DropItem(1, INDEX_NONE));
+	CheckSearch(*this, Inventory, TEXT("ap"), { 0, 2 });
+	CheckSearch(*this, Inventory, TEXT("green"), {});
+	CheckSearch(*this, Inventory, TEXT(""), { 0, 2, 3, 4 });
+
+	// Swapping moves the words with the items, into open slots and between items
+	TestTrue(TEXT("Swap the red apple into an open slot"), Inventory->SwapSlot(0, 6));
+	CheckSearch(*this, Inventory, TEXT("red"), { 6 });
+	CheckSearch(*this, Inventory, TEXT("ap"), { 2, 6 });
+
+	TestTrue(TEXT("Swap the jam and the bandage"), Inventory->SwapSlot(2, 3));
+	CheckSearch(*this, Inventory, TEXT("jam"), { 3 });
+	CheckSearch(*this, Inventory, TEXT("band"), { 2 });
+	CheckSearch(*this, Inventory, TEXT("ap"), { 3, 6 });
+
+	// Sorting rebuilds the slot storage; the index follows
+	TestTrue(TEXT("Sort by name"), Inventory->SortInventory(EInventorySortKey::ISK_Name));
+	CheckSearch(*this, Inventory, TEXT("ap"), { 0, 3 });
+	CheckSearch(*this, Inventory, TEXT("canned b"), { 2 });
+
+	return true;
+}
+
+#endif
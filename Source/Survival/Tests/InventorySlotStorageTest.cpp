@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "AutomationTest.h"
+#include "SurvivalTestWorld.h"
+#include "Inventory/InventoryComponent.h"
+#include "Inventory/Items/BaseAmmoItem.h"
+#include "Inventory/Items/BaseHealingItem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace InventorySlotStorageTest
+{
+	const FName Bandage(TEXT("Test.Bandage"));
+	const FName Ammo(TEXT("Test.RifleAmmo"));
+	const FName Rifle(TEXT("Test.Rifle"));
+
+	// Slot of the first stack of ItemID, INDEX_NONE if there is none
+	int32 FindSlot(const UInventoryComponent *Inventory, FName ItemID)
+	{
+		for (const FItemSlotInfo &SlotInfo : Inventory->Items)
+		{
+			if (SlotInfo.ItemID == ItemID)
+			{
+				return SlotInfo.SlotIndex;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	// Compares the packed slot arrays with the item records, from the records (VerifyTotals)
+	// and from the slots: every slot that points at a record must be that record's slot
+	void CheckSlotStorage(FAutomationTestBase &Test, UInventoryComponent *Inventory, const TCHAR *Step)
+	{
+		Test.TestTrue(FString::Printf(TEXT("Records match the slot storage after %s"), Step), Inventory->VerifyTotals());
+
+		int32 NumOccupied = 0;
+		for (int32 Slot = 0; Slot < Inventory->Slots; Slot++)
+		{
+			const int32 ItemIndex = Inventory->GetItemInfoIndexAtSlot(Slot);
+			if (ItemIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			NumOccupied++;
+			if (!Inventory->Items.IsValidIndex(ItemIndex) || Inventory->Items[ItemIndex].SlotIndex != Slot)
+			{
+				Test.AddError(FString::Printf(TEXT("After %s, slot %d points at item %d, which is not in that slot"), Step, Slot, ItemIndex));
+			}
+		}
+		Test.TestEqual(FString::Printf(TEXT("Occupied slots after %s"), Step), NumOccupied, Inventory->Items.Num());
+
+		// Nothing left behind past the last slot
+		Test.TestEqual(FString::Printf(TEXT("Slot past the end after %s"), Step), Inventory->GetItemInfoIndexAtSlot(Inventory->Slots), (int32)INDEX_NONE);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventorySlotStorageTest, "Survival.Inventory.SlotStorage", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Runs every operation that moves items between slots and checks the packed
+// per-slot arrays against the item records after each step
+bool FInventorySlotStorageTest::RunTest(const FString &Parameters)
+{
+	using namespace InventorySlotStorageTest;
+
+	const FScopedItemDefaults HealingDefaults(UBaseHealingItem::StaticClass(), 10, 0.25f);
+	const FScopedItemDefaults AmmoDefaults(UBaseAmmoItem::StaticClass(), 60, 0.012f);
+	const FScopedItemDefaults WeaponDefaults(UBaseWeaponItem::StaticClass(), 1, 3.5f);
+
+	FSurvivalTestWorld TestWorld;
+	ASurvivalCharacter *Character = TestWorld.SpawnCharacter();
+	if (Character == nullptr || Character->InventoryComponent == nullptr)
+	{
+		AddError(TEXT("Failed to spawn a character with an inventory"));
+		return false;
+	}
+	UInventoryComponent *Inventory = Character->InventoryComponent;
+	CheckSlotStorage(*this, Inventory, TEXT("spawning"));
+
+	// Add and stack
+	TestTrue(TEXT("Add bandages"), Inventory->AddItem(Bandage, 3, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	CheckSlotStorage(*this, Inventory, TEXT("adding"));
+
+	TestTrue(TEXT("Stack bandages"), Inventory->AddItem(Bandage, 4, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	CheckSlotStorage(*this, Inventory, TEXT("stacking"));
+	TestEqual(TEXT("Stacks after stacking"), Inventory->Items.Num(), 1);
+
+	TestTrue(TEXT("Add ammo"), Inventory->AddItem(Ammo, 30, EItemType::IT_Item, UBaseAmmoItem::StaticClass()));
+	TestTrue(TEXT("Add rifle"), Inventory->AddItem(Rifle, 1, EItemType::IT_Weapon, UBaseWeaponItem::StaticClass()));
+	TestTrue(TEXT("Overflow bandages"), Inventory->AddItem(Bandage, 9, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	CheckSlotStorage(*this, Inventory, TEXT("overflowing a stack"));
+	TestEqual(TEXT("Stacks after overflowing"), Inventory->Items.Num(), 4);
+
+	TestTrue(TEXT("Add bandages to a chosen slot"), Inventory->AddItemToSlot(6, Bandage, 8, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	CheckSlotStorage(*this, Inventory, TEXT("adding to a slot"));
+
+	// Remove part of a stack, then whole stacks; removing a record moves the last one into its place
+	TestTrue(TEXT("Drop some ammo"), Inventory->DropItem(FindSlot(Inventory, Ammo), 10));
+	CheckSlotStorage(*this, Inventory, TEXT("a partial drop"));
+
+	TestTrue(TEXT("Drop a bandage stack"), Inventory->DropItem(FindSlot(Inventory, Bandage), INDEX_NONE));
+	CheckSlotStorage(*this, Inventory, TEXT("dropping a stack"));
+
+	TestTrue(TEXT("Drop the rifle"), Inventory->DropItem(FindSlot(Inventory, Rifle), INDEX_NONE));
+	CheckSlotStorage(*this, Inventory, TEXT("dropping the rifle"));
+	TestEqual(TEXT("Stacks after dropping"), Inventory->Items.Num(), 3);
+
+	// Swap with an open slot, then two occupied slots
+	TestTrue(TEXT("Swap ammo into an open slot"), Inventory->SwapSlot(FindSlot(Inventory, Ammo), 7));
+	CheckSlotStorage(*this, Inventory, TEXT("a swap with an open slot"));
+	TestEqual(TEXT("Ammo slot after the swap"), FindSlot(Inventory, Ammo), 7);
+
+	TestTrue(TEXT("Swap ammo and bandages"), Inventory->SwapSlot(7, FindSlot(Inventory, Bandage)));
+	CheckSlotStorage(*this, Inventory, TEXT("a swap of two items"));
+
+	// Grow, shrink, and a shrink the items don't fit in
+	TestTrue(TEXT("Grow"), Inventory->ResizeInventory(5, 3));
+	CheckSlotStorage(*this, Inventory, TEXT("growing"));
+
+	TestTrue(TEXT("Shrink"), Inventory->ResizeInventory(2, 2));
+	CheckSlotStorage(*this, Inventory, TEXT("shrinking"));
+
+	TestFalse(TEXT("Shrink below the items"), Inventory->ResizeInventory(1, 2));
+	CheckSlotStorage(*this, Inventory, TEXT("a failed shrink"));
+	TestEqual(TEXT("Slots after a failed shrink"), Inventory->Slots, 4);
+
+	// Stacking still finds the stacks in their new slots
+	TestTrue(TEXT("Stack ammo after resizing"), Inventory->AddItem(Ammo, 5, EItemType::IT_Item, UBaseAmmoItem::StaticClass()));
+	CheckSlotStorage(*this, Inventory, TEXT("stacking after resizing"));
+	TestEqual(TEXT("Stacks after stacking"), Inventory->Items.Num(), 3);
+	TestEqual(TEXT("Ammo after stacking"), Inventory->GetItemCount(Ammo), 25);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "AutomationTest.h"
+#include "SurvivalTestWorld.h"
+#include "Inventory/InventoryComponent.h"
+#include "Inventory/InventorySystemManager.h"
+#include "Inventory/ItemCraftRecipe.h"
+#include "Inventory/Items/BaseAmmoItem.h"
+#include "Inventory/Items/BaseHealingItem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace InventoryTotalsTest
+{
+	const FName Bandage(TEXT("Test.Bandage"));
+	const FName Ammo(TEXT("Test.RifleAmmo"));
+	const FName Rifle(TEXT("Test.Rifle"));
+	const FName Splint(TEXT("Test.Splint"));
+
+	// Slot of the first stack of ItemID, INDEX_NONE if there is none
+	int32 FindSlot(const UInventoryComponent *Inventory, FName ItemID)
+	{
+		for (const FItemSlotInfo &SlotInfo : Inventory->Items)
+		{
+			if (SlotInfo.ItemID == ItemID)
+			{
+				return SlotInfo.SlotIndex;
+			}
+		}
+		return INDEX_NONE;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryTotalsTest, "Survival.Inventory.RunningTotals", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Runs every operation that changes what the inventory holds and compares the running
+// weight and item counts with a recompute from the item records after each step
+bool FInventoryTotalsTest::RunTest(const FString &Parameters)
+{
+	using namespace InventoryTotalsTest;
+
+	const FScopedItemDefaults HealingDefaults(UBaseHealingItem::StaticClass(), 10, 0.25f);
+	const FScopedItemDefaults AmmoDefaults(UBaseAmmoItem::StaticClass(), 60, 0.012f);
+	const FScopedItemDefaults WeaponDefaults(UBaseWeaponItem::StaticClass(), 1, 3.5f);
+
+	FSurvivalTestWorld TestWorld;
+	ASurvivalCharacter *Character = TestWorld.SpawnCharacter();
+	if (Character == nullptr || Character->InventoryComponent == nullptr)
+	{
+		AddError(TEXT("Failed to spawn a character with an inventory"));
+		return false;
+	}
+	UInventoryComponent *Inventory = Character->InventoryComponent;
+
+	// Add
+	TestTrue(TEXT("Add bandages"), Inventory->AddItem(Bandage, 3, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	TestTrue(TEXT("Totals after add"), Inventory->VerifyTotals());
+	TestEqual(TEXT("Bandages after add"), Inventory->GetItemCount(Bandage), 3);
+	TestEqual(TEXT("Weight after add"), Inventory->TotalWeight, 0.75f);
+
+	// Stack onto the existing stack, then overflow into a new one
+	TestTrue(TEXT("Stack bandages"), Inventory->AddItem(Bandage, 4, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	TestTrue(TEXT("Totals after stacking"), Inventory->VerifyTotals());
+	TestEqual(TEXT("Stacks after stacking"), Inventory->Items.Num(), 1);
+
+	TestTrue(TEXT("Overflow bandages"), Inventory->AddItem(Bandage, 5, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	TestTrue(TEXT("Totals after overflow"), Inventory->VerifyTotals());
+	TestEqual(TEXT("Stacks after overflow"), Inventory->Items.Num(), 2);
+	TestEqual(TEXT("Bandages after overflow"), Inventory->GetItemCount(Bandage), 12);
+
+	// Use
+	TestTrue(TEXT("Use a bandage"), Inventory->UseItem(FindSlot(Inventory, Bandage), Character));
+	TestTrue(TEXT("Totals after use"), Inventory->VerifyTotals());
+	TestEqual(TEXT("Bandages after use"), Inventory->GetItemCount(Bandage), 11);
+
+	// Drop part of a stack, then a whole stack
+	TestTrue(TEXT("Drop two bandages"), Inventory->DropItem(FindSlot(Inventory, Bandage), 2));
+	TestTrue(TEXT("Totals after partial drop"), Inventory->VerifyTotals());
+	TestEqual(TEXT("Bandages after partial drop"), Inventory->GetItemCount(Bandage), 9);
+
+	TestTrue(TEXT("Drop a bandage stack"), Inventory->DropItem(FindSlot(Inventory, Bandage), INDEX_NONE));
+	TestTrue(TEXT("Totals after dropping a stack"), Inventory->VerifyTotals());
+	TestEqual(TEXT("Stacks after dropping a stack"), Inventory->Items.Num(), 1);
+
+	// Reload: part of the ammo stack, then what is left of it
+	TestTrue(TEXT("Add ammo"), Inventory->AddItem(Ammo, 40, EItemType::IT_Item, UBaseAmmoItem::StaticClass()));
+	TestTrue(TEXT("Add rifle"), Inventory->AddItem(Rifle, 1, EItemType::IT_Weapon, UBaseWeaponItem::StaticClass()));
+	TestTrue(TEXT("Totals after adding the rifle"), Inventory->VerifyTotals());
+
+	FItemSlotInfo *RifleSlot = Inventory->GetItemInSlot(FindSlot(Inventory, Rifle));
+	UBaseWeaponItem *Weapon = RifleSlot ? Cast<UBaseWeaponItem>(RifleSlot->ItemTypeReference) : nullptr;
+	if (Weapon == nullptr)
+	{
+		AddError(TEXT("Rifle was not added"));
+		return false;
+	}
+	Weapon->MaxClipSize = 30;
+	Weapon->ClipSize = 0;
+	Inventory->EquippedWeapon = Weapon;
+
+	TestTrue(TEXT("Reload from a full stack"), Inventory->ReloadEquippedWeapon());
+	TestTrue(TEXT("Totals after reload"), Inventory->VerifyTotals());
+	TestEqual(TEXT("Ammo after reload"), Inventory->GetItemCount(Ammo), 10);
+
+	Weapon->ClipSize = 0;
+	TestTrue(TEXT("Reload the rest of the stack"), Inventory->ReloadEquippedWeapon());
+	TestTrue(TEXT("Totals after emptying the ammo"), Inventory->VerifyTotals());
+	TestEqual(TEXT("Ammo after emptying the stack"), Inventory->GetItemCount(Ammo), 0);
+	Inventory->EquippedWeapon = nullptr;
+
+	// Craft bandages and ammo into splints
+	UInventorySystemManager *InventorySystemManager = NewObject<UInventorySystemManager>(GetTransientPackage());
+	UItemCraftRecipe *Recipe = NewObject<UItemCraftRecipe>(InventorySystemManager);
+	Recipe->ItemAID = Bandage;
+	Recipe->ItemBID = Ammo;
+	Recipe->YieldItemID = Splint;
+	Recipe->YieldStackSize = 2;
+	Recipe->YieldTypeClass = UBaseHealingItem::StaticClass();
+	Recipe->YieldItemType = EItemType::IT_Item;
+	InventorySystemManager->CraftRecipes.Add(Recipe);
+
+	TestTrue(TEXT("Add ammo to craft with"), Inventory->AddItem(Ammo, 5, EItemType::IT_Item, UBaseAmmoItem::StaticClass()));
+	TestTrue(TEXT("Craft splints"), Inventory->CraftItem(FindSlot(Inventory, Bandage), FindSlot(Inventory, Ammo), InventorySystemManager));
+	TestTrue(TEXT("Totals after craft"), Inventory->VerifyTotals());
+	TestEqual(TEXT("Bandages after craft"), Inventory->GetItemCount(Bandage), 0);
+	TestEqual(TEXT("Ammo after craft"), Inventory->GetItemCount(Ammo), 0);
+	TestEqual(TEXT("Splints after craft"), Inventory->GetItemCount(Splint), 2);
+
+	// Batch operations: two partial stacks merged into one full stack and a remainder, then sorted
+	TestTrue(TEXT("Add bandages to consolidate"), Inventory->AddItem(Bandage, 8, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	TestTrue(TEXT("Add a second bandage stack"), Inventory->AddItem(Bandage, 8, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	TestTrue(TEXT("Split the bandages"), Inventory->DropItem(FindSlot(Inventory, Bandage), 5));
+	TestTrue(TEXT("Totals before consolidating"), Inventory->VerifyTotals());
+
+	Inventory->ConsolidateStacks();
+	TestTrue(TEXT("Totals after consolidating"), Inventory->VerifyTotals());
+	TestEqual(TEXT("Bandages after consolidating"), Inventory->GetItemCount(Bandage), 11);
+
+	Inventory->SortInventory(EInventorySortKey::ISK_ItemID);
+	TestTrue(TEXT("Totals after sorting"), Inventory->VerifyTotals());
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "AutomationTest.h"
+#include "SurvivalTestWorld.h"
+#include "Inventory/InventoryComponent.h"
+#include "Inventory/Items/BaseHealingItem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace InventoryWatchTest
+{
+	const FName Apple(TEXT("Test.Apple"));
+	const FName Bandage(TEXT("Test.Bandage"));
+
+	struct FNotification
+	{
+		int32 Handle;
+		int32 Carried;
+		bool bSatisfied;
+	};
+
+	// Watch notifications received, per handle
+	struct FNotificationLog
+	{
+		TArray<FNotification> Notifications;
+
+		FInventoryWatchDelegate MakeCallback()
+		{
+			return FInventoryWatchDelegate::CreateLambda([this](int32 Handle, FName ItemID, int32 Carried, bool bSatisfied)
+			{
+				FNotification Notification;
+				Notification.Handle = Handle;
+				Notification.Carried = Carried;
+				Notification.bSatisfied = bSatisfied;
+				Notifications.Add(Notification);
+			});
+		}
+
+		int32 Count(int32 Handle) const
+		{
+			int32 Num = 0;
+			for (const FNotification &Notification : Notifications)
+			{
+				Num += Notification.Handle == Handle ? 1 : 0;
+			}
+			return Num;
+		}
+
+		const FNotification *Last(int32 Handle) const
+		{
+			for (int32 i = Notifications.Num() - 1; i >= 0; i--)
+			{
+				if (Notifications[i].Handle == Handle)
+				{
+					return &Notifications[i];
+				}
+			}
+			return nullptr;
+		}
+	};
+
+	// Ends the frame: the inventory delivers the batched watch notifications on tick
+	void EndFrame(UInventoryComponent *Inventory)
+	{
+		Inventory->TickComponent(0.0f, LEVELTICK_All, nullptr);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryWatchTest, "Survival.Inventory.Watches", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Changes watched items several times per frame and checks each watch is told at most
+// once per frame, with the count at the end of the frame
+bool FInventoryWatchTest::RunTest(const FString &Parameters)
+{
+	using namespace InventoryWatchTest;
+
+	const FScopedItemDefaults HealingDefaults(UBaseHealingItem::StaticClass(), 10, 0.25f);
+
+	FSurvivalTestWorld TestWorld;
+	ASurvivalCharacter *Character = TestWorld.SpawnCharacter();
+	if (Character == nullptr || Character->InventoryComponent == nullptr)
+	{
+		AddError(TEXT("Failed to spawn a character with an inventory"));
+		return false;
+	}
+	UInventoryComponent *Inventory = Character->InventoryComponent;
+
+	FNotificationLog Log;
+	const int32 Objective = Inventory->AddWatch(Apple, EInventoryWatchCondition::IWC_AtLeast, 5, Log.MakeCallback());
+	const int32 Progress = Inventory->AddWatch(Apple, EInventoryWatchCondition::IWC_AtLeast, 5, Log.MakeCallback(), true);
+
+	// The first notification reports the current state, at the end of the frame
+	TestEqual(TEXT("Notifications before the first frame ends"), Log.Notifications.Num(), 0);
+	EndFrame(Inventory);
+	TestEqual(TEXT("Initial objective notifications"), Log.Count(Objective), 1);
+	TestEqual(TEXT("Initial progress notifications"), Log.Count(Progress), 1);
+	TestFalse(TEXT("Objective not met at first"), Inventory->IsWatchSatisfied(Objective));
+
+	// Several changes in one frame make one notification with the final count
+	TestTrue(TEXT("Add apples"), Inventory->AddItem(Apple, 2, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	TestTrue(TEXT("Add more apples"), Inventory->AddItem(Apple, 2, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	TestTrue(TEXT("Add even more apples"), Inventory->AddItem(Apple, 2, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	TestTrue(TEXT("Eat an apple"), Inventory->DropItem(0, 1));
+	TestEqual(TEXT("Notifications within the frame"), Log.Notifications.Num(), 2);
+	EndFrame(Inventory);
+
+	TestEqual(TEXT("Objective notifications after a busy frame"), Log.Count(Objective), 2);
+	TestEqual(TEXT("Progress notifications after a busy frame"), Log.Count(Progress), 2);
+	const FNotification *ObjectiveMet = Log.Last(Objective);
+	if (ObjectiveMet != nullptr)
+	{
+		TestEqual(TEXT("Count when the objective is met"), ObjectiveMet->Carried, 5);
+		TestTrue(TEXT("Objective met"), ObjectiveMet->bSatisfied);
+	}
+	TestTrue(TEXT("Objective is satisfied"), Inventory->IsWatchSatisfied(Objective));
+
+	// Changes that cancel out within a frame are no news to anyone
+	TestTrue(TEXT("Add apples for a moment"), Inventory->AddItem(Apple, 3, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	TestTrue(TEXT("Drop them again"), Inventory->DropItem(0, 3));
+	EndFrame(Inventory);
+	TestEqual(TEXT("Objective notifications after changes that cancel out"), Log.Count(Objective), 2);
+	TestEqual(TEXT("Progress notifications after changes that cancel out"), Log.Count(Progress), 2);
+
+	// Only progress watches hear about changes that keep the condition
+	TestTrue(TEXT("Add an apple"), Inventory->AddItem(Apple, 1, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	EndFrame(Inventory);
+	TestEqual(TEXT("Objective notifications after progress"), Log.Count(Objective), 2);
+	TestEqual(TEXT("Progress notifications after progress"), Log.Count(Progress), 3);
+	const FNotification *Progressed = Log.Last(Progress);
+	TestTrue(TEXT("Progress count"), Progressed != nullptr && Progressed->Carried == 6);
+
+	// Other items and quiet frames notify nobody
+	TestTrue(TEXT("Add a bandage"), Inventory->AddItem(Bandage, 1, EItemType::IT_Item, UBaseHealingItem::StaticClass()));
+	EndFrame(Inventory);
+	EndFrame(Inventory);
+	TestEqual(TEXT("Notifications after unwatched changes"), Log.Notifications.Num(), 5);
+
+	// Removed watches are not told, even about changes made before they were removed
+	TestTrue(TEXT("Drop the apples"), Inventory->DropItem(0, INDEX_NONE));
+	Inventory->RemoveWatch(Objective);
+	EndFrame(Inventory);
+	TestEqual(TEXT("Notifications to a removed watch"), Log.Count(Objective), 2);
+	TestEqual(TEXT("Progress notifications after dropping the apples"), Log.Count(Progress), 4);
+	const FNotification *Dropped = Log.Last(Progress);
+	TestTrue(TEXT("Progress after dropping the apples"), Dropped != nullptr && Dropped->Carried == 0 && !Dropped->bSatisfied);
+
+	Inventory->RemoveWatch(Progress);
+	return true;
+}
+
+#endif
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "SurvivalCharacter.h"
+#include "Inventory/BaseItem.h"
+
+/**
+* A game world for automation tests. It runs the project's game mode and game state,
+* so the world systems exist, and has begun play. Destroyed together with this object.
+*/
+class FSurvivalTestWorld
+{
+public:
+	FSurvivalTestWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext &WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		const FURL URL;
+		World->SetGameMode(URL);
+		World->InitializeActorsForPlay(URL);
+		World->BeginPlay();
+	}
+
+	~FSurvivalTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	// Spawns a character that has begun play, with no controller
+	ASurvivalCharacter *SpawnCharacter() const
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		return World->SpawnActor<ASurvivalCharacter>(ASurvivalCharacter::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	UWorld *World;
+};
+
+/**
+* Sets the stack size and weight on the class defaults of an item for the length of a test.
+* Items take these from their class, and the native item classes neither stack nor weigh anything.
+*/
+class FScopedItemDefaults
+{
+public:
+	FScopedItemDefaults(TSubclassOf<UBaseItem> ItemClass, int32 MaxStackSize, float Weight)
+		: Defaults(ItemClass->GetDefaultObject<UBaseItem>())
+		, SavedMaxStackSize(Defaults->MaxStackSize)
+		, SavedWeight(Defaults->Weight)
+	{
+		Defaults->MaxStackSize = MaxStackSize;
+		Defaults->Weight = Weight;
+	}
+
+	~FScopedItemDefaults()
+	{
+		Defaults->MaxStackSize = SavedMaxStackSize;
+		Defaults->Weight = SavedWeight;
+	}
+
+private:
+	UBaseItem *Defaults;
+	int32 SavedMaxStackSize;
+	float SavedWeight;
+};
+
+/**
+* Sets the inventory grid footprint on the class defaults of an item for the length of a test.
+*/
+class FScopedItemFootprint
+{
+public:
+	FScopedItemFootprint(TSubclassOf<UBaseItem> ItemClass, int32 GridWidth, int32 GridHeight)
+		: Defaults(ItemClass->GetDefaultObject<UBaseItem>())
+		, SavedGridWidth(Defaults->GridWidth)
+		, SavedGridHeight(Defaults->GridHeight)
+	{
+		Defaults->GridWidth = GridWidth;
+		Defaults->GridHeight = GridHeight;
+	}
+
+	~FScopedItemFootprint()
+	{
+		Defaults->GridWidth = SavedGridWidth;
+		Defaults->GridHeight = SavedGridHeight;
+	}
+
+private:
+	UBaseItem *Defaults;
+	int32 SavedGridWidth;
+	int32 SavedGridHeight;
+};
+
+#endif
@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Survival.h"
+#include "SceneQueryBatcher.h"
+#include "SurvivalGameStateBase.h"
+#include "UtilityFunctionsLibrary.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Scene Query Batch"), STAT_SceneQueryBatch, STATGROUP_Survival);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scene Queries"), STAT_SceneQueries, STATGROUP_Survival);
+
+
+USceneQueryBatcher::USceneQueryBatcher()
+{
+	MinParallelBatchSize = 16;
+
+	PendingFirstID = 1;
+	LastFirstID = 0;
+	NextID = 1;
+}
+
+USceneQueryBatcher *USceneQueryBatcher::Get(const UObject *WorldContextObject)
+{
+	UWorld *World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	ASurvivalGameStateBase *GameState = World ? World->GetGameState<ASurvivalGameStateBase>() : nullptr;
+	return GameState ? GameState->SceneQueryBatcher : nullptr;
+}
+
+FSceneQueryHandle USceneQueryBatcher::RequestLineTrace(const FSceneQueryRequest &Request, const FSceneQueryDelegate &Callback)
+{
+	if (PendingRequests.Num() == 0)
+	{
+		PendingFirstID = NextID;
+	}
+
+	// Zero is the invalid handle
+	const uint32 ID = NextID++;
+	if (NextID == 0)
+	{
+		NextID = 1;
+	}
+
+	PendingRequests.Add(Request);
+	PendingCallbacks.Add(Callback);
+
+	return FSceneQueryHandle(ID);
+}
+
+bool USceneQueryBatcher::GetResult(FSceneQueryHandle Handle, FHitResult &OutHit) const
+{
+	if (!Handle.IsValid())
+	{
+		return false;
+	}
+
+	const int32 Index = (int32)(Handle.ID - LastFirstID);
+	if (!LastResults.IsValidIndex(Index))
+	{
+		return false;
+	}
+
+	OutHit = LastResults[Index];
+	return true;
+}
+
+void USceneQueryBatcher::ExecuteBatch(const TArray<FSceneQueryRequest> &Requests, TArray<FHitResult> &OutHits)
+{
+	UWorld *World = GetWorld();
+
+	OutHits.Reset(Requests.Num());
+	OutHits.AddDefaulted(Requests.Num());
+	if (World == nullptr || Requests.Num() == 0)
+	{
+		return;
+	}
+
+	// Resolve everything that touches UObjects on the game thread
+	const bool bDrawDebug = UUtilityFunctionsLibrary::ShouldDrawDebugTraces();
+	TArray<FCollisionQueryParams> Params;
+	Params.Reserve(Requests.Num());
+	for (const FSceneQueryRequest &Request : Requests)
+	{
+		FCollisionQueryParams TraceParams(bDrawDebug ? UUtilityFunctionsLibrary::TraceTag : NAME_None, Request.bTraceComplex, Request.IgnoredActor.Get());
+		TraceParams.bReturnPhysicalMaterial = Request.bReturnPhysicalMaterial;
+		Params.Add(TraceParams);
+	}
+
+	if (bDrawDebug && World->DebugDrawTraceTag != UUtilityFunctionsLibrary::TraceTag)
+	{
+		World->DebugDrawTraceTag = UUtilityFunctionsLibrary::TraceTag;
+	}
+
+	// Scene queries only read the physics scene, so they can run side by side.
+	// Traces drawn for debugging add to the world's line batchers, which is only safe on the game thread.
+	ParallelFor(Requests.Num(), [&](int32 Index)
+	{
+		const FSceneQueryRequest &Request = Requests[Index];
+		World->LineTraceSingleByChannel(OutHits[Index], Request.Start, Request.End, Request.Channel, Params[Index]);
+	}, bDrawDebug || Requests.Num() < MinParallelBatchSize);
+}
+
+void USceneQueryBatcher::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SceneQueryBatch);
+
+	LastFrameStats = FSceneQueryFrameStats();
+	if (PendingRequests.Num() == 0)
+	{
+		LastResults.Reset();
+		return;
+	}
+
+	const uint32 StartCycles = FPlatformTime::Cycles();
+
+	// Take the batch, so callbacks can queue requests for the next frame
+	TArray<FSceneQueryRequest> Requests = MoveTemp(PendingRequests);
+	TArray<FSceneQueryDelegate> Callbacks = MoveTemp(PendingCallbacks);
+	PendingRequests.Reset();
+	PendingCallbacks.Reset();
+
+	ExecuteBatch(Requests, LastResults);
+	LastFirstID = PendingFirstID;
+
+	for (int32 i = 0; i < Callbacks.Num(); i++)
+	{
+		if (LastResults[i].bBlockingHit)
+		{
+			LastFrameStats.Hits++;
+		}
+		Callbacks[i].ExecuteIfBound(FSceneQueryHandle(LastFirstID + i), LastResults[i]);
+	}
+
+	LastFrameStats.Queries = Requests.Num();
+	LastFrameStats.Microseconds = FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - StartCycles) * 1000.0f;
+	INC_DWORD_STAT_BY(STAT_SceneQueries, Requests.Num());
+}
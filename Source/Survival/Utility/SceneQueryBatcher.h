@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SurvivalSystemBase.h"
+#include "SceneQueryBatcher.generated.h"
+
+/**
+* A single line trace request for the scene query batcher.
+* Defaults to simple collision; complex collision is opt-in per request.
+*/
+struct FSceneQueryRequest
+{
+	FVector Start;
+	FVector End;
+	ECollisionChannel Channel;
+
+	// Actor to ignore, usually the one asking
+	TWeakObjectPtr<AActor> IgnoredActor;
+
+	bool bTraceComplex;
+	bool bReturnPhysicalMaterial;
+
+	FSceneQueryRequest()
+		: Start(FVector::ZeroVector)
+		, End(FVector::ZeroVector)
+		, Channel(ECollisionChannel::ECC_Visibility)
+		, bTraceComplex(false)
+		, bReturnPhysicalMaterial(false)
+	{}
+
+	FSceneQueryRequest(const FVector &InStart, const FVector &InEnd, ECollisionChannel InChannel, AActor *InIgnoredActor = nullptr)
+		: Start(InStart)
+		, End(InEnd)
+		, Channel(InChannel)
+		, IgnoredActor(InIgnoredActor)
+		, bTraceComplex(false)
+		, bReturnPhysicalMaterial(false)
+	{}
+};
+
+/**
+* Handle to a queued request. Results can be read back through the handle until the next flush.
+*/
+struct FSceneQueryHandle
+{
+	uint32 ID;
+
+	FSceneQueryHandle()
+		: ID(0)
+	{}
+
+	explicit FSceneQueryHandle(uint32 InID)
+		: ID(InID)
+	{}
+
+	FORCEINLINE bool IsValid() const
+	{
+		return ID != 0;
+	}
+};
+
+DECLARE_DELEGATE_TwoParams(FSceneQueryDelegate, FSceneQueryHandle, const FHitResult&);
+
+/**
+* Per-frame counters of the scene query batcher
+*/
+USTRUCT(BlueprintType)
+struct FSceneQueryFrameStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Scene Queries")
+	int32 Queries;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Scene Queries")
+	int32 Hits;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Scene Queries")
+	float Microseconds;
+
+	FSceneQueryFrameStats()
+	{
+		Queries = 0;
+		Hits = 0;
+		Microseconds = 0.0f;
+	}
+};
+
+/**
+* Collects line trace requests from any number of actors during the frame and runs them
+* together once per frame, spread over worker threads when the batch is big enough.
+* Results are handed back through callbacks on the game thread, or can be read back
+* through the request handle until the next flush.
+*
+* Owned by the game state, so it exists on both server and clients.
+* @see USceneQueryBatcher::Get
+*/
+UCLASS(Config = Game)
+class SURVIVAL_API USceneQueryBatcher : public USurvivalSystemBase
+{
+	GENERATED_BODY()
+
+public:
+	USceneQueryBatcher();
+
+	// Batches smaller than this, and all batches while debug traces are drawn, are traced on the game thread
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Scene Queries")
+	int32 MinParallelBatchSize;
+
+	// Utility to get the batcher of the world WorldContextObject lives in. May return nullptr.
+	static USceneQueryBatcher *Get(const UObject *WorldContextObject);
+
+	// Queue a line trace for this frame's batch. Callback (optional) is called on the game thread when done.
+	FSceneQueryHandle RequestLineTrace(const FSceneQueryRequest &Request, const FSceneQueryDelegate &Callback = FSceneQueryDelegate());
+
+	// Get the result of a request from the last flushed batch. Returns false if the handle is unknown/stale.
+	bool GetResult(FSceneQueryHandle Handle, FHitResult &OutHit) const;
+
+	// Runs a batch of requests right away. OutHits gets one result per request.
+	void ExecuteBatch(const TArray<FSceneQueryRequest> &Requests, TArray<FHitResult> &OutHits);
+
+	// Number of requests waiting for the next flush
+	FORCEINLINE int32 GetNumPending() const
+	{
+		return PendingRequests.Num();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "Scene Queries")
+	FSceneQueryFrameStats GetLastFrameStats() const
+	{
+		return LastFrameStats;
+	}
+
+	//////////////////////////////////////////////////////////
+	// FTickableGameObject
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	TArray<FSceneQueryRequest> PendingRequests;
+	TArray<FSceneQueryDelegate> PendingCallbacks;
+
+	// Handle ID of the first pending request. Handles within a batch are consecutive.
+	uint32 PendingFirstID;
+
+	// Results of the last flushed batch, and the handle ID of its first request
+	TArray<FHitResult> LastResults;
+	uint32 LastFirstID;
+
+	uint32 NextID;
+
+	FSceneQueryFrameStats LastFrameStats;
+};
@@ -3,6 +3,15 @@
 #include "Survival.h"
 #include "UtilityFunctionsLibrary.h"
 
+static TAutoConsoleVariable<int32> CVarDrawDebugTraces(
+	TEXT("Survival.DrawDebugTraces"),
+	0,
+	TEXT("Draw gameplay traces (interaction, TraceLine).\n")
+	TEXT("0: Off (default), 1: On"));
 
+const FName UUtilityFunctionsLibrary::TraceTag(TEXT("SurvivalTraceTag"));
 
-
+bool UUtilityFunctionsLibrary::ShouldDrawDebugTraces()
+{
+	return CVarDrawDebugTraces.GetValueOnGameThread() != 0;
+}
@@ -16,9 +16,16 @@ class SURVIVAL_API UUtilityFunctionsLibrary : public UObject
 	
 public:
 
+	// Trace tag used for debug drawing of our traces
+	static const FName TraceTag;
+
+	// Utility to check if debug drawing of traces is toggled on at runtime (Survival.DrawDebugTraces)
+	static bool ShouldDrawDebugTraces();
+
 	/** 
 	* Does a single line trace with one possible ignore actor.
-	* Wrapper function to utilize the standard line trace by channel
+	* Wrapper function to utilize the standard line trace by channel.
+	* Debug lines are drawn if DrawDebugLines is set or Survival.DrawDebugTraces is on.
 	*/
 	static FORCEINLINE bool TraceLine(UWorld *World,
 		AActor *ActorToIgnore,
@@ -37,10 +44,12 @@ public:
 
 		FCollisionQueryParams TraceParams;
 
-		const FName TraceTag("SurvivalTraceTag");
-		if (DrawDebugLines)
+		if (DrawDebugLines || ShouldDrawDebugTraces())
 		{
-			World->DebugDrawTraceTag = TraceTag;
+			if (World->DebugDrawTraceTag != TraceTag)
+			{
+				World->DebugDrawTraceTag = TraceTag;
+			}
 			TraceParams.TraceTag = TraceTag;
 		}
 